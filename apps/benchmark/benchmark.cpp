@@ -0,0 +1,454 @@
+// Copyright (C) 2018, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+/// \file   benchmark.cpp
+/// \author Dominik Wodniok
+/// \date   2018
+
+// C libs
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// std libs
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+// main include
+#include "benchmark.h"
+
+// time series builder
+#include "timeseriesdualmc.h"
+
+// vector kernel dispatch
+#include "cpudispatch.h"
+
+using std::chrono::high_resolution_clock;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::run(int const argc, char** argv) {
+    // parse program options
+    AppOptions options;
+    if(!parseArgs(argc,argv,options)) {
+        return;
+    }
+
+    // load raw file or generate gyroid volume
+    if(!options.inputFile.empty()) {
+        if(!loadRawFile(options.inputFile, options.dimX, options.dimY, options.dimZ)) {
+            return;
+        }
+    } else {
+        generateGyroid(options.gyroidDim);
+    }
+
+    std::cout << "Vector kernels: " << dualmc::cpuPathName(dualmc::cpuPath()) << std::endl;
+
+    if(options.frames > 0) {
+        benchmarkTimeSeries(options);
+        return;
+    }
+
+    std::vector<Result> results;
+    for(int layout = 0; layout < NUM_LAYOUTS; ++layout) {
+        std::cout << "Benchmarking " << layoutName(Layout(layout)) << " layout" << std::endl;
+        results.push_back(benchmarkLayout(Layout(layout), options));
+    }
+
+    printResults(results);
+}
+
+//------------------------------------------------------------------------------
+
+bool DualMCBenchmark::parseArgs(int const argc, char** argv, AppOptions & options) {
+    // set default values
+    options.inputFile.assign("");
+    options.dimX = -1;
+    options.dimY = -1;
+    options.dimZ = -1;
+    options.gyroidDim = 256;
+    options.isoValue = 0.5f;
+    options.brickSize = 16;
+    options.repetitions = 3;
+    options.frames = 0;
+    options.generateQuadSoup = false;
+    options.generateManifold = false;
+
+    // parse arguments
+    for(int currentArg = 1; currentArg < argc; ++currentArg) {
+        if(strcmp(argv[currentArg],"-soup") == 0) {
+            options.generateQuadSoup = true;
+        } else if(strcmp(argv[currentArg],"-manifold") == 0) {
+            options.generateManifold = true;
+        } else if(strcmp(argv[currentArg],"-iso") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Iso value missing" << std::endl;
+                return false;
+            }
+            // Read the iso value and clamp it to [0,1].
+            // Invalid values are set to 0.
+            options.isoValue = atof(argv[currentArg+1]);
+            if(options.isoValue > 1.0f)
+                options.isoValue = 1.0f;
+            else if(options.isoValue < 0.0f || options.isoValue != options.isoValue)
+                options.isoValue = 0.0f;
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-gyroid") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Gyroid dimension missing" << std::endl;
+                return false;
+            }
+            options.gyroidDim = atoi(argv[currentArg+1]);
+            if(options.gyroidDim < 3) {
+                std::cerr << "Gyroid dimension has to be at least 3" << std::endl;
+                return false;
+            }
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-brick") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Brick size missing" << std::endl;
+                return false;
+            }
+            options.brickSize = atoi(argv[currentArg+1]);
+            if(options.brickSize < 1) {
+                std::cerr << "Brick size has to be positive" << std::endl;
+                return false;
+            }
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-repeat") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Repetition count missing" << std::endl;
+                return false;
+            }
+            options.repetitions = atoi(argv[currentArg+1]);
+            if(options.repetitions < 1) {
+                options.repetitions = 1;
+            }
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-frames") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Frame count missing" << std::endl;
+                return false;
+            }
+            options.frames = atoi(argv[currentArg+1]);
+            if(options.frames < 1) {
+                std::cerr << "Frame count has to be positive" << std::endl;
+                return false;
+            }
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-raw") == 0) {
+            if(currentArg+4 >= argc) {
+                std::cerr << "Not enough arguments for raw file" << std::endl;
+                return false;
+            }
+            options.inputFile.assign(argv[currentArg+1]);
+            options.dimX = atoi(argv[currentArg+2]);
+            options.dimY = atoi(argv[currentArg+3]);
+            options.dimZ = atoi(argv[currentArg+4]);
+            currentArg += 4;
+        } else if(strcmp(argv[currentArg],"-help") == 0) {
+            printArgs();
+            return false;
+        } else {
+            std::cerr << "Unknown argument: " << argv[currentArg] << std::endl;
+            printHelpHint();
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::printArgs() const {
+    std::cout << "Usage: dmcbench ARGS" << std::endl;
+    std::cout << " -help              print this help" << std::endl;
+    std::cout << " -raw FILE X Y Z    specify raw file with dimensions" << std::endl;
+    std::cout << " -gyroid N          generate N^3 gyroid volume. DEFAULT: 256" << std::endl;
+    std::cout << " -manifold          use Manifold Dual Marching Cubes algorithm (Rephael Wenger)" << std::endl;
+    std::cout << " -iso X             specify iso value X in [0,1]. DEFAULT: 0.5" << std::endl;
+    std::cout << " -soup              generate a quad soup (no vertex sharing)" << std::endl;
+    std::cout << " -brick N           edge length of bricks in voxels. DEFAULT: 16" << std::endl;
+    std::cout << " -repeat N          number of extractions per layout. DEFAULT: 3" << std::endl;
+    std::cout << " -frames N          extract N frames with a moving blob as a time series" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::printHelpHint() const {
+    std::cout << "Try: dmcbench -help" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::generateGyroid(int32_t const dim) {
+    std::cout << "Generating gyroid volume" << std::endl;
+
+    volume.dimX = dim;
+    volume.dimY = dim;
+    volume.dimZ = dim;
+    volume.data.resize(size_t(dim) * dim * dim);
+
+    // one gyroid period per 32 voxels gives a dense, evenly spread surface
+    float const frequency = 2.0f * float(M_PI) / 32.0f;
+
+    uint8_t * p = &volume.data.front();
+    for(int32_t z = 0; z < dim; ++z) {
+        float const sz = std::sin(z * frequency);
+        float const cz = std::cos(z * frequency);
+        for(int32_t y = 0; y < dim; ++y) {
+            float const sy = std::sin(y * frequency);
+            float const cy = std::cos(y * frequency);
+            for(int32_t x = 0; x < dim; ++x) {
+                float const sx = std::sin(x * frequency);
+                float const cx = std::cos(x * frequency);
+                // gyroid values are in [-1.5,1.5]
+                float const value = sx * cy + sy * cz + sz * cx;
+                *p++ = uint8_t((value / 3.0f + 0.5f) * std::numeric_limits<uint8_t>::max());
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool DualMCBenchmark::loadRawFile(std::string const & fileName, int32_t dimX, int32_t dimY, int32_t dimZ) {
+    std::cout << "Loading raw file " << fileName << std::endl;
+
+    std::ifstream file(fileName, std::ios::binary);
+    if(!file) {
+        std::cerr << "Could not open " << fileName << std::endl;
+        return false;
+    }
+
+    volume.dimX = dimX;
+    volume.dimY = dimY;
+    volume.dimZ = dimZ;
+    volume.data.resize(size_t(dimX) * dimY * dimZ);
+    file.read(reinterpret_cast<char*>(&volume.data.front()), volume.data.size());
+    if(file.gcount() != std::streamsize(volume.data.size())) {
+        std::cerr << "Raw file is smaller than the given dimensions" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+DualMCBenchmark::Result DualMCBenchmark::benchmarkLayout(Layout const layout, AppOptions const & options) {
+    uint8_t const iso = options.isoValue * std::numeric_limits<uint8_t>::max();
+    dualmc::DualMC builder;
+
+    Result result;
+    result.conversionTime = 0.0;
+    result.memorySize = volume.data.size();
+
+    switch(layout) {
+    case LAYOUT_LINEAR:
+        measureExtraction([&]() {
+            builder.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ,
+                iso, options.generateManifold, options.generateQuadSoup, vertices, quads);
+        }, options, result);
+        break;
+    case LAYOUT_BRICKED: {
+        dualmc::BrickedVolume bricked;
+        high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+        bricked.fromLinear(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ, options.brickSize);
+        result.conversionTime = duration_cast<duration<double>>(high_resolution_clock::now() - startTime).count();
+        result.memorySize = bricked.memorySize();
+
+        measureExtraction([&]() {
+            builder.build(bricked, iso, options.generateManifold, options.generateQuadSoup, vertices, quads);
+        }, options, result);
+        break;
+    }
+    case LAYOUT_MORTON: {
+        dualmc::MortonVolume morton;
+        high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+        morton.fromLinear(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ);
+        result.conversionTime = duration_cast<duration<double>>(high_resolution_clock::now() - startTime).count();
+        result.memorySize = morton.memorySize();
+
+        measureExtraction([&]() {
+            builder.build(morton, iso, options.generateManifold, options.generateQuadSoup, vertices, quads);
+        }, options, result);
+        break;
+    }
+    default:
+        break;
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+template<class Build>
+void DualMCBenchmark::measureExtraction(Build const & build, AppOptions const & options, Result & result) {
+    result.extractionTime = std::numeric_limits<double>::max();
+    for(int32_t i = 0; i < options.repetitions; ++i) {
+        counters.start();
+        high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+        build();
+        high_resolution_clock::time_point const endTime = high_resolution_clock::now();
+        counters.stop();
+
+        double const extractionTime = duration_cast<duration<double>>(endTime - startTime).count();
+        if(extractionTime < result.extractionTime) {
+            result.extractionTime = extractionTime;
+            for(int e = 0; e < PerfCounters::NUM_EVENTS; ++e) {
+                result.counts[e] = counters.count(PerfCounters::Event(e));
+            }
+        }
+    }
+    result.numVertices = vertices.size();
+    result.numQuads = quads.size();
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::benchmarkTimeSeries(AppOptions const & options) {
+    uint8_t const iso = options.isoValue * std::numeric_limits<uint8_t>::max();
+    dualmc::DualMC builder;
+    dualmc::TimeSeriesDualMC series(options.brickSize);
+    std::vector<dualmc::Vertex> seriesVertices;
+    std::vector<dualmc::Quad> seriesQuads;
+    std::vector<uint8_t> frameData;
+
+    std::cout << "Benchmarking " << options.frames << " frames" << std::endl;
+    double buildTime = 0.0;
+    double seriesTime = 0.0;
+    int64_t meshedBricks = 0;
+    int64_t reusedBricks = 0;
+    int64_t emptyBricks = 0;
+    for(int32_t frame = 0; frame < options.frames; ++frame) {
+        generateFrame(frame, options.frames, frameData);
+
+        // independent extraction of each frame
+        high_resolution_clock::time_point startTime = high_resolution_clock::now();
+        builder.build(&frameData.front(), volume.dimX, volume.dimY, volume.dimZ,
+            iso, options.generateManifold, false, vertices, quads);
+        buildTime += duration_cast<duration<double>>(high_resolution_clock::now() - startTime).count();
+
+        // extraction reusing the bricks of the previous frame
+        startTime = high_resolution_clock::now();
+        series.extractFrame(&frameData.front(), volume.dimX, volume.dimY, volume.dimZ,
+            iso, options.generateManifold, seriesVertices, seriesQuads);
+        seriesTime += duration_cast<duration<double>>(high_resolution_clock::now() - startTime).count();
+
+        meshedBricks += series.meshedBricks();
+        reusedBricks += series.reusedBricks();
+        emptyBricks += series.emptyBricks();
+
+        if(seriesQuads.size() != quads.size() || seriesVertices.size() != vertices.size()) {
+            std::cerr << "Warning: time series mesh of frame " << frame
+                      << " differs from the independent build" << std::endl;
+        }
+    }
+
+    std::cout << std::endl << std::fixed << std::setprecision(2);
+    std::cout << "independent builds: " << options.frames / buildTime << " frames/s" << std::endl;
+    std::cout << "time series:        " << options.frames / seriesTime << " frames/s" << std::endl;
+    std::cout << "bricks per frame:   "
+              << double(meshedBricks) / options.frames << " meshed, "
+              << double(reusedBricks) / options.frames << " reused, "
+              << double(emptyBricks) / options.frames << " empty" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::generateFrame(int32_t const frame, int32_t const numFrames, std::vector<uint8_t> & data) const {
+    data = volume.data;
+
+    // a blob of a quarter of the volume extent moves along the diagonal
+    float const t = numFrames > 1 ? float(frame) / float(numFrames - 1) : 0.5f;
+    float const radius = 0.125f * std::min(volume.dimX, std::min(volume.dimY, volume.dimZ));
+    float const center[3] = {
+        radius + t * (volume.dimX - 2.0f * radius),
+        radius + t * (volume.dimY - 2.0f * radius),
+        radius + t * (volume.dimZ - 2.0f * radius)
+    };
+    int32_t const begin[3] = {
+        std::max(int32_t(center[0] - radius), 0),
+        std::max(int32_t(center[1] - radius), 0),
+        std::max(int32_t(center[2] - radius), 0)
+    };
+    int32_t const end[3] = {
+        std::min(int32_t(center[0] + radius) + 1, volume.dimX),
+        std::min(int32_t(center[1] + radius) + 1, volume.dimY),
+        std::min(int32_t(center[2] + radius) + 1, volume.dimZ)
+    };
+    for(int32_t z = begin[2]; z < end[2]; ++z) {
+        for(int32_t y = begin[1]; y < end[1]; ++y) {
+            for(int32_t x = begin[0]; x < end[0]; ++x) {
+                float const dx = (x - center[0]) / radius;
+                float const dy = (y - center[1]) / radius;
+                float const dz = (z - center[2]) / radius;
+                float const falloff = 1.0f - (dx * dx + dy * dy + dz * dz);
+                if(falloff > 0.0f) {
+                    uint8_t & value = data[(size_t(z) * volume.dimY + y) * volume.dimX + x];
+                    value = uint8_t(std::min(value + falloff * std::numeric_limits<uint8_t>::max(), 255.0f));
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::printResults(std::vector<Result> const & results) const {
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(10) << "layout"
+              << std::right << std::setw(12) << "memory MB"
+              << std::setw(12) << "convert s"
+              << std::setw(12) << "extract s"
+              << std::setw(12) << "quads";
+    for(int e = 0; e < PerfCounters::NUM_EVENTS; ++e) {
+        std::cout << std::setw(18) << (std::string(PerfCounters::eventName(PerfCounters::Event(e))) + "/quad");
+    }
+    std::cout << std::endl;
+
+    for(size_t i = 0; i < results.size(); ++i) {
+        Result const & result = results[i];
+        double const numQuads = result.numQuads > 0 ? double(result.numQuads) : 1.0;
+        std::cout << std::left << std::setw(10) << layoutName(Layout(i))
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << result.memorySize / (1024.0 * 1024.0)
+                  << std::setprecision(4)
+                  << std::setw(12) << result.conversionTime
+                  << std::setw(12) << result.extractionTime
+                  << std::setw(12) << result.numQuads
+                  << std::setprecision(3);
+        for(int e = 0; e < PerfCounters::NUM_EVENTS; ++e) {
+            if(counters.available(PerfCounters::Event(e))) {
+                std::cout << std::setw(18) << result.counts[e] / numQuads;
+            } else {
+                std::cout << std::setw(18) << "n/a";
+            }
+        }
+        std::cout << std::endl;
+
+        // all layouts have to produce the same surface
+        if(result.numQuads != results[0].numQuads || result.numVertices != results[0].numVertices) {
+            std::cerr << "Warning: " << layoutName(Layout(i))
+                      << " layout mesh differs from the " << layoutName(Layout(0)) << " layout mesh" << std::endl;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+char const * DualMCBenchmark::layoutName(Layout const layout) {
+    static char const * const names[NUM_LAYOUTS] = {
+        "linear", "bricked", "morton"
+    };
+    return names[layout];
+}
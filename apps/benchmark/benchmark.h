@@ -0,0 +1,130 @@
+// Copyright (C) 2018, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef BENCHMARK_H_INCLUDED
+#define BENCHMARK_H_INCLUDED
+
+/// \file   benchmark.h
+/// \author Dominik Wodniok
+/// \date   2018
+
+// std includes
+#include <string>
+
+// stl includes
+#include <vector>
+
+// dual mc builder
+#include "dualmc.h"
+
+// hardware counters
+#include "perfcounters.h"
+
+/// Benchmark application comparing the extraction performance of the dual
+/// marching cubes builder for different volume memory layouts.
+class DualMCBenchmark {
+public:
+    /// run benchmark
+    void run(int const argc, char** argv);
+
+private:
+
+    /// Benchmarked volume layouts.
+    enum Layout {
+        LAYOUT_LINEAR = 0,
+        LAYOUT_BRICKED,
+        LAYOUT_MORTON,
+        NUM_LAYOUTS
+    };
+
+    /// Structure for the program options.
+    struct AppOptions {
+        std::string inputFile;
+        int32_t dimX;
+        int32_t dimY;
+        int32_t dimZ;
+        int32_t gyroidDim;
+        float isoValue;
+        int32_t brickSize;
+        int32_t repetitions;
+        int32_t frames;
+        bool generateQuadSoup;
+        bool generateManifold;
+    };
+
+    /// Measurements for one layout.
+    struct Result {
+        // time for converting the linear volume into the layout
+        double conversionTime;
+        // fastest extraction time
+        double extractionTime;
+        // size of the volume in the layout in bytes
+        size_t memorySize;
+        // extracted mesh size
+        size_t numVertices;
+        size_t numQuads;
+        // hardware event counts of the fastest extraction
+        uint64_t counts[PerfCounters::NUM_EVENTS];
+    };
+
+    /// Parse program arguments.
+    bool parseArgs(int const argc, char** argv, AppOptions & options);
+
+    /// Generate a gyroid volume with cubic dimension.
+    void generateGyroid(int32_t const dim);
+
+    /// Load volume from raw file.
+    bool loadRawFile(std::string const & fileName, int32_t dimX, int32_t dimY, int32_t dimZ);
+
+    /// Convert the volume into a layout and measure the extraction.
+    Result benchmarkLayout(Layout const layout, AppOptions const & options);
+
+    /// Extract the surface repeatedly and keep the fastest run.
+    template<class Build>
+    void measureExtraction(Build const & build, AppOptions const & options, Result & result);
+
+    /// Extract an animated volume frame by frame, independently and as a time series.
+    void benchmarkTimeSeries(AppOptions const & options);
+
+    /// Write a frame of the animated volume with a blob moving through it.
+    void generateFrame(int32_t const frame, int32_t const numFrames, std::vector<uint8_t> & data) const;
+
+    /// Print the results for all layouts.
+    void printResults(std::vector<Result> const & results) const;
+
+    /// Name of a layout for printing.
+    static char const * layoutName(Layout const layout);
+
+    /// Print program arguments.
+    void printArgs() const;
+
+    /// Print program help hint.
+    void printHelpHint() const;
+
+private:
+    /// struct for volume data information
+    struct Volume {
+        // volume grid extents
+        int32_t dimX;
+        int32_t dimY;
+        int32_t dimZ;
+        /// volume data
+        std::vector<uint8_t> data;
+    };
+
+    /// benchmark volume
+    Volume volume;
+
+    /// hardware cache miss counters
+    PerfCounters counters;
+
+    /// array of vertices for the extracted surface
+    std::vector<dualmc::Vertex> vertices;
+
+    /// array of quad indices for the extracted surface
+    std::vector<dualmc::Quad> quads;
+};
+
+#endif // BENCHMARK_H_INCLUDED
@@ -0,0 +1,18 @@
+// Copyright (C) 2018, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+/// \file   main.cpp
+/// \author Dominik Wodniok
+/// \date   2018
+
+#include "benchmark.h"
+
+//------------------------------------------------------------------------------
+
+int main( int argc, char** argv) {
+    DualMCBenchmark benchmark;
+    benchmark.run(argc, argv);
+    return 0;
+}
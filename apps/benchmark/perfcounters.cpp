@@ -0,0 +1,124 @@
+// Copyright (C) 2018, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+/// \file   perfcounters.cpp
+/// \author Dominik Wodniok
+/// \date   2018
+
+// C libs
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// main include
+#include "perfcounters.h"
+
+//------------------------------------------------------------------------------
+
+#ifdef __linux__
+namespace {
+    /// Open a counter for a hardware event of the calling thread in user space.
+    int openCounter(uint32_t const type, uint64_t const config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    /// Encode a generic hardware cache event.
+    uint64_t cacheEvent(uint64_t const cache, uint64_t const op, uint64_t const result) {
+        return cache | (op << 8) | (result << 16);
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+
+PerfCounters::PerfCounters() {
+    for(int i = 0; i < NUM_EVENTS; ++i) {
+        fds[i] = -1;
+        counts[i] = 0;
+    }
+#ifdef __linux__
+    fds[L1D_READ_MISSES] = openCounter(PERF_TYPE_HW_CACHE,
+        cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    fds[LLC_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds[DTLB_READ_MISSES] = openCounter(PERF_TYPE_HW_CACHE,
+        cacheEvent(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for(int i = 0; i < NUM_EVENTS; ++i) {
+        if(fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for(int i = 0; i < NUM_EVENTS; ++i) {
+        if(fds[i] >= 0) {
+            ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+void PerfCounters::stop() {
+    for(int i = 0; i < NUM_EVENTS; ++i) {
+        counts[i] = 0;
+#ifdef __linux__
+        if(fds[i] >= 0) {
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t value = 0;
+            if(read(fds[i], &value, sizeof(value)) == sizeof(value)) {
+                counts[i] = value;
+            }
+        }
+#endif
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool PerfCounters::available(Event const event) const {
+    return fds[event] >= 0;
+}
+
+//------------------------------------------------------------------------------
+
+uint64_t PerfCounters::count(Event const event) const {
+    return counts[event];
+}
+
+//------------------------------------------------------------------------------
+
+char const * PerfCounters::eventName(Event const event) {
+    static char const * const names[NUM_EVENTS] = {
+        "L1D miss", "LLC miss", "dTLB miss"
+    };
+    return names[event];
+}
@@ -0,0 +1,62 @@
+// Copyright (C) 2018, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef PERFCOUNTERS_H_INCLUDED
+#define PERFCOUNTERS_H_INCLUDED
+
+/// \file   perfcounters.h
+/// \author Dominik Wodniok
+/// \date   2018
+
+// C libs
+#include <cstdint>
+
+/// Hardware cache miss counters of the calling thread. They are read with
+/// perf_event_open on Linux. Counters, which the kernel or the hardware does
+/// not provide, are reported as unavailable.
+class PerfCounters {
+public:
+    /// Counted hardware events.
+    enum Event {
+        L1D_READ_MISSES = 0,
+        LLC_MISSES,
+        DTLB_READ_MISSES,
+        NUM_EVENTS
+    };
+
+    /// Open the counters.
+    PerfCounters();
+
+    /// Close the counters.
+    ~PerfCounters();
+
+    /// Reset and start counting.
+    void start();
+
+    /// Stop counting and read the counts.
+    void stop();
+
+    /// Is the event counted?
+    bool available(Event const event) const;
+
+    /// Event count between the last start and stop.
+    uint64_t count(Event const event) const;
+
+    /// Name of an event for printing.
+    static char const * eventName(Event const event);
+
+private:
+    // non-copyable, as the counters own file descriptors
+    PerfCounters(PerfCounters const &);
+    PerfCounters & operator=(PerfCounters const &);
+
+    /// file descriptor of each event counter, -1 if unavailable
+    int fds[NUM_EVENTS];
+
+    /// counts between the last start and stop
+    uint64_t counts[NUM_EVENTS];
+};
+
+#endif // PERFCOUNTERS_H_INCLUDED
@@ -9,14 +9,28 @@
 
 // C libs
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 
+// process management for the brick workers
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 // std libs
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <mutex>
+#include <thread>
 
 // stl
 #include <vector>
@@ -24,6 +38,9 @@
 // dual mc builder
 #include "dualmc.h"
 
+// molecular density generator
+#include "moleculardensity.h"
+
 // main include
 #include "example.h"
 
@@ -40,9 +57,20 @@ void DualMCExample::run(int const argc, char** argv) {
         return;
     }
     
+    // stream the raw file through the extraction into the output file
+    if(options.pipeline) {
+        runPipeline(options);
+        return;
+    }
+    
     // load raw file or generate example volume dataset
+    high_resolution_clock::time_point const startTime = high_resolution_clock::now();
     if(options.generateCaffeine) {
         generateCaffeine();
+    } else if(!options.moleculeFile.empty()) {
+        if(!generateMolecule(options.moleculeFile, options.moleculeDim)) {
+            return;
+        }
     } else if(!options.inputFile.empty()) {
         if(!loadRawFile(options.inputFile, options.dimX, options.dimY, options.dimZ)) {
             return;
@@ -54,10 +82,13 @@ void DualMCExample::run(int const argc, char** argv) {
     }
     
     // compute ISO surface
-    computeSurface(options.isoValue,options.generateQuadSoup,options.generateManifold);
+    computeSurface(options);
     
     // write output file
     writeOBJ(options.outputFile);
+    
+    duration<double> const totalTime = duration_cast<duration<double>>(high_resolution_clock::now() - startTime);
+    std::cout << "Total time: " << totalTime.count() << "s" << std::endl;
 }
 
 //------------------------------------------------------------------------------
@@ -70,8 +101,25 @@ bool DualMCExample::parseArgs(int const argc, char** argv, AppOptions & options)
     options.dimZ = -1;
     options.isoValue = 0.5f;
     options.generateCaffeine = false;
+    options.moleculeFile.assign("");
+    options.moleculeDim = -1;
     options.generateQuadSoup = false;
     options.generateManifold = false;
+    options.printStats = false;
+    options.useSpanSpace = false;
+    options.boundaryPolicy = dualmc::BOUNDARY_NONE;
+    options.lodLevels = 1;
+    options.lodDistance = 0.0f;
+    options.compactVertices = false;
+    options.buildMeshlets = false;
+    options.reorderMesh = false;
+    options.numProcesses = 1;
+    options.pipeline = false;
+    options.useSeed = false;
+    options.seed[0] = options.seed[1] = options.seed[2] = 0;
+    options.filterIslands = false;
+    options.decimateQuads = 0;
+    options.decimateError = -1.0f;
     options.outputFile.assign("surface.obj");
     
     // parse arguments
@@ -82,6 +130,79 @@ bool DualMCExample::parseArgs(int const argc, char** argv, AppOptions & options)
             options.generateCaffeine = true;
         } else if(strcmp(argv[currentArg],"-manifold") == 0) {
             options.generateManifold = true;
+        } else if(strcmp(argv[currentArg],"-stats") == 0) {
+            options.printStats = true;
+        } else if(strcmp(argv[currentArg],"-spanspace") == 0) {
+            options.useSpanSpace = true;
+        } else if(strcmp(argv[currentArg],"-compact") == 0) {
+            options.compactVertices = true;
+        } else if(strcmp(argv[currentArg],"-meshlets") == 0) {
+            options.buildMeshlets = true;
+        } else if(strcmp(argv[currentArg],"-reorder") == 0) {
+            options.reorderMesh = true;
+        } else if(strcmp(argv[currentArg],"-boundary") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Boundary policy missing" << std::endl;
+                return false;
+            }
+            char const * policy = argv[currentArg+1];
+            if(strcmp(policy,"none") == 0) {
+                options.boundaryPolicy = dualmc::BOUNDARY_NONE;
+            } else if(strcmp(policy,"constant") == 0) {
+                options.boundaryPolicy = dualmc::BOUNDARY_CONSTANT;
+            } else if(strcmp(policy,"clamp") == 0) {
+                options.boundaryPolicy = dualmc::BOUNDARY_CLAMP;
+            } else if(strcmp(policy,"periodic") == 0) {
+                options.boundaryPolicy = dualmc::BOUNDARY_PERIODIC;
+            } else {
+                std::cerr << "Unknown boundary policy: " << policy << std::endl;
+                return false;
+            }
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-lod") == 0) {
+            if(currentArg+2 >= argc) {
+                std::cerr << "Not enough arguments for level of detail" << std::endl;
+                return false;
+            }
+            options.lodLevels = std::max(atoi(argv[currentArg+1]), 1);
+            options.lodDistance = atof(argv[currentArg+2]);
+            currentArg += 2;
+        } else if(strcmp(argv[currentArg],"-pipeline") == 0) {
+            options.pipeline = true;
+        } else if(strcmp(argv[currentArg],"-seed") == 0) {
+            if(currentArg+3 >= argc) {
+                std::cerr << "Not enough arguments for seed voxel" << std::endl;
+                return false;
+            }
+            options.useSeed = true;
+            options.seed[0] = atoi(argv[currentArg+1]);
+            options.seed[1] = atoi(argv[currentArg+2]);
+            options.seed[2] = atoi(argv[currentArg+3]);
+            currentArg += 3;
+        } else if(strcmp(argv[currentArg],"-processes") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Number of processes missing" << std::endl;
+                return false;
+            }
+            options.numProcesses = std::max(atoi(argv[currentArg+1]), 1);
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-islands") == 0) {
+            if(currentArg+2 >= argc) {
+                std::cerr << "Not enough arguments for island filtering" << std::endl;
+                return false;
+            }
+            options.filterIslands = true;
+            options.islandFilter.minQuads = std::max(atol(argv[currentArg+1]), 0L);
+            options.islandFilter.minArea = std::max(float(atof(argv[currentArg+2])), 0.0f);
+            currentArg += 2;
+        } else if(strcmp(argv[currentArg],"-decimate") == 0) {
+            if(currentArg+2 >= argc) {
+                std::cerr << "Not enough arguments for decimation" << std::endl;
+                return false;
+            }
+            options.decimateQuads = std::max(atol(argv[currentArg+1]), 0L);
+            options.decimateError = std::max(float(atof(argv[currentArg+2])), 0.0f);
+            currentArg += 2;
         } else if(strcmp(argv[currentArg],"-iso") == 0) {
             if(currentArg+1 == argc) {
                 std::cerr << "Iso value missing" << std::endl;
@@ -112,6 +233,14 @@ bool DualMCExample::parseArgs(int const argc, char** argv, AppOptions & options)
             options.dimY = atoi(argv[currentArg+3]);
             options.dimZ = atoi(argv[currentArg+4]);
             currentArg += 4;
+        } else if(strcmp(argv[currentArg],"-molecule") == 0) {
+            if(currentArg+2 >= argc) {
+                std::cerr << "Not enough arguments for molecule file" << std::endl;
+                return false;
+            }
+            options.moleculeFile.assign(argv[currentArg+1]);
+            options.moleculeDim = atoi(argv[currentArg+2]);
+            currentArg += 2;
         } else if(strcmp(argv[currentArg],"-help") == 0) {
             printArgs();
             return false;
@@ -121,6 +250,36 @@ bool DualMCExample::parseArgs(int const argc, char** argv, AppOptions & options)
             return false;
         }
     }
+    
+    // the extraction modes exclude each other
+    int const extractionModes = (options.lodLevels > 1) + (options.numProcesses > 1) +
+        options.useSeed + options.useSpanSpace + options.compactVertices + options.buildMeshlets +
+        (options.boundaryPolicy != dualmc::BOUNDARY_NONE) + options.pipeline;
+    if(extractionModes > 1) {
+        std::cerr << "Only one of -lod, -processes, -seed, -spanspace, -compact, -meshlets, "
+            << "-boundary and -pipeline can be used" << std::endl;
+        return false;
+    }
+    
+    // these modes only produce meshes with shared vertices
+    if(options.generateQuadSoup && (options.buildMeshlets || options.numProcesses > 1 ||
+            options.filterIslands || options.decimateError >= 0.0f)) {
+        std::cerr << "-soup cannot be combined with -meshlets, -processes, -islands or -decimate" << std::endl;
+        return false;
+    }
+    
+    // the pipeline writes the mesh while it is extracted
+    if(options.pipeline && (options.generateQuadSoup || options.printStats || options.filterIslands ||
+            options.decimateError >= 0.0f || options.reorderMesh)) {
+        std::cerr << "-pipeline cannot be combined with -soup, -stats, -islands, -decimate or -reorder" << std::endl;
+        return false;
+    }
+    
+    // the levels of detail are always extracted without these options
+    if(options.lodLevels > 1 && (options.generateManifold || options.generateQuadSoup || options.printStats)) {
+        std::cerr << "-lod cannot be combined with -manifold, -soup or -stats" << std::endl;
+        return false;
+    }
     return true;
 }
 
@@ -131,10 +290,23 @@ void DualMCExample::printArgs() const {
     std::cout << " -help              print this help" << std::endl;
     std::cout << " -raw FILE X Y Z    specify raw file with dimensions" << std::endl;
     std::cout << " -caffeine          generate built-in caffeine molecule" << std::endl;
+    std::cout << " -molecule FILE N   generate N^3 density volume from PDB or XYZ file" << std::endl;
     std::cout << " -manifold          use Manifold Dual Marching Cubes algorithm (Rephael Wenger)" << std::endl;
     std::cout << " -iso X             specify iso value X in [0,1]. DEFAULT: 0.5" << std::endl;
     std::cout << " -out FILE          specify output file name. DEFAULT: surface.obj" << std::endl;
     std::cout << " -soup              generate a quad soup (no vertex sharing)" << std::endl;
+    std::cout << " -stats             print build statistics and hot path counters" << std::endl;
+    std::cout << " -spanspace         extract only active cells found with a span space index" << std::endl;
+    std::cout << " -compact           extract 64-bit compact vertices and decode them" << std::endl;
+    std::cout << " -meshlets          group the quads into meshlets while extracting" << std::endl;
+    std::cout << " -reorder           reorder quads and vertices for the vertex cache" << std::endl;
+    std::cout << " -processes N       extract N bricks in worker processes and stitch them" << std::endl;
+    std::cout << " -seed X Y Z        extract only the surface component hit along +x from voxel (X,Y,Z)" << std::endl;
+    std::cout << " -pipeline          overlap loading, extraction and writing of a raw file" << std::endl;
+    std::cout << " -boundary POLICY   exterior voxels: none, constant (0), clamp or periodic. DEFAULT: none" << std::endl;
+    std::cout << " -lod N D           extract N levels of detail, finest up to distance D from the origin" << std::endl;
+    std::cout << " -islands N A       drop connected components with less than N quads or area A" << std::endl;
+    std::cout << " -decimate N E      simplify to N quads with error up to E voxels, 0 disables a limit" << std::endl;
 }
 
 //------------------------------------------------------------------------------
@@ -145,15 +317,79 @@ void DualMCExample::printHelpHint() const {
 
 //------------------------------------------------------------------------------
 
-void DualMCExample::computeSurface(float const iso, bool const generateSoup, bool const generateManifold) {
+void DualMCExample::computeSurface(AppOptions const & options) {
+    uint8_t const iso = options.isoValue * std::numeric_limits<uint8_t>::max();
+    dualmc::DualMC builder;
+    dualmc::BuildStats stats;
+    
+    // build the span space index once per volume
+    dualmc::SpanSpaceIndex index;
+    if(options.useSpanSpace) {
+        std::cout << "Building span space index" << std::endl;
+        high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+        index.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ);
+        duration<double> const diffTime = duration_cast<duration<double>>(high_resolution_clock::now() - startTime);
+        std::cout << "Index time: " << diffTime.count() << "s for " << index.numCells() << " cells" << std::endl;
+    }
+    
+    // build the volume pyramid for the levels of detail
+    dualmc::VolumePyramid pyramid;
+    if(options.lodLevels > 1) {
+        std::cout << "Building volume pyramid" << std::endl;
+        high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+        pyramid.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ, options.lodLevels);
+        duration<double> const diffTime = duration_cast<duration<double>>(high_resolution_clock::now() - startTime);
+        std::cout << "Pyramid time: " << diffTime.count() << "s for " << pyramid.memorySize() << " bytes" << std::endl;
+    }
+    
     std::cout << "Computing surface" << std::endl;
+    bool islandsFiltered = false;
     
     // measure extraction time
     high_resolution_clock::time_point const startTime = high_resolution_clock::now();
 
-    dualmc::DualMC builder;
-    builder.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ,
-        iso * std::numeric_limits<uint8_t>::max(), generateManifold, generateSoup, vertices, quads);
+    if(options.lodLevels > 1) {
+        dualmc::LodDualMC lod(pyramid);
+        float const viewpoint[] = {0.0f, 0.0f, 0.0f};
+        lod.selectLevels(viewpoint, options.lodDistance);
+        lod.build(iso, vertices, quads);
+    } else if(options.numProcesses > 1) {
+        if(!computeSurfaceInProcesses(options, iso)) {
+            return;
+        }
+    } else if(options.useSeed) {
+        builder.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ, options.seed,
+            iso, options.generateManifold, options.generateQuadSoup, vertices, quads, &stats);
+    } else if(options.useSpanSpace) {
+        builder.build(&volume.data.front(), index, iso, options.generateManifold,
+            options.generateQuadSoup, vertices, quads, &stats);
+    } else if(options.compactVertices) {
+        std::vector<dualmc::CompactVertex> compactVertices;
+        builder.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ,
+            iso, options.generateManifold, options.generateQuadSoup, compactVertices, quads, &stats);
+        std::cout << "Compact vertices: " << compactVertices.size() * sizeof(dualmc::CompactVertex)
+            << " bytes" << std::endl;
+        dualmc::decodeVertices(compactVertices, volume.dimX, volume.dimY, vertices);
+    } else if(options.buildMeshlets) {
+        dualmc::MeshletMesh meshlets;
+        builder.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ,
+            iso, options.generateManifold, vertices, meshlets, &quads, &stats);
+        std::cout << "Meshlets: " << meshlets.meshlets.size() << ", "
+            << meshlets.vertexIndices.size() * sizeof(uint32_t) + meshlets.triangles.size()
+            << " index bytes" << std::endl;
+    } else if(options.boundaryPolicy != dualmc::BOUNDARY_NONE) {
+        builder.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ,
+            iso, options.generateManifold, options.generateQuadSoup,
+            options.boundaryPolicy, 0, vertices, quads, &stats);
+    } else if(options.filterIslands && !options.generateQuadSoup) {
+        // label the components during the extraction
+        builder.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ,
+            iso, options.generateManifold, options.islandFilter, vertices, quads, &stats);
+        islandsFiltered = true;
+    } else {
+        builder.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ,
+            iso, options.generateManifold, options.generateQuadSoup, vertices, quads, &stats);
+    }
 
 //    // construct iso surface
 //    if(volume.bitDepth == 8) {
@@ -172,6 +408,299 @@ void DualMCExample::computeSurface(float const iso, bool const generateSoup, boo
     double const extractionTime = diffTime.count();
     
     std::cout << "Extraction time: " << extractionTime << "s" << std::endl;
+    
+    // drop small components of other extraction modes afterwards
+    if(options.filterIslands && !islandsFiltered && !options.generateQuadSoup) {
+        high_resolution_clock::time_point const filterStart = high_resolution_clock::now();
+        size_t const removed = dualmc::filterComponents(vertices, quads, options.islandFilter);
+        duration<double> const filterTime = duration_cast<duration<double>>(high_resolution_clock::now() - filterStart);
+        std::cout << "Island filter time: " << filterTime.count() << "s, removed "
+            << removed << " components" << std::endl;
+    }
+    
+    // simplify the quad mesh
+    if(options.decimateError >= 0.0f && !options.generateQuadSoup) {
+        high_resolution_clock::time_point const decimateStart = high_resolution_clock::now();
+        size_t const extractedQuads = quads.size();
+        dualmc::QuadDecimator decimator;
+        decimator.decimate(vertices, quads, options.decimateQuads, options.decimateError);
+        duration<double> const decimateTime = duration_cast<duration<double>>(high_resolution_clock::now() - decimateStart);
+        std::cout << "Decimation time: " << decimateTime.count() << "s, " << extractedQuads
+            << " -> " << quads.size() << " quads" << std::endl;
+    }
+    
+    // optimize the order for the vertex cache
+    if(options.reorderMesh) {
+        double const acmrBefore = dualmc::averageCacheMissRatio(quads);
+        high_resolution_clock::time_point const reorderStart = high_resolution_clock::now();
+        dualmc::reorderMesh(vertices, quads);
+        duration<double> const reorderTime = duration_cast<duration<double>>(high_resolution_clock::now() - reorderStart);
+        std::cout << "Reorder time: " << reorderTime.count() << "s, ACMR " << acmrBefore
+            << " -> " << dualmc::averageCacheMissRatio(quads) << std::endl;
+    }
+    
+    if(options.printStats) {
+        if(options.numProcesses > 1) {
+            // the builds run in the worker processes
+            std::cout << "Build statistics not available with -processes." << std::endl;
+        } else {
+            printStats(stats);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool DualMCExample::runPipeline(AppOptions const & options) {
+    // number of slices read at once and of voxel layers written at once
+    int32_t const slabSlices = 16;
+    
+    if(options.inputFile.empty()) {
+        std::cerr << "Pipelined mode requires a raw file" << std::endl;
+        return false;
+    }
+    if(options.dimX < 1 || options.dimY < 1 || options.dimZ < 1) {
+        std::cerr << "Invalid RAW file dimensions specified" << std::endl;
+        return false;
+    }
+    std::ifstream file(options.inputFile, std::ifstream::binary);
+    if(!file) {
+        std::cerr << "Unable to open file '" << options.inputFile << "'" << std::endl;
+        return false;
+    }
+    size_t const sliceSize = size_t(options.dimX) * size_t(options.dimY);
+    size_t const expectedFileSize = sliceSize * size_t(options.dimZ);
+    file.seekg(0, file.end);
+    size_t const fileSize = file.tellg();
+    file.seekg(0, file.beg);
+    if(expectedFileSize != fileSize) {
+        std::cerr << "File size inconsistent with specified dimensions of an 8-bit volume" << std::endl;
+        return false;
+    }
+    std::ofstream output(options.outputFile);
+    if(!output) {
+        std::cerr << "Error opening output file" << std::endl;
+        return false;
+    }
+    
+    volume.dimX = options.dimX;
+    volume.dimY = options.dimY;
+    volume.dimZ = options.dimZ;
+    volume.bitDepth = 8;
+    volume.data.resize(fileSize);
+    uint8_t const iso = options.isoValue * std::numeric_limits<uint8_t>::max();
+    
+    std::cout << "Running pipelined load, extraction and output" << std::endl;
+    high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+    auto secondsSince = [](high_resolution_clock::time_point const start) {
+        return duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+    };
+    
+    // reader stage: publish the number of slices loaded so far
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<int32_t> loadedSlices(0);
+    bool readError = false;
+    double readTime = 0.0;
+    std::thread reader([&]() {
+        for(int32_t z = 0; z < volume.dimZ; z += slabSlices) {
+            high_resolution_clock::time_point const readStart = high_resolution_clock::now();
+            int32_t const slices = std::min(slabSlices, volume.dimZ - z);
+            file.read((char*)&volume.data[sliceSize * z], sliceSize * slices);
+            readTime += secondsSince(readStart);
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!file) {
+                readError = true;
+                loadedSlices = volume.dimZ;
+            } else {
+                loadedSlices = z + slices;
+            }
+            condition.notify_all();
+            if(readError) {
+                break;
+            }
+        }
+    });
+    
+    // writer stage: serialize the slabs of the mesh in extraction order
+    struct MeshSlab {
+        std::vector<dualmc::Vertex> vertices;
+        std::vector<dualmc::Quad> quads;
+    };
+    std::deque<MeshSlab> slabs;
+    bool extractionDone = false;
+    double writeTime = 0.0;
+    std::thread writer([&]() {
+        for(;;) {
+            MeshSlab slab;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return !slabs.empty() || extractionDone; });
+                if(slabs.empty()) {
+                    break;
+                }
+                slab = std::move(slabs.front());
+                slabs.pop_front();
+            }
+            high_resolution_clock::time_point const writeStart = high_resolution_clock::now();
+            for(auto const & v : slab.vertices) {
+                output << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
+            }
+            for(auto const & q : slab.quads) {
+                output << "f " << (q.i0+1) << ' ' << (q.i1+1) << ' ' << (q.i2+1) << ' ' << (q.i3+1) << '\n';
+            }
+            writeTime += secondsSince(writeStart);
+        }
+    });
+    
+    // extraction stage: sample slices as they arrive and hand over the new
+    // part of the mesh after each slab of voxel layers
+    double waitTime = 0.0;
+    auto sampler = [&](int32_t const y, int32_t const z, uint8_t * row) {
+        if(loadedSlices <= z) {
+            high_resolution_clock::time_point const waitStart = high_resolution_clock::now();
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]() { return loadedSlices > z; });
+            waitTime += secondsSince(waitStart);
+        }
+        std::memcpy(row, &volume.data[sliceSize * z + size_t(volume.dimX) * y], volume.dimX);
+    };
+    size_t handedVertices = 0;
+    size_t handedQuads = 0;
+    int32_t doneLayers = 0;
+    auto handOver = [&]() {
+        MeshSlab slab;
+        slab.vertices.assign(vertices.begin() + handedVertices, vertices.end());
+        slab.quads.assign(quads.begin() + handedQuads, quads.end());
+        handedVertices = vertices.size();
+        handedQuads = quads.size();
+        std::lock_guard<std::mutex> lock(mutex);
+        slabs.push_back(std::move(slab));
+        condition.notify_all();
+    };
+    high_resolution_clock::time_point const extractionStart = high_resolution_clock::now();
+    dualmc::DualMC builder;
+    builder.build(sampler, volume.dimX, volume.dimY, volume.dimZ, iso, options.generateManifold,
+        vertices, quads,
+        [&](std::vector<dualmc::Vertex> const &, std::vector<dualmc::Quad> const &) {
+            if(++doneLayers % slabSlices == 0) {
+                handOver();
+            }
+        });
+    handOver();
+    double const extractionTime = secondsSince(extractionStart) - waitTime;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        extractionDone = true;
+        condition.notify_all();
+    }
+    reader.join();
+    writer.join();
+    output.close();
+    double const totalTime = secondsSince(startTime);
+    
+    if(readError) {
+        std::cerr << "Error while reading file" << std::endl;
+        return false;
+    }
+    std::cout << "Generated OBJ mesh with " << vertices.size() << " vertices and "
+        << quads.size() << " quads" << std::endl;
+    std::cout << "Read time: " << readTime << "s, extraction time: " << extractionTime
+        << "s, write time: " << writeTime << "s" << std::endl;
+    std::cout << "Pipeline time: " << totalTime << "s" << std::endl;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool DualMCExample::computeSurfaceInProcesses(AppOptions const & options, uint8_t const iso) {
+    // split the volume into slabs along z, one per process
+    dualmc::BrickPartition const partition(volume.dimX, volume.dimY, volume.dimZ,
+        1, 1, options.numProcesses);
+    int32_t const numBricks = partition.numBricks();
+    
+    // each worker only sees the voxels of its brick and writes its mesh to a file
+    auto brickFile = [&](int32_t const brick) {
+        return options.outputFile + ".brick" + std::to_string(brick);
+    };
+    auto meshBrick = [&](int32_t const brick) {
+        std::vector<uint8_t> brickData;
+        partition.copyBrickData(&volume.data.front(), brick, brickData);
+        dualmc::DualMC builder;
+        dualmc::BrickMesh mesh;
+        builder.build(brickData.data(), partition, brick, iso, options.generateManifold, mesh);
+        std::ofstream file(brickFile(brick), std::ios::binary);
+        return dualmc::writeBrickMesh(file, mesh);
+    };
+    
+    bool success = true;
+#if defined(__unix__) || defined(__APPLE__)
+    std::vector<pid_t> workers;
+    for(int32_t brick = 0; brick < numBricks; ++brick) {
+        pid_t const pid = fork();
+        if(pid == 0) {
+            _exit(meshBrick(brick) ? EXIT_SUCCESS : EXIT_FAILURE);
+        } else if(pid < 0) {
+            std::cerr << "Could not start worker process" << std::endl;
+            success = false;
+            break;
+        }
+        workers.push_back(pid);
+    }
+    for(pid_t const pid : workers) {
+        int status = 0;
+        if(waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            success = false;
+        }
+    }
+#else
+    // without processes the bricks are meshed one after another
+    for(int32_t brick = 0; brick < numBricks && success; ++brick) {
+        success = meshBrick(brick);
+    }
+#endif
+    
+    // collect the brick meshes and merge them by their global vertex keys
+    std::vector<dualmc::BrickMesh> meshes(numBricks);
+    for(int32_t brick = 0; brick < numBricks; ++brick) {
+        std::ifstream file(brickFile(brick), std::ios::binary);
+        if(success && !dualmc::readBrickMesh(file, meshes[brick])) {
+            success = false;
+        }
+        file.close();
+        std::remove(brickFile(brick).c_str());
+    }
+    if(!success) {
+        std::cerr << "Brick extraction failed" << std::endl;
+        return false;
+    }
+    dualmc::stitchBrickMeshes(meshes, vertices, quads);
+    std::cout << "Stitched " << numBricks << " bricks from worker processes" << std::endl;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCExample::printStats(dualmc::BuildStats const & stats) const {
+    if(!dualmc::BuildStats::enabled) {
+        std::cout << "Build statistics not available. Compile with DUALMC_ENABLE_STATS." << std::endl;
+        return;
+    }
+    
+    std::cout << "Build statistics:" << std::endl;
+    std::cout << "  cells visited:        " << stats.cellsVisited << std::endl;
+    std::cout << "  crossing edges x/y/z: " << stats.crossingEdges[0] << " / "
+        << stats.crossingEdges[1] << " / " << stats.crossingEdges[2] << std::endl;
+    std::cout << "  quads emitted:        " << stats.quadsEmitted << std::endl;
+    std::cout << "  point lookups:        " << stats.pointLookups << " ("
+        << stats.pointLookupHitRate() * 100.0 << "% hits)" << std::endl;
+    std::cout << "  manifold inversions:  " << stats.manifoldInversions << std::endl;
+    for(int p = 0; p < dualmc::NUM_BUILD_PHASES; ++p) {
+        dualmc::BUILD_PHASE const phase = static_cast<dualmc::BUILD_PHASE>(p);
+        std::cout << "  " << dualmc::BuildStats::phaseName(phase) << " time: "
+            << stats.phaseTimes[p] << "s" << std::endl;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -267,6 +796,35 @@ void DualMCExample::generateCaffeine() {
 
 //------------------------------------------------------------------------------
 
+bool DualMCExample::generateMolecule(std::string const & fileName, int32_t dim) {
+    if(dim < 2) {
+        std::cerr << "Invalid molecule volume dimension specified" << std::endl;
+        return false;
+    }
+    
+    dualmc::MolecularDensity molecule;
+    if(!molecule.loadFile(fileName)) {
+        std::cerr << "Unable to read molecule file '" << fileName << "'" << std::endl;
+        return false;
+    }
+    
+    std::cout << "Generating density volume for " << molecule.atoms().size() << " atoms" << std::endl;
+    
+    high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+    
+    volume.dimX = dim;
+    volume.dimY = dim;
+    volume.dimZ = dim;
+    volume.bitDepth = 8;
+    molecule.generate(dim, dim, dim, volume.data);
+    
+    duration<double> const diffTime = duration_cast<duration<double>>(high_resolution_clock::now() - startTime);
+    std::cout << "Generation time: " << diffTime.count() << "s" << std::endl;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
 bool DualMCExample::loadRawFile(std::string const & fileName, int32_t dimX, int32_t dimY, int32_t dimZ) {
     // check provided dimensions
     if(dimX < 1 || dimY < 1 || dimZ < 1) {
@@ -312,6 +870,7 @@ bool DualMCExample::loadRawFile(std::string const & fileName, int32_t dimX, int3
     volume.data.resize(fileSize);
     
     // read data
+    high_resolution_clock::time_point const startTime = high_resolution_clock::now();
     file.read((char*)&volume.data[0], fileSize);
     
     if(!file) {
@@ -319,6 +878,8 @@ bool DualMCExample::loadRawFile(std::string const & fileName, int32_t dimX, int3
         return false;
     }
     
+    duration<double> const diffTime = duration_cast<duration<double>>(high_resolution_clock::now() - startTime);
+    std::cout << "Read time: " << diffTime.count() << "s" << std::endl;
     return true;
 }
 
@@ -343,6 +904,7 @@ void DualMCExample::writeOBJ(std::string const & fileName) const {
       << quads.size() << " quads" << std::endl;
     
     // write vertices
+    high_resolution_clock::time_point const startTime = high_resolution_clock::now();
     for(auto const & v : vertices) {
         file << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
     }
@@ -353,6 +915,8 @@ void DualMCExample::writeOBJ(std::string const & fileName) const {
     }
     
     file.close();
+    duration<double> const diffTime = duration_cast<duration<double>>(high_resolution_clock::now() - startTime);
+    std::cout << "Write time: " << diffTime.count() << "s" << std::endl;
 }
 
 //------------------------------------------------------------------------------
@@ -19,6 +19,15 @@
 // dual mc builder vertex and quad definitions
 #include "dualmc.h"
 
+// level of detail builder
+#include "loddualmc.h"
+
+// quad mesh simplification
+#include "quaddecimator.h"
+
+// vertex cache optimization
+#include "meshreorder.h"
+
 /// Example application for demonstrating the dual marching cubes builder.
 class DualMCExample {
 public:
@@ -35,8 +44,26 @@ private:
         int32_t dimZ;
         float isoValue;
         bool generateCaffeine;
+        std::string moleculeFile;
+        int32_t moleculeDim;
         bool generateQuadSoup;
         bool generateManifold;
+        bool printStats;
+        bool useSpanSpace;
+        dualmc::BOUNDARY_POLICY boundaryPolicy;
+        int lodLevels;
+        float lodDistance;
+        bool compactVertices;
+        bool buildMeshlets;
+        bool reorderMesh;
+        int numProcesses;
+        bool pipeline;
+        bool useSeed;
+        int32_t seed[3];
+        bool filterIslands;
+        dualmc::ComponentFilter islandFilter;
+        size_t decimateQuads;
+        float decimateError;
         std::string outputFile;
     };
 
@@ -46,12 +73,26 @@ private:
     /// Generate an example volume for the dual mc builder.
     void generateCaffeine();
     
+    /// Generate a density volume with cubic dimension for a molecule file.
+    bool generateMolecule(std::string const & fileName, int32_t dim);
+    
     /// Load volume from raw file.
     bool loadRawFile(std::string const & fileName, int32_t dimX, int32_t dimY, int32_t dimZ);
 
-    /// Compute the iso surface for the specified iso value. Optionally generate
-    /// a quad soup.
-    void computeSurface(float const iso, bool const generateSoup, bool const generateManifold);
+    /// Compute the iso surface for the specified iso value and builder
+    /// options. Optionally print the build statistics.
+    void computeSurface(AppOptions const & options);
+    
+    /// Load a raw file, extract the iso surface and write it as OBJ file in
+    /// overlapping stages, which pass on slabs of the volume and the mesh.
+    bool runPipeline(AppOptions const & options);
+    
+    /// Extract the iso surface in bricks by separate worker processes and
+    /// stitch their meshes.
+    bool computeSurfaceInProcesses(AppOptions const & options, uint8_t const iso);
+    
+    /// Print the statistics of a build.
+    void printStats(dualmc::BuildStats const & stats) const;
     
     /// Write a Wavefront OBJ model for the extracted ISO surface.
     void writeOBJ(std::string const & fileName) const;
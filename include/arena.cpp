@@ -0,0 +1,185 @@
+#include "arena.h"
+
+// C includes
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// STL includes
+#include <algorithm>
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Round up to a multiple of a power of two
+inline size_t alignUp( const size_t value, const size_t alignment )
+{
+    return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+}
+
+/**
+ * @brief Arena::Arena
+ * @param chunkSize
+ */
+Arena::Arena( const size_t chunkSize )
+    : _chunkSize( std::max( chunkSize, CACHE_LINE_SIZE )),
+      _hugePages( false ),
+      _current( 0 ),
+      _offset( 0 ),
+      _chunkAllocations( 0 )
+{
+    /// EMPTY
+}
+
+/**
+ * @brief Arena::~Arena
+ */
+Arena::~Arena()
+{
+    _freeChunks();
+}
+
+/**
+ * @brief Arena::allocate
+ * @param size
+ * @param alignment
+ * @return
+ */
+void * Arena::allocate( const size_t size, const size_t alignment )
+{
+    // Continue with the next chunk, until the allocation fits
+    while( _current < _chunks.size())
+    {
+        Chunk const & chunk = _chunks[ _current ];
+        size_t const offset = _alignedOffset( chunk, _offset, alignment );
+        if( offset + size <= chunk.size )
+        {
+            _offset = offset + size;
+            return chunk.data + offset;
+        }
+        ++_current;
+        _offset = 0;
+    }
+
+    // Grow geometrically
+    size_t const chunkSize = std::max( std::max( _chunkSize, capacity()),
+                                       size + alignment );
+    _chunks.push_back( _allocateChunk( chunkSize ));
+    size_t const offset = _alignedOffset( _chunks.back(), 0, alignment );
+    _offset = offset + size;
+    return _chunks.back().data + offset;
+}
+
+/**
+ * @brief Arena::reset
+ */
+void Arena::reset()
+{
+    // Merge the chunks, so the next round of the same size fits into one
+    if( _chunks.size() > 1 )
+    {
+        size_t const size = capacity();
+        _freeChunks();
+        _chunks.push_back( _allocateChunk( size ));
+    }
+    _current = 0;
+    _offset = 0;
+}
+
+/**
+ * @brief Arena::setHugePages
+ * @param enable
+ */
+void Arena::setHugePages( const bool enable )
+{
+    _hugePages = enable;
+}
+
+/**
+ * @brief Arena::hugePages
+ * @return
+ */
+bool Arena::hugePages() const
+{
+    return _hugePages;
+}
+
+/**
+ * @brief Arena::capacity
+ * @return
+ */
+size_t Arena::capacity() const
+{
+    size_t size = 0;
+    for( const Chunk & chunk : _chunks )
+    {
+        size += chunk.size;
+    }
+    return size;
+}
+
+/**
+ * @brief Arena::chunkAllocations
+ * @return
+ */
+size_t Arena::chunkAllocations() const
+{
+    return _chunkAllocations;
+}
+
+/**
+ * @brief Arena::_allocateChunk
+ * @param size
+ * @return
+ */
+Arena::Chunk Arena::_allocateChunk( const size_t size )
+{
+    // Huge pages need chunks aligned to and sized in huge pages
+    size_t const alignment = _hugePages ? HUGE_PAGE_SIZE : CACHE_LINE_SIZE;
+    Chunk chunk;
+    chunk.size = alignUp( size, alignment );
+    chunk.memory = ::operator new( chunk.size + alignment );
+    chunk.data = reinterpret_cast< uint8_t * >( alignUp( reinterpret_cast< uintptr_t >( chunk.memory ), alignment ));
+#if defined( __linux__ ) && defined( MADV_HUGEPAGE )
+    if( _hugePages )
+    {
+        madvise( chunk.data, chunk.size, MADV_HUGEPAGE );
+    }
+#endif
+    ++_chunkAllocations;
+    return chunk;
+}
+
+/**
+ * @brief Arena::_alignedOffset
+ * @param chunk
+ * @param offset
+ * @param alignment
+ * @return
+ */
+size_t Arena::_alignedOffset( const Chunk & chunk, const size_t offset, const size_t alignment )
+{
+    uintptr_t const address = reinterpret_cast< uintptr_t >( chunk.data ) + offset;
+    return offset + ( alignUp( address, alignment ) - address );
+}
+
+/**
+ * @brief Arena::_freeChunks
+ */
+void Arena::_freeChunks()
+{
+    for( const Chunk & chunk : _chunks )
+    {
+        ::operator delete( chunk.memory );
+    }
+    _chunks.clear();
+    _current = 0;
+    _offset = 0;
+}
+
+}
@@ -0,0 +1,205 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <new>
+#include <vector>
+
+namespace dualmc
+{
+
+/**
+ * @brief The Arena class
+ * Bump allocator for scratch memory, which is released all at once. Memory
+ * comes from a few large cache line aligned chunks. Resetting the arena
+ * keeps its memory, and chunks added while growing are merged into one, so
+ * after a warm-up round of the same size no more heap allocations are made.
+ * Chunks can optionally be backed by transparent huge pages on Linux.
+ */
+class Arena
+{
+public:
+
+    /// Size of a cache line, which is the default alignment
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    /// Size of a transparent huge page
+    static constexpr size_t HUGE_PAGE_SIZE = size_t( 2 ) << 20;
+
+    /**
+     * @brief Arena
+     * @param chunkSize
+     * Minimum size of the chunks.
+     */
+    explicit Arena( const size_t chunkSize = size_t( 1 ) << 20 );
+
+    /// Frees all chunks
+    ~Arena();
+
+    // Allocations point into the chunks of the arena
+    Arena( const Arena & ) = delete;
+    Arena & operator=( const Arena & ) = delete;
+
+    /**
+     * @brief allocate
+     * Allocate memory, which stays valid until the next reset.
+     * @param size
+     * @param alignment
+     * Power of two alignment.
+     * @return
+     */
+    void * allocate( const size_t size, const size_t alignment = CACHE_LINE_SIZE );
+
+    /**
+     * @brief reset
+     * Release all allocations, keeping the memory for the next round.
+     */
+    void reset();
+
+    /**
+     * @brief setHugePages
+     * Back chunks added from now on by transparent huge pages. Without
+     * support by the system the chunks are just aligned to huge pages.
+     * @param enable
+     */
+    void setHugePages( const bool enable );
+
+    /// Whether new chunks use transparent huge pages
+    bool hugePages() const;
+
+    /// Total size of the chunks
+    size_t capacity() const;
+
+    /// Number of chunks allocated from the heap so far
+    size_t chunkAllocations() const;
+
+private:
+
+    /// Chunk of memory with its aligned start
+    struct Chunk
+    {
+        void * memory;
+        uint8_t * data;
+        size_t size;
+    };
+
+    /// Allocate a chunk of at least the given size
+    Chunk _allocateChunk( const size_t size );
+
+    /// Offset in a chunk aligned in memory
+    static size_t _alignedOffset( const Chunk & chunk, const size_t offset, const size_t alignment );
+
+    /// Free all chunks
+    void _freeChunks();
+
+private:
+
+    /**
+     * @brief _chunkSize
+     * Minimum size of the chunks.
+     */
+    size_t _chunkSize;
+
+    /**
+     * @brief _hugePages
+     * Whether new chunks use transparent huge pages.
+     */
+    bool _hugePages;
+
+    /**
+     * @brief _chunks, _current, _offset
+     * Chunks of the arena, the chunk currently allocated from and the
+     * offset of its free memory.
+     */
+    std::vector< Chunk > _chunks;
+    size_t _current;
+    size_t _offset;
+
+    /**
+     * @brief _chunkAllocations
+     * Number of chunks allocated from the heap so far.
+     */
+    size_t _chunkAllocations;
+};
+
+/**
+ * @brief The ArenaAllocator class
+ * Standard allocator, which takes memory from an arena. Deallocation is a
+ * no-op, the memory is released when the arena is reset, so containers must
+ * be destroyed or cleared before. Buffers of at least a cache line start on
+ * a cache line, smaller objects like hash map nodes are packed densely.
+ * Without an arena the heap is used.
+ */
+template< class T >
+class ArenaAllocator
+{
+public:
+
+    typedef T value_type;
+
+    /// Allocator for an arena or the heap
+    ArenaAllocator( Arena * arena = nullptr ) noexcept
+        : _arena( arena )
+    {
+        /// EMPTY
+    }
+
+    /// Rebinding constructor
+    template< class U >
+    ArenaAllocator( const ArenaAllocator< U > & other ) noexcept
+        : _arena( other.arena())
+    {
+        /// EMPTY
+    }
+
+    /// Allocate memory for n objects
+    T * allocate( const size_t n )
+    {
+        size_t const size = n * sizeof( T );
+        if( !_arena )
+        {
+            return static_cast< T * >( ::operator new( size ));
+        }
+        size_t const alignment = size >= Arena::CACHE_LINE_SIZE ? Arena::CACHE_LINE_SIZE : alignof( T );
+        return static_cast< T * >( _arena->allocate( size, alignment ));
+    }
+
+    /// Release heap memory, arena memory is released with the arena
+    void deallocate( T * pointer, const size_t ) noexcept
+    {
+        if( !_arena )
+        {
+            ::operator delete( pointer );
+        }
+    }
+
+    /// The arena, or nullptr for the heap
+    Arena * arena() const
+    {
+        return _arena;
+    }
+
+private:
+
+    Arena * _arena;
+};
+
+template< class T, class U >
+inline bool operator==( const ArenaAllocator< T > & a, const ArenaAllocator< U > & b )
+{
+    return a.arena() == b.arena();
+}
+
+template< class T, class U >
+inline bool operator!=( const ArenaAllocator< T > & a, const ArenaAllocator< U > & b )
+{
+    return a.arena() != b.arena();
+}
+
+}
+
+#endif // ARENA_H
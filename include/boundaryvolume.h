@@ -0,0 +1,121 @@
+#ifndef BOUNDARYVOLUME_H
+#define BOUNDARYVOLUME_H
+
+// C includes
+#include <cstdint>
+
+namespace dualmc
+{
+
+/**
+ * @brief The BOUNDARY_POLICY enum
+ * Values of the voxels outside of the volume.
+ */
+enum BOUNDARY_POLICY
+{
+    // No exterior voxels. Cells at the volume border are dropped, so surfaces
+    // touching the border stay open.
+    BOUNDARY_NONE = 0,
+    // Exterior voxels have a constant value, which closes surfaces at the
+    // border if the value is outside of the surface.
+    BOUNDARY_CONSTANT,
+    // Exterior voxels repeat the nearest border voxel
+    BOUNDARY_CLAMP,
+    // The volume repeats periodically. Each crossing across the wrap is
+    // emitted once and the dual points at the seam are shared, so the mesh
+    // is closed on the torus and tiled copies of it fit without overlap.
+    BOUNDARY_PERIODIC
+};
+
+/**
+ * @brief The BoundaryVolume class
+ * Volume accessor wrapping another accessor with a virtual padding of
+ * exterior voxels. The padded volume starts one voxel before the wrapped
+ * volume. It extends two voxels past its end, because the builder only
+ * visits cells up to dimension - 2. Exterior voxels are computed on access
+ * according to the boundary policy, so no padded copy of the volume is
+ * needed. All voxels of the wrapped volume have to be available at any time.
+ */
+template< class Volume >
+class BoundaryVolume
+{
+public:
+
+    /// Padding before the wrapped volume along each axis
+    static constexpr int32_t PADDING_BEGIN = 1;
+
+    /// Padding after the wrapped volume along each axis
+    static constexpr int32_t PADDING_END = 2;
+
+    /// Initializing constructor
+    BoundaryVolume( const Volume & volume,
+                    const int32_t x, const int32_t y, const int32_t z,
+                    const BOUNDARY_POLICY policy,
+                    const uint8_t exteriorValue )
+        : _volume( volume ),
+          _policy( policy ),
+          _exteriorValue( exteriorValue )
+    {
+        _dimensions[0] = x;
+        _dimensions[1] = y;
+        _dimensions[2] = z;
+    }
+
+    /// Dimension of the padded volume along an axis
+    static int32_t paddedDimension( const int32_t dimension )
+    {
+        return dimension + PADDING_BEGIN + PADDING_END;
+    }
+
+    /// The voxel value at ( x, y, z ) of the padded volume
+    uint8_t operator()( const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        int32_t coords[] = { x - PADDING_BEGIN, y - PADDING_BEGIN, z - PADDING_BEGIN };
+
+        // Interior voxels are the common case
+        if( uint32_t( coords[0] ) < uint32_t( _dimensions[0] ) &&
+            uint32_t( coords[1] ) < uint32_t( _dimensions[1] ) &&
+            uint32_t( coords[2] ) < uint32_t( _dimensions[2] ))
+        {
+            return _volume( coords[0], coords[1], coords[2] );
+        }
+
+        if( _policy == BOUNDARY_CONSTANT )
+        {
+            return _exteriorValue;
+        }
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            int32_t & c = coords[axis];
+            int32_t const dimension = _dimensions[axis];
+            if( _policy == BOUNDARY_PERIODIC )
+            {
+                c = (( c % dimension ) + dimension ) % dimension;
+            }
+            else
+            {
+                c = c < 0 ? 0 : ( c >= dimension ? dimension - 1 : c );
+            }
+        }
+        return _volume( coords[0], coords[1], coords[2] );
+    }
+
+    /// All voxels of the wrapped volume have to be available
+    void prepareLayer( const int32_t )
+    {
+        /// EMPTY
+    }
+
+private:
+
+    // Wrapped volume and its dimensions
+    const Volume & _volume;
+    int32_t _dimensions[3];
+    BOUNDARY_POLICY _policy;
+    uint8_t _exteriorValue;
+};
+
+}
+
+#endif // BOUNDARYVOLUME_H
@@ -0,0 +1,148 @@
+#include "brickedvolume.h"
+
+// C includes
+#include <cstring>
+
+// STL includes
+#include <algorithm>
+
+#include "parallel.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief BrickedVolume::BrickedVolume
+ */
+BrickedVolume::BrickedVolume()
+    : _brickSize( 0 )
+{
+    _volumeDimensions[0] = _volumeDimensions[1] = _volumeDimensions[2] = 0;
+    _numBricks[0] = _numBricks[1] = _numBricks[2] = 0;
+}
+
+/**
+ * @brief BrickedVolume::fromLinear
+ * @param volumeGrid
+ * @param x
+ * @param y
+ * @param z
+ * @param brickSize
+ * @param numThreads
+ */
+void BrickedVolume::fromLinear( const uint8_t * volumeGrid,
+                                const int32_t x, const int32_t y, const int32_t z,
+                                const int32_t brickSize,
+                                const unsigned int numThreads )
+{
+    _volumeDimensions[0] = x;
+    _volumeDimensions[1] = y;
+    _volumeDimensions[2] = z;
+    _brickSize = brickSize;
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        _numBricks[axis] = ( _volumeDimensions[axis] + brickSize - 1 ) / brickSize;
+    }
+
+    int32_t const stride = brickStride();
+    size_t const brickVoxels = size_t( stride ) * stride * stride;
+    int32_t const numBricksTotal = _numBricks[0] * _numBricks[1] * _numBricks[2];
+    _data.resize( brickVoxels * size_t( numBricksTotal ));
+
+    size_t const sliceSize = size_t( x ) * size_t( y );
+
+    // Copy each brick row by row. Apron voxels outside of the volume are
+    // clamped to the border, although the builder never reads them.
+    parallelFor( 0, numBricksTotal, [ & ]( const int32_t b )
+    {
+        int32_t const bx = b % _numBricks[0];
+        int32_t const by = ( b / _numBricks[0] ) % _numBricks[1];
+        int32_t const bz = b / ( _numBricks[0] * _numBricks[1] );
+        int32_t const originX = bx * brickSize - APRON;
+        int32_t const originY = by * brickSize - APRON;
+        int32_t const originZ = bz * brickSize - APRON;
+
+        // Voxels in x direction, which are inside of the volume
+        int32_t const beginX = std::max( originX, 0 );
+        int32_t const endX = std::min( originX + stride, x );
+
+        uint8_t * row = &_data[ brickVoxels * size_t( b ) ];
+        for( int32_t k = 0; k < stride; ++k )
+        {
+            int32_t const vz = std::min( std::max( originZ + k, 0 ), z - 1 );
+            for( int32_t j = 0; j < stride; ++j, row += stride )
+            {
+                int32_t const vy = std::min( std::max( originY + j, 0 ), y - 1 );
+                const uint8_t * const source = volumeGrid + size_t( vy ) * x + sliceSize * vz;
+
+                std::memcpy( row + ( beginX - originX ), source + beginX,
+                             size_t( endX - beginX ));
+                std::fill( row, row + ( beginX - originX ), source[0] );
+                std::fill( row + ( endX - originX ), row + stride, source[x - 1] );
+            }
+        }
+    }, numThreads );
+}
+
+/**
+ * @brief BrickedVolume::dimension
+ * @param axis
+ * @return
+ */
+int32_t BrickedVolume::dimension( const int axis ) const
+{
+    return _volumeDimensions[ axis ];
+}
+
+/**
+ * @brief BrickedVolume::brickSize
+ * @return
+ */
+int32_t BrickedVolume::brickSize() const
+{
+    return _brickSize;
+}
+
+/**
+ * @brief BrickedVolume::brickStride
+ * @return
+ */
+int32_t BrickedVolume::brickStride() const
+{
+    return _brickSize + 2 * APRON;
+}
+
+/**
+ * @brief BrickedVolume::numBricks
+ * @param axis
+ * @return
+ */
+int32_t BrickedVolume::numBricks( const int axis ) const
+{
+    return _numBricks[ axis ];
+}
+
+/**
+ * @brief BrickedVolume::brick
+ * @param bx
+ * @param by
+ * @param bz
+ * @return
+ */
+const uint8_t * BrickedVolume::brick( const int32_t bx, const int32_t by, const int32_t bz ) const
+{
+    size_t const stride = size_t( brickStride() );
+    size_t const b = size_t( bx ) + size_t( _numBricks[0] ) * ( by + size_t( _numBricks[1] ) * bz );
+    return &_data[ b * stride * stride * stride ];
+}
+
+/**
+ * @brief BrickedVolume::memorySize
+ * @return
+ */
+size_t BrickedVolume::memorySize() const
+{
+    return _data.size();
+}
+
+}
@@ -0,0 +1,188 @@
+#ifndef BRICKEDVOLUME_H
+#define BRICKEDVOLUME_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+namespace dualmc
+{
+
+/**
+ * @brief The BrickedVolume class
+ * Volume stored in cubic bricks of voxels instead of one linear array. Each
+ * brick is a small linear x-fastest block, which also contains an apron of
+ * voxels overlapping its neighbor bricks. All voxels read while processing
+ * the cells of one brick, including the manifold neighbor checks and the dual
+ * points of the adjacent lower cells, lie inside the brick and its apron.
+ * Traversing the volume brick by brick keeps the y and z neighbor accesses
+ * within a few kilobytes instead of a full row or slice apart.
+ * The apron costs memory: bricks of 16^3 voxels store 20^3 voxels, bricks of
+ * 32^3 voxels store 36^3 voxels.
+ */
+class BrickedVolume
+{
+public:
+
+    /// Overlap of the bricks with their neighbors on each side
+    static constexpr int32_t APRON = 2;
+
+    /**
+     * @brief BrickedVolume
+     * Empty volume.
+     */
+    BrickedVolume();
+
+    /**
+     * @brief fromLinear
+     * Convert a volume in linear x-fastest layout into bricks.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param brickSize
+     * Edge length of the bricks without the apron in voxels.
+     * @param numThreads
+     * Number of threads converting bricks in parallel. Zero uses all hardware
+     * threads.
+     */
+    void fromLinear( const uint8_t * volumeGrid,
+                     const int32_t x, const int32_t y, const int32_t z,
+                     const int32_t brickSize = 16,
+                     const unsigned int numThreads = 0 );
+
+    /**
+     * @brief dimension
+     * @param axis
+     * @return Volume dimension along the given axis.
+     */
+    int32_t dimension( const int axis ) const;
+
+    /**
+     * @brief brickSize
+     * @return Edge length of the bricks without the apron.
+     */
+    int32_t brickSize() const;
+
+    /**
+     * @brief brickStride
+     * @return Edge length of the stored bricks including the apron.
+     */
+    int32_t brickStride() const;
+
+    /**
+     * @brief numBricks
+     * @param axis
+     * @return Number of bricks along the given axis.
+     */
+    int32_t numBricks( const int axis ) const;
+
+    /**
+     * @brief brick
+     * Get the voxels of a brick. The first stored voxel is the voxel at
+     * ( bx, by, bz ) * brickSize - APRON.
+     * @param bx
+     * @param by
+     * @param bz
+     * @return
+     */
+    const uint8_t * brick( const int32_t bx, const int32_t by, const int32_t bz ) const;
+
+    /**
+     * @brief memorySize
+     * @return Size of the brick storage in bytes.
+     */
+    size_t memorySize() const;
+
+private:
+
+    /**
+     * @brief _volumeDimensions
+     * Dimensions of the stored volume.
+     */
+    int32_t _volumeDimensions[3];
+
+    /**
+     * @brief _brickSize
+     * Edge length of the bricks without the apron.
+     */
+    int32_t _brickSize;
+
+    /**
+     * @brief _numBricks
+     * Number of bricks along each axis.
+     */
+    int32_t _numBricks[3];
+
+    /**
+     * @brief _data
+     * Voxels of all bricks, bricks ordered x-fastest.
+     */
+    std::vector< uint8_t > _data;
+};
+
+/**
+ * @brief The BrickedVolumeAccessor class
+ * Volume accessor for a bricked volume. The builder selects the brick
+ * containing the cells it is going to process. Voxel accesses are only valid
+ * within the selected brick and its apron.
+ */
+class BrickedVolumeAccessor
+{
+public:
+
+    /// Initializing constructor
+    explicit BrickedVolumeAccessor( const BrickedVolume & volume )
+        : _volume( volume ),
+          _brick( nullptr ),
+          _stride( size_t( volume.brickStride() )),
+          _sliceSize( _stride * _stride ),
+          _originOffset( 0 )
+    {
+        /// EMPTY
+    }
+
+    /// The bricked volume
+    const BrickedVolume & volume() const
+    {
+        return _volume;
+    }
+
+    /// Select the brick for subsequent voxel accesses
+    void selectBrick( const int32_t bx, const int32_t by, const int32_t bz )
+    {
+        int32_t const brickSize = _volume.brickSize();
+        _brick = _volume.brick( bx, by, bz );
+        _originOffset = ( bx * brickSize - BrickedVolume::APRON ) +
+                        ( by * brickSize - BrickedVolume::APRON ) * ptrdiff_t( _stride ) +
+                        ( bz * brickSize - BrickedVolume::APRON ) * ptrdiff_t( _sliceSize );
+    }
+
+    /// The voxel value at ( x, y, z )
+    uint8_t operator()( const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        return _brick[ x + ptrdiff_t( _stride ) * y + ptrdiff_t( _sliceSize ) * z - _originOffset ];
+    }
+
+    /// All voxels are always available
+    void prepareLayer( const int32_t )
+    {
+        /// EMPTY
+    }
+
+private:
+
+    // Bricked volume, selected brick and its strides
+    const BrickedVolume & _volume;
+    const uint8_t * _brick;
+    size_t _stride;
+    size_t _sliceSize;
+    ptrdiff_t _originOffset;
+};
+
+}
+
+#endif // BRICKEDVOLUME_H
@@ -0,0 +1,139 @@
+#include "brickmesh.h"
+
+// STL includes
+#include <unordered_map>
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Identifier at the beginning of a serialized brick mesh
+const uint32_t BRICK_MESH_MAGIC = 0x42434d44;
+
+/// Version of the serialized brick mesh format
+const uint32_t BRICK_MESH_VERSION = 1;
+
+/// Write the elements of a vector
+template< class T >
+void writeArray( std::ostream & stream, const std::vector< T > & array )
+{
+    if( !array.empty())
+    {
+        stream.write( reinterpret_cast< const char * >( array.data()),
+                      std::streamsize( array.size() * sizeof( T )));
+    }
+}
+
+/// Read the given number of elements into a vector
+template< class T >
+bool readArray( std::istream & stream, const uint64_t size, std::vector< T > & array )
+{
+    array.resize( size_t( size ));
+    if( !array.empty())
+    {
+        stream.read( reinterpret_cast< char * >( array.data()),
+                     std::streamsize( array.size() * sizeof( T )));
+    }
+    return bool( stream );
+}
+
+}
+
+/**
+ * @brief writeBrickMesh
+ * @param stream
+ * @param mesh
+ * @return
+ */
+bool writeBrickMesh( std::ostream & stream, const BrickMesh & mesh )
+{
+    uint32_t const header[] = { BRICK_MESH_MAGIC, BRICK_MESH_VERSION };
+    uint64_t const sizes[] = { mesh.vertices.size(), mesh.quads.size() };
+    stream.write( reinterpret_cast< const char * >( header ), sizeof( header ));
+    stream.write( reinterpret_cast< const char * >( sizes ), sizeof( sizes ));
+    writeArray( stream, mesh.vertices );
+    writeArray( stream, mesh.keys );
+    writeArray( stream, mesh.quads );
+    return bool( stream );
+}
+
+/**
+ * @brief readBrickMesh
+ * @param stream
+ * @param mesh
+ * @return
+ */
+bool readBrickMesh( std::istream & stream, BrickMesh & mesh )
+{
+    mesh.clear();
+
+    uint32_t header[2];
+    uint64_t sizes[2];
+    stream.read( reinterpret_cast< char * >( header ), sizeof( header ));
+    stream.read( reinterpret_cast< char * >( sizes ), sizeof( sizes ));
+    if( !stream || header[0] != BRICK_MESH_MAGIC || header[1] != BRICK_MESH_VERSION )
+    {
+        return false;
+    }
+
+    if( !readArray( stream, sizes[0], mesh.vertices ) ||
+            !readArray( stream, sizes[0], mesh.keys ) ||
+            !readArray( stream, sizes[1], mesh.quads ))
+    {
+        mesh.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief stitchBrickMeshes
+ * @param bricks
+ * @param vertices
+ * @param quads
+ */
+void stitchBrickMeshes( const std::vector< BrickMesh > & bricks,
+                        std::vector< Vertex > & vertices,
+                        std::vector< Quad > & quads )
+{
+    vertices.clear();
+    quads.clear();
+
+    size_t numVertices = 0;
+    size_t numQuads = 0;
+    for( const BrickMesh & brick : bricks )
+    {
+        numVertices += brick.vertices.size();
+        numQuads += brick.quads.size();
+    }
+    vertices.reserve( numVertices );
+    quads.reserve( numQuads );
+
+    // Merge the vertices of all bricks by their global key
+    std::unordered_map< uint64_t, int32_t > keyToIndex;
+    keyToIndex.reserve( numVertices );
+    std::vector< int32_t > brickToGlobal;
+    for( const BrickMesh & brick : bricks )
+    {
+        brickToGlobal.resize( brick.vertices.size());
+        for( size_t v = 0; v < brick.vertices.size(); ++v )
+        {
+            auto const inserted = keyToIndex.emplace( brick.keys[v], int32_t( vertices.size()));
+            if( inserted.second )
+            {
+                vertices.emplace_back( brick.vertices[v] );
+            }
+            brickToGlobal[v] = inserted.first->second;
+        }
+
+        for( const Quad & quad : brick.quads )
+        {
+            quads.emplace_back( brickToGlobal[ quad.i0 ], brickToGlobal[ quad.i1 ],
+                                brickToGlobal[ quad.i2 ], brickToGlobal[ quad.i3 ]);
+        }
+    }
+}
+
+}
@@ -0,0 +1,98 @@
+#ifndef BRICKMESH_H
+#define BRICKMESH_H
+
+// C includes
+#include <cstdint>
+
+// STL includes
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "quad.h"
+#include "vertex.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief globalDualPointKey
+ * Globally unique key of a dual point. A dual point is identified by its
+ * cell and its 12-bit point code like in the shared vertex lookup of the
+ * builder, but the cell index is linearized with the dimensions of the full
+ * volume. Keys therefore agree between bricks of a partition and do not
+ * depend on the order of extraction.
+ * @param cell
+ * Linearized index of the cell in the full volume.
+ * @param pointCode
+ * @return
+ */
+inline uint64_t globalDualPointKey( const uint64_t cell, const int pointCode )
+{
+    return ( cell << 12 ) | uint64_t( pointCode );
+}
+
+/**
+ * @brief The BrickMesh struct
+ * Mesh of one brick of a BrickPartition. Vertices are in the coordinates of
+ * the full volume and carry their global dual point key. Dual points on the
+ * border between bricks appear in the meshes of all adjacent bricks with
+ * the same key and bitwise identical position.
+ */
+struct BrickMesh
+{
+    /// Remove all vertices and quads
+    void clear()
+    {
+        vertices.clear();
+        keys.clear();
+        quads.clear();
+    }
+
+    /// Vertices in volume coordinates
+    std::vector< Vertex > vertices;
+
+    /// Global dual point key of each vertex
+    std::vector< uint64_t > keys;
+
+    /// Quads with brick local vertex indices
+    std::vector< Quad > quads;
+};
+
+/**
+ * @brief writeBrickMesh
+ * Write a brick mesh in a binary format for exchange between processes on
+ * the same machine.
+ * @param stream
+ * @param mesh
+ * @return True, if the mesh was written successfully.
+ */
+bool writeBrickMesh( std::ostream & stream, const BrickMesh & mesh );
+
+/**
+ * @brief readBrickMesh
+ * Read a brick mesh written by writeBrickMesh.
+ * @param stream
+ * @param mesh
+ * @return True, if a valid mesh was read.
+ */
+bool readBrickMesh( std::istream & stream, BrickMesh & mesh );
+
+/**
+ * @brief stitchBrickMeshes
+ * Merge brick meshes into one indexed mesh. Vertices with the same global
+ * key are merged, so the mesh is watertight across brick borders and equals
+ * the mesh of the full build up to the order of vertices and quads.
+ * Vertices are numbered by their first occurrence in brick order, so the
+ * result is deterministic.
+ * @param bricks
+ * @param vertices
+ * @param quads
+ */
+void stitchBrickMeshes( const std::vector< BrickMesh > & bricks,
+                        std::vector< Vertex > & vertices,
+                        std::vector< Quad > & quads );
+
+}
+
+#endif // BRICKMESH_H
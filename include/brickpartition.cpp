@@ -0,0 +1,142 @@
+#include "brickpartition.h"
+
+// C includes
+#include <cstring>
+
+// STL includes
+#include <algorithm>
+
+namespace dualmc
+{
+
+/**
+ * @brief BrickPartition::BrickPartition
+ */
+BrickPartition::BrickPartition()
+{
+    _volumeDimensions[0] = _volumeDimensions[1] = _volumeDimensions[2] = 0;
+    _numBricks[0] = _numBricks[1] = _numBricks[2] = 0;
+}
+
+/**
+ * @brief BrickPartition::BrickPartition
+ * @param x
+ * @param y
+ * @param z
+ * @param bricksX
+ * @param bricksY
+ * @param bricksZ
+ */
+BrickPartition::BrickPartition( const int32_t x, const int32_t y, const int32_t z,
+                                const int32_t bricksX, const int32_t bricksY, const int32_t bricksZ )
+{
+    _volumeDimensions[0] = x;
+    _volumeDimensions[1] = y;
+    _volumeDimensions[2] = z;
+    _numBricks[0] = std::max( bricksX, 1 );
+    _numBricks[1] = std::max( bricksY, 1 );
+    _numBricks[2] = std::max( bricksZ, 1 );
+}
+
+/**
+ * @brief BrickPartition::dimension
+ * @param axis
+ * @return
+ */
+int32_t BrickPartition::dimension( const int axis ) const
+{
+    return _volumeDimensions[ axis ];
+}
+
+/**
+ * @brief BrickPartition::numBricks
+ * @return
+ */
+int32_t BrickPartition::numBricks() const
+{
+    return _numBricks[0] * _numBricks[1] * _numBricks[2];
+}
+
+/**
+ * @brief BrickPartition::cellRange
+ * @param brick
+ * @param begin
+ * @param end
+ */
+void BrickPartition::cellRange( const int32_t brick, int32_t begin[3], int32_t end[3] ) const
+{
+    int32_t coordinates[3];
+    _brickCoordinates( brick, coordinates );
+
+    // Split the cells visited by the full build evenly
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        int64_t const cells = std::max( _volumeDimensions[ axis ] - 2, 0 );
+        begin[ axis ] = int32_t( cells * coordinates[ axis ] / _numBricks[ axis ]);
+        end[ axis ] = int32_t( cells * ( coordinates[ axis ] + 1 ) / _numBricks[ axis ]);
+    }
+}
+
+/**
+ * @brief BrickPartition::dataRange
+ * @param brick
+ * @param offset
+ * @param extent
+ */
+void BrickPartition::dataRange( const int32_t brick, int32_t offset[3], int32_t extent[3] ) const
+{
+    int32_t begin[3], end[3];
+    cellRange( brick, begin, end );
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        offset[ axis ] = std::max( begin[ axis ] - GHOST, 0 );
+        extent[ axis ] = std::min( end[ axis ] + GHOST, _volumeDimensions[ axis ]) - offset[ axis ];
+    }
+}
+
+/**
+ * @brief BrickPartition::copyBrickData
+ * @param volumeGrid
+ * @param brick
+ * @param data
+ */
+void BrickPartition::copyBrickData( const uint8_t * volumeGrid, const int32_t brick,
+                                    std::vector< uint8_t > & data ) const
+{
+    int32_t offset[3], extent[3];
+    dataRange( brick, offset, extent );
+    data.resize( size_t( extent[0] ) * size_t( extent[1] ) * size_t( extent[2] ));
+    if( data.empty())
+    {
+        return;
+    }
+
+    // Copy row by row
+    size_t const sliceSize = size_t( _volumeDimensions[0] ) * size_t( _volumeDimensions[1] );
+    for( int32_t z = 0; z < extent[2]; ++z )
+    {
+        for( int32_t y = 0; y < extent[1]; ++y )
+        {
+            const uint8_t * const source = volumeGrid + size_t( offset[0] ) +
+                    size_t( _volumeDimensions[0] ) * size_t( offset[1] + y ) +
+                    sliceSize * size_t( offset[2] + z );
+            uint8_t * const target = &data[ size_t( extent[0] ) *
+                    ( size_t( y ) + size_t( extent[1] ) * size_t( z ))];
+            std::memcpy( target, source, size_t( extent[0] ));
+        }
+    }
+}
+
+/**
+ * @brief BrickPartition::_brickCoordinates
+ * @param brick
+ * @param coordinates
+ */
+void BrickPartition::_brickCoordinates( const int32_t brick, int32_t coordinates[3] ) const
+{
+    coordinates[0] = brick % _numBricks[0];
+    coordinates[1] = ( brick / _numBricks[0] ) % _numBricks[1];
+    coordinates[2] = brick / ( _numBricks[0] * _numBricks[1] );
+}
+
+}
@@ -0,0 +1,114 @@
+#ifndef BRICKPARTITION_H
+#define BRICKPARTITION_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+namespace dualmc
+{
+
+/**
+ * @brief The BrickPartition class
+ * Partition of a volume into a grid of bricks, which can be meshed
+ * independently, for example by separate worker processes. Each brick owns
+ * a box of cells, whose edges it turns into quads, so every quad of the full
+ * mesh is generated by exactly one brick. The voxels of a brick are its
+ * cells extended by a ghost layer, which covers the dual points of the
+ * adjacent cells and their manifold neighbor checks. The ghost layer is
+ * clipped at the volume border.
+ */
+class BrickPartition
+{
+public:
+
+    /// Ghost voxels around the cells of a brick on each side
+    static constexpr int32_t GHOST = 2;
+
+    /// Empty partition
+    BrickPartition();
+
+    /**
+     * @brief BrickPartition
+     * Split a volume evenly into a grid of bricks.
+     * @param x
+     * @param y
+     * @param z
+     * Volume dimensions.
+     * @param bricksX
+     * @param bricksY
+     * @param bricksZ
+     * Number of bricks along each axis.
+     */
+    BrickPartition( const int32_t x, const int32_t y, const int32_t z,
+                    const int32_t bricksX, const int32_t bricksY, const int32_t bricksZ );
+
+    /// Volume dimension along an axis
+    int32_t dimension( const int axis ) const;
+
+    /// Total number of bricks, ordered x-fastest
+    int32_t numBricks() const;
+
+    /**
+     * @brief cellRange
+     * Get the cells [begin, end) owned by a brick in volume coordinates.
+     * @param brick
+     * @param begin
+     * @param end
+     */
+    void cellRange( const int32_t brick, int32_t begin[3], int32_t end[3] ) const;
+
+    /**
+     * @brief dataRange
+     * Get the voxels needed for meshing a brick, its cells with the ghost
+     * layer, in volume coordinates.
+     * @param brick
+     * @param offset
+     * First voxel.
+     * @param extent
+     * Number of voxels along each axis.
+     */
+    void dataRange( const int32_t brick, int32_t offset[3], int32_t extent[3] ) const;
+
+    /**
+     * @brief copyBrickData
+     * Copy the voxels of a brick out of the full linear x-fastest volume
+     * into a linear x-fastest block of the data range.
+     * @param volumeGrid
+     * @param brick
+     * @param data
+     */
+    void copyBrickData( const uint8_t * volumeGrid, const int32_t brick,
+                        std::vector< uint8_t > & data ) const;
+
+private:
+
+    /**
+     * @brief _brickCoordinates
+     * Position of a brick in the grid of bricks.
+     * @param brick
+     * @param coordinates
+     */
+    void _brickCoordinates( const int32_t brick, int32_t coordinates[3] ) const;
+
+private:
+
+    /**
+     * @brief _volumeDimensions
+     * Volume dimensions.
+     */
+    int32_t _volumeDimensions[3];
+
+    /**
+     * @brief _numBricks
+     * Number of bricks along each axis.
+     */
+    int32_t _numBricks[3];
+};
+
+}
+
+#endif // BRICKPARTITION_H
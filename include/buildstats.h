@@ -0,0 +1,102 @@
+#ifndef BUILDSTATS_H
+#define BUILDSTATS_H
+
+// c includes
+#include <cstdint>
+
+// Build statistics are only gathered if DUALMC_ENABLE_STATS is defined.
+// Otherwise all counter updates and phase timers compile out entirely.
+#ifdef DUALMC_ENABLE_STATS
+#define DUALMC_STAT( statement ) statement
+#else
+#define DUALMC_STAT( statement )
+#endif
+
+namespace dualmc
+{
+
+/**
+ * @brief The BUILD_PHASE enum
+ * Phases of a single build call, which are timed separately.
+ */
+enum BUILD_PHASE
+{
+    PHASE_SETUP = 0,
+    PHASE_CELL_QUERY,
+    PHASE_SAMPLING,
+    PHASE_EXTRACTION,
+    PHASE_INDEXING,
+    NUM_BUILD_PHASES
+};
+
+/// Statistics and hot path counters gathered during a build
+struct BuildStats
+{
+    /// Are the counters compiled into the builder?
+#ifdef DUALMC_ENABLE_STATS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    /// Initializing constructor
+    BuildStats()
+    {
+        reset();
+    }
+
+    /// Reset all counters and timers to zero
+    void reset()
+    {
+        cellsVisited = 0;
+        crossingEdges[0] = crossingEdges[1] = crossingEdges[2] = 0;
+        quadsEmitted = 0;
+        pointLookups = 0;
+        pointLookupHits = 0;
+        manifoldInversions = 0;
+        for( int i = 0; i < NUM_BUILD_PHASES; ++i )
+            phaseTimes[i] = 0.0;
+    }
+
+    /// Fraction of shared dual point lookups, which found an existing vertex
+    double pointLookupHitRate() const
+    {
+        return pointLookups == 0 ? 0.0 : double( pointLookupHits ) / double( pointLookups );
+    }
+
+    /// Name of a build phase for printing
+    static char const * phaseName( BUILD_PHASE const phase )
+    {
+        static char const * const names[NUM_BUILD_PHASES] =
+        {
+            "setup", "cell query", "sampling", "extraction", "indexing"
+        };
+        return names[phase];
+    }
+
+    // Number of visited voxels, which are base voxels for up to three edges
+    uint64_t cellsVisited;
+
+    // Number of edges intersecting the iso surface in x, y and z direction
+    uint64_t crossingEdges[3];
+
+    // Number of generated quads
+    uint64_t quadsEmitted;
+
+    // Number of shared dual point lookups and the number of those finding an
+    // already computed dual point
+    uint64_t pointLookups;
+    uint64_t pointLookupHits;
+
+    // Number of dual point code lookups in cells, whose cube code was inverted
+    // by the manifold dual marching cubes approach. A cell is counted once per
+    // lookup, so up to four times per quad.
+    uint64_t manifoldInversions;
+
+    // Wall time in seconds for each build phase
+    double phaseTimes[NUM_BUILD_PHASES];
+};
+
+}
+
+#endif // BUILDSTATS_H
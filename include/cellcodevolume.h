@@ -0,0 +1,281 @@
+#ifndef CELLCODEVOLUME_H
+#define CELLCODEVOLUME_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "cpudispatch.h"
+#include "tables.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief resolveManifoldCode
+ * The Manifold Dual Marching Cubes approach from Rephael Wenger as described
+ * in chapter 3.3.5 of his book "Isosurfaces: Geometry, Topology, and
+ * Algorithms". If a problematic C16 or C19 configuration shares the
+ * ambiguous face with another C16 or C19 configuration, the cube code is
+ * inverted before looking up dual points.
+ * Doing this for these pairs ensures manifold meshes.
+ * But this removes the dualism to marching cubes.
+ * @param cubeCode
+ * @param x
+ * @param y
+ * @param z
+ * @param dimensions
+ * Volume dimensions.
+ * @param cellCode
+ * Function returning the cube code of the cell at ( x, y, z ).
+ * @return The effective cube code.
+ */
+template< class CellCodeFunction >
+inline int resolveManifoldCode( const int cubeCode,
+                                const int32_t x, const int32_t y, const int32_t z,
+                                const int32_t dimensions[3],
+                                const CellCodeFunction & cellCode )
+{
+    // Check if we have a potentially problematic configuration. If the
+    // direction code is in {0,...,5} we have a C16 or C19 configuration.
+    const uint8_t direction = problematicConfigs[ uint8_t( cubeCode ) ];
+    if( direction == 255 )
+    {
+        return cubeCode;
+    }
+
+    // We have to check the neighboring cube, which shares the ambiguous
+    // face. Decode the axis and sign of the direction.
+    int32_t neighborCoords[] = { x, y, z };
+    unsigned int const component = direction >> 1;
+    neighborCoords[component] += ( direction & 1 ) == 1 ? 1 : -1;
+
+    // Have we left the volume in this direction?
+    if( neighborCoords[component] < 0 ||
+        neighborCoords[component] >= ( dimensions[component] - 1 ))
+    {
+        return cubeCode;
+    }
+
+    // As C16 and C19 have exactly one ambiguous face, this face is
+    // guaranteed to be shared for a problematic pair.
+    int const neighborCubeCode = cellCode( neighborCoords[0],
+                                           neighborCoords[1],
+                                           neighborCoords[2] );
+    if( problematicConfigs[ uint8_t( neighborCubeCode ) ] != 255 )
+    {
+        return cubeCode ^ 0xff;
+    }
+    return cubeCode;
+}
+
+/**
+ * @brief The HasVoxelRows struct
+ * Whether a volume accessor provides its contiguous voxel rows through
+ * row( y, z ), which the vectorized kernels read directly.
+ */
+template< class Volume, class = void >
+struct HasVoxelRows : std::false_type
+{
+};
+
+template< class Volume >
+struct HasVoxelRows< Volume, decltype( void( std::declval< const Volume & >().row( 0, 0 ))) >
+    : std::true_type
+{
+};
+
+/**
+ * @brief The CellCodeVolume class
+ * Volume accessor wrapping another accessor, which additionally provides the
+ * effective cube codes of the cells. When the builder prepares voxel layer z,
+ * the cube codes of a cell plane are computed once, reading each voxel once
+ * per plane, and the manifold fix-up is resolved once per cell. The builder
+ * then looks up the codes of the cells in the layers z - 1 and z instead of
+ * recomputing them for every dual point. Volumes with contiguous voxel rows
+ * are classified by the vectorized kernel of the running CPU. The cell
+ * planes can be taken from the scratch arena of the builder.
+ * Requires voxel layers to be prepared in ascending order.
+ */
+template< class Volume >
+class CellCodeVolume
+{
+public:
+
+    /// Initializing constructor
+    CellCodeVolume( Volume & volume,
+                    const int32_t x, const int32_t y, const int32_t z,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    Arena * arena = nullptr )
+        : _volume( volume ),
+          _isoValue( isoValue ),
+          _generateManifold( generateManifold ),
+          _planeWidth( std::max( x - 1, 0 )),
+          _planeSize( size_t( _planeWidth ) * size_t( std::max( y - 1, 0 ))),
+          _rawCodes( ArenaAllocator< uint8_t >( arena )),
+          _cellCodes( ArenaAllocator< uint8_t >( arena )),
+          _columns( ArenaAllocator< uint8_t >( arena )),
+          _nextRawPlane( 0 ),
+          _nextCodePlane( 0 )
+    {
+        _dimensions[0] = x;
+        _dimensions[1] = y;
+        _dimensions[2] = z;
+        _rawCodes.resize( RAW_RING_SIZE * _planeSize );
+        _cellCodes.resize( CODE_RING_SIZE * _planeSize );
+        _columns.resize( size_t( std::max( x, 0 )));
+    }
+
+    /// The voxel value at ( x, y, z )
+    uint8_t operator()( const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        return _volume( x, y, z );
+    }
+
+    /// The effective cube code of the cell at ( x, y, z ) in one of the
+    /// last two prepared layers
+    int cellCode( const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        return _cellCodes[ _planeIndex( x, y, z & CODE_RING_MASK ) ];
+    }
+
+    /// The plain cube code of the cell at ( x, y, z ) in the last prepared
+    /// layer, without the manifold fix-up
+    int rawCellCode( const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        return _rawCodes[ _planeIndex( x, y, z & RAW_RING_MASK ) ];
+    }
+
+    /// Prepare the wrapped volume and compute the cube codes of layer z
+    void prepareLayer( const int32_t z )
+    {
+        _volume.prepareLayer( z );
+
+        // The manifold fix-up looks at the neighbors in layer z + 1
+        int32_t const lastRawPlane = std::min( z + 1, _dimensions[2] - 2 );
+        while( _nextRawPlane <= lastRawPlane )
+        {
+            _fillRawPlane( _nextRawPlane++, HasVoxelRows< Volume >());
+        }
+
+        // A sweep starting above the first layer also looks up layer z - 1
+        for( int32_t plane = std::max( _nextCodePlane, z - 1 ); plane <= z; ++plane )
+        {
+            _fillCellCodePlane( plane );
+        }
+        _nextCodePlane = z + 1;
+    }
+
+private:
+
+    /// Linear index into a ring of cell planes
+    size_t _planeIndex( const int32_t x, const int32_t y, const int32_t slot ) const
+    {
+        return size_t( x ) + size_t( _planeWidth ) * size_t( y ) + _planeSize * size_t( slot );
+    }
+
+    /// Compute the plain cube codes of cell layer z from voxel rows
+    void _fillRawPlane( const int32_t z, std::true_type )
+    {
+        int32_t const height = _dimensions[1] - 1;
+        for( int32_t y = 0; y < height; ++y )
+        {
+            const uint8_t * const rows[] =
+            {
+                _volume.row( y, z ), _volume.row( y + 1, z ),
+                _volume.row( y, z + 1 ), _volume.row( y + 1, z + 1 )
+            };
+            classifyCellRow( rows, _dimensions[0], _isoValue, _columns.data(),
+                             &_rawCodes[ _planeIndex( 0, y, z & RAW_RING_MASK ) ] );
+        }
+    }
+
+    /// Compute the plain cube codes of cell layer z
+    void _fillRawPlane( const int32_t z, std::false_type )
+    {
+        int32_t const height = _dimensions[1] - 1;
+        for( int32_t y = 0; y < height; ++y )
+        {
+            // Gather the inside bits of the four voxels in each column of
+            // the cell row at their corner bit positions of the lower cell
+            for( int32_t x = 0; x < _dimensions[0]; ++x )
+            {
+                _columns[x] = uint8_t(
+                        ( _volume( x, y, z ) >= _isoValue ? 1 : 0 ) |
+                        ( _volume( x, y + 1, z ) >= _isoValue ? 4 : 0 ) |
+                        ( _volume( x, y, z + 1 ) >= _isoValue ? 16 : 0 ) |
+                        ( _volume( x, y + 1, z + 1 ) >= _isoValue ? 64 : 0 ));
+            }
+
+            // Cells combine their lower and upper column
+            uint8_t * const codes = &_rawCodes[ _planeIndex( 0, y, z & RAW_RING_MASK ) ];
+            for( int32_t x = 0; x < _planeWidth; ++x )
+            {
+                codes[x] = uint8_t( _columns[x] | ( _columns[x + 1] << 1 ));
+            }
+        }
+    }
+
+    /// Compute the effective cube codes of cell layer z
+    void _fillCellCodePlane( const int32_t z )
+    {
+        const uint8_t * const rawCodes = &_rawCodes[ _planeIndex( 0, 0, z & RAW_RING_MASK ) ];
+        uint8_t * const cellCodes = &_cellCodes[ _planeIndex( 0, 0, z & CODE_RING_MASK ) ];
+        std::copy( rawCodes, rawCodes + _planeSize, cellCodes );
+        if( !_generateManifold )
+        {
+            return;
+        }
+
+        auto rawCode = [ this ]( const int32_t x, const int32_t y, const int32_t z )
+        {
+            return int( _rawCodes[ _planeIndex( x, y, z & RAW_RING_MASK ) ] );
+        };
+
+        // Only the rare C16 and C19 configurations need their neighbor
+        for( size_t i = 0; i < _planeSize; ++i )
+        {
+            if( problematicConfigs[ rawCodes[i] ] == 255 )
+            {
+                continue;
+            }
+
+            int32_t const x = int32_t( i % size_t( _planeWidth ));
+            int32_t const y = int32_t( i / size_t( _planeWidth ));
+            int const code = resolveManifoldCode( rawCodes[i], x, y, z,
+                                                  _dimensions, rawCode );
+            cellCodes[i] = uint8_t( code );
+        }
+    }
+
+    // Cell layers z - 1, z and z + 1 are needed for resolving layer z.
+    // Effective codes are looked up for layers z - 1 and z.
+    static constexpr int32_t RAW_RING_SIZE = 4;
+    static constexpr int32_t RAW_RING_MASK = RAW_RING_SIZE - 1;
+    static constexpr int32_t CODE_RING_SIZE = 2;
+    static constexpr int32_t CODE_RING_MASK = CODE_RING_SIZE - 1;
+
+    Volume & _volume;
+    int32_t _dimensions[3];
+    uint8_t _isoValue;
+    bool _generateManifold;
+    int32_t _planeWidth;
+    size_t _planeSize;
+    std::vector< uint8_t, ArenaAllocator< uint8_t > > _rawCodes;
+    std::vector< uint8_t, ArenaAllocator< uint8_t > > _cellCodes;
+    std::vector< uint8_t, ArenaAllocator< uint8_t > > _columns;
+    int32_t _nextRawPlane;
+    int32_t _nextCodePlane;
+};
+
+}
+
+#endif // CELLCODEVOLUME_H
@@ -0,0 +1,60 @@
+#include "compactvertex.h"
+
+// STL includes
+#include <algorithm>
+
+#include "parallel.h"
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Number of vertices decoded per parallel task
+const int32_t VERTICES_PER_TASK = 1 << 16;
+
+}
+
+/**
+ * @brief decodeVertices
+ * @param compactVertices
+ * @param x
+ * @param y
+ * @param vertices
+ * @param numThreads
+ */
+void decodeVertices( const std::vector< CompactVertex > & compactVertices,
+                     const int32_t x, const int32_t y,
+                     std::vector< Vertex > & vertices,
+                     const unsigned int numThreads )
+{
+    vertices.resize( compactVertices.size());
+
+    uint64_t const row = uint64_t( x );
+    uint64_t const slice = uint64_t( x ) * uint64_t( y );
+    float const scale = 1.0f / float( CompactVertex::OFFSET_MAX );
+    size_t const numVertices = compactVertices.size();
+    int32_t const numTasks = int32_t(( numVertices + VERTICES_PER_TASK - 1 ) / VERTICES_PER_TASK );
+    parallelFor( 0, numTasks, [ & ]( const int32_t task )
+    {
+        size_t const begin = size_t( task ) * VERTICES_PER_TASK;
+        size_t const end = std::min( begin + VERTICES_PER_TASK, numVertices );
+        for( size_t i = begin; i < end; ++i )
+        {
+            CompactVertex const compact = compactVertices[i];
+            uint64_t const cell = compact.cell();
+            uint64_t const cz = cell / slice;
+            uint64_t const inSlice = cell - cz * slice;
+            uint64_t const cy = inSlice / row;
+            uint64_t const cx = inSlice - cy * row;
+
+            Vertex & vertex = vertices[i];
+            vertex.x = float( cx ) + float( compact.offset( 0 )) * scale;
+            vertex.y = float( cy ) + float( compact.offset( 1 )) * scale;
+            vertex.z = float( cz ) + float( compact.offset( 2 )) * scale;
+        }
+    }, numThreads );
+}
+
+}
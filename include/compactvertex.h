@@ -0,0 +1,91 @@
+#ifndef COMPACTVERTEX_H
+#define COMPACTVERTEX_H
+
+// C includes
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+#include "vertex.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief The CompactVertex struct
+ * Dual point packed into 64 bits. A dual point always lies inside of its
+ * cell, so it is stored as the linearized index of the cell together with its
+ * offset inside of the cell, quantized to 8 bits per axis. The quantization
+ * error is at most 1 / 510 voxels along each axis. The cell index is
+ * linearized with the volume dimensions and supports up to 2^40 voxels.
+ */
+struct CompactVertex
+{
+    /// Number of bits of the linearized cell index
+    static constexpr int CELL_BITS = 40;
+
+    /// Number of bits of the offset along each axis
+    static constexpr int OFFSET_BITS = 8;
+
+    /// Quantized offset of the far side of the cell
+    static constexpr uint32_t OFFSET_MAX = ( 1u << OFFSET_BITS ) - 1;
+
+    /// Non-initializing constructor
+    CompactVertex()
+    {
+        /// EMPTY
+    }
+
+    /// Encode the offset ( x, y, z ) in [0,1]^3 inside the given cell
+    CompactVertex( uint64_t const cell, float const x, float const y, float const z )
+        : code( cell | ( uint64_t( quantize( x )) << CELL_BITS ) |
+                ( uint64_t( quantize( y )) << ( CELL_BITS + OFFSET_BITS )) |
+                ( uint64_t( quantize( z )) << ( CELL_BITS + 2 * OFFSET_BITS )))
+    {
+        /// EMPTY
+    }
+
+    /// Linearized index of the cell
+    uint64_t cell() const
+    {
+        return code & (( uint64_t( 1 ) << CELL_BITS ) - 1 );
+    }
+
+    /// Quantized offset inside the cell along an axis
+    uint32_t offset( int const axis ) const
+    {
+        return uint32_t( code >> ( CELL_BITS + axis * OFFSET_BITS )) & OFFSET_MAX;
+    }
+
+    /// Quantize an offset in [0,1]
+    static uint32_t quantize( float const offset )
+    {
+        float const scaled = offset * float( OFFSET_MAX ) + 0.5f;
+        return scaled <= 0.0f ? 0 :
+                ( scaled >= float( OFFSET_MAX ) ? OFFSET_MAX : uint32_t( scaled ));
+    }
+
+    // Cell index in the lower bits, x, y and z offsets above
+    uint64_t code;
+};
+
+/**
+ * @brief decodeVertices
+ * Decode compact vertices into vertices in voxel coordinates.
+ * @param compactVertices
+ * @param x
+ * @param y
+ * Volume dimensions used for linearizing the cell indices.
+ * @param vertices
+ * @param numThreads
+ * Number of threads decoding in parallel, zero uses all hardware threads.
+ */
+void decodeVertices( const std::vector< CompactVertex > & compactVertices,
+                     const int32_t x, const int32_t y,
+                     std::vector< Vertex > & vertices,
+                     const unsigned int numThreads = 0 );
+
+}
+
+#endif // COMPACTVERTEX_H
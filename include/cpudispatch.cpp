@@ -0,0 +1,265 @@
+#include "cpudispatch.h"
+
+// C includes
+#include <cstdlib>
+#include <cstring>
+
+// STL includes
+#include <algorithm>
+
+// Kernels for higher instruction set levels are compiled with function
+// target attributes, which GCC and Clang support on x86
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ))
+#define DUALMC_CPU_DISPATCH 1
+#define DUALMC_KERNEL_BODY inline __attribute__(( always_inline ))
+#define DUALMC_TARGET_AVX2 __attribute__(( target( "avx2" )))
+#define DUALMC_TARGET_AVX512 __attribute__(( target( "avx512f,avx512bw" )))
+#else
+#define DUALMC_CPU_DISPATCH 0
+#define DUALMC_KERNEL_BODY inline
+#endif
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Names of the instruction set levels by CPU_PATH
+const char * const CPU_PATH_NAMES[] = { "generic", "avx2", "avx512" };
+
+/// Signatures of the dispatched kernels
+typedef void ( *ClassifyCellRowKernel )( const uint8_t * const [4], int32_t, uint8_t, uint8_t *, uint8_t * );
+typedef void ( *ExtendRowRangeKernel )( const uint8_t *, size_t, uint8_t &, uint8_t & );
+
+/// Kernels of the selected instruction set level
+struct Kernels
+{
+    ClassifyCellRowKernel classifyCellRow;
+    ExtendRowRangeKernel extendRowRange;
+};
+
+/**
+ * @brief classifyCellRowBody
+ * Shared body of the classification kernels, which is inlined and
+ * vectorized for each instruction set level.
+ * @param rows
+ * @param numVoxels
+ * @param isoValue
+ * @param columns
+ * @param codes
+ */
+DUALMC_KERNEL_BODY void classifyCellRowBody( const uint8_t * const rows[4],
+                                             const int32_t numVoxels,
+                                             const uint8_t isoValue,
+                                             uint8_t * __restrict columns,
+                                             uint8_t * __restrict codes )
+{
+    // Gather the inside bits of the four voxels in each column of the cell
+    // row at their corner bit positions of the lower cell
+    const uint8_t * __restrict const row00 = rows[0];
+    const uint8_t * __restrict const row10 = rows[1];
+    const uint8_t * __restrict const row01 = rows[2];
+    const uint8_t * __restrict const row11 = rows[3];
+    for( int32_t x = 0; x < numVoxels; ++x )
+    {
+        columns[x] = uint8_t(
+                ( row00[x] >= isoValue ? 1 : 0 ) |
+                ( row10[x] >= isoValue ? 4 : 0 ) |
+                ( row01[x] >= isoValue ? 16 : 0 ) |
+                ( row11[x] >= isoValue ? 64 : 0 ));
+    }
+
+    // Cells combine their lower and upper column
+    for( int32_t x = 0; x + 1 < numVoxels; ++x )
+    {
+        codes[x] = uint8_t( columns[x] | ( columns[x + 1] << 1 ));
+    }
+}
+
+/**
+ * @brief extendRowRangeBody
+ * Shared body of the range kernels.
+ * @param row
+ * @param length
+ * @param minimum
+ * @param maximum
+ */
+DUALMC_KERNEL_BODY void extendRowRangeBody( const uint8_t * __restrict row,
+                                            const size_t length,
+                                            uint8_t & minimum,
+                                            uint8_t & maximum )
+{
+    uint8_t rowMinimum = minimum;
+    uint8_t rowMaximum = maximum;
+    for( size_t i = 0; i < length; ++i )
+    {
+        rowMinimum = std::min( rowMinimum, row[i] );
+        rowMaximum = std::max( rowMaximum, row[i] );
+    }
+    minimum = rowMinimum;
+    maximum = rowMaximum;
+}
+
+void classifyCellRowGeneric( const uint8_t * const rows[4], const int32_t numVoxels,
+                             const uint8_t isoValue, uint8_t * columns, uint8_t * codes )
+{
+    classifyCellRowBody( rows, numVoxels, isoValue, columns, codes );
+}
+
+void extendRowRangeGeneric( const uint8_t * row, const size_t length,
+                            uint8_t & minimum, uint8_t & maximum )
+{
+    extendRowRangeBody( row, length, minimum, maximum );
+}
+
+#if DUALMC_CPU_DISPATCH
+
+DUALMC_TARGET_AVX2
+void classifyCellRowAvx2( const uint8_t * const rows[4], const int32_t numVoxels,
+                          const uint8_t isoValue, uint8_t * columns, uint8_t * codes )
+{
+    classifyCellRowBody( rows, numVoxels, isoValue, columns, codes );
+}
+
+DUALMC_TARGET_AVX2
+void extendRowRangeAvx2( const uint8_t * row, const size_t length,
+                         uint8_t & minimum, uint8_t & maximum )
+{
+    extendRowRangeBody( row, length, minimum, maximum );
+}
+
+DUALMC_TARGET_AVX512
+void classifyCellRowAvx512( const uint8_t * const rows[4], const int32_t numVoxels,
+                            const uint8_t isoValue, uint8_t * columns, uint8_t * codes )
+{
+    classifyCellRowBody( rows, numVoxels, isoValue, columns, codes );
+}
+
+DUALMC_TARGET_AVX512
+void extendRowRangeAvx512( const uint8_t * row, const size_t length,
+                           uint8_t & minimum, uint8_t & maximum )
+{
+    extendRowRangeBody( row, length, minimum, maximum );
+}
+
+#endif
+
+/// Best instruction set level supported by the CPU
+CPU_PATH supportedCpuPath()
+{
+#if DUALMC_CPU_DISPATCH
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ))
+    {
+        return CPU_PATH_AVX512;
+    }
+    if( __builtin_cpu_supports( "avx2" ))
+    {
+        return CPU_PATH_AVX2;
+    }
+#endif
+    return CPU_PATH_GENERIC;
+}
+
+/// Supported level, lowered by the environment override if requested
+CPU_PATH selectCpuPath()
+{
+    CPU_PATH const supported = supportedCpuPath();
+    const char * const requested = std::getenv( "DUALMC_CPU_PATH" );
+    if( requested )
+    {
+        for( int path = CPU_PATH_GENERIC; path <= CPU_PATH_AVX512; ++path )
+        {
+            if( std::strcmp( requested, CPU_PATH_NAMES[ path ]) == 0 )
+            {
+                return std::min( CPU_PATH( path ), supported );
+            }
+        }
+    }
+    return supported;
+}
+
+/// Kernels of an instruction set level
+Kernels selectKernels( const CPU_PATH path )
+{
+    Kernels kernels = { classifyCellRowGeneric, extendRowRangeGeneric };
+#if DUALMC_CPU_DISPATCH
+    if( path == CPU_PATH_AVX2 )
+    {
+        kernels.classifyCellRow = classifyCellRowAvx2;
+        kernels.extendRowRange = extendRowRangeAvx2;
+    }
+    else if( path == CPU_PATH_AVX512 )
+    {
+        kernels.classifyCellRow = classifyCellRowAvx512;
+        kernels.extendRowRange = extendRowRangeAvx512;
+    }
+#else
+    ( void ) path;
+#endif
+    return kernels;
+}
+
+/// Kernels of the selected level, chosen on first use
+const Kernels & kernels()
+{
+    static const Kernels selected = selectKernels( cpuPath());
+    return selected;
+}
+
+}
+
+/**
+ * @brief cpuPath
+ * @return
+ */
+CPU_PATH cpuPath()
+{
+    static const CPU_PATH path = selectCpuPath();
+    return path;
+}
+
+/**
+ * @brief cpuPathName
+ * @param path
+ * @return
+ */
+const char * cpuPathName( const CPU_PATH path )
+{
+    return CPU_PATH_NAMES[ path ];
+}
+
+/**
+ * @brief classifyCellRow
+ * @param rows
+ * @param numVoxels
+ * @param isoValue
+ * @param columns
+ * @param codes
+ */
+void classifyCellRow( const uint8_t * const rows[4],
+                      const int32_t numVoxels,
+                      const uint8_t isoValue,
+                      uint8_t * columns,
+                      uint8_t * codes )
+{
+    kernels().classifyCellRow( rows, numVoxels, isoValue, columns, codes );
+}
+
+/**
+ * @brief extendRowRange
+ * @param row
+ * @param length
+ * @param minimum
+ * @param maximum
+ */
+void extendRowRange( const uint8_t * row,
+                     const size_t length,
+                     uint8_t & minimum,
+                     uint8_t & maximum )
+{
+    kernels().extendRowRange( row, length, minimum, maximum );
+}
+
+}
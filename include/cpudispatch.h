@@ -0,0 +1,77 @@
+#ifndef CPUDISPATCH_H
+#define CPUDISPATCH_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+namespace dualmc
+{
+
+/**
+ * @brief The CPU_PATH enum
+ * Instruction set levels, for which the vectorized kernels are compiled.
+ * One binary contains all levels supported by the compiler, and the best
+ * level supported by the running CPU is selected on first use. The
+ * environment variable DUALMC_CPU_PATH set to generic, avx2 or avx512
+ * overrides the selection, for example to compare the paths. Levels above
+ * the ones supported by the CPU are never selected.
+ */
+enum CPU_PATH
+{
+    CPU_PATH_GENERIC,
+    CPU_PATH_AVX2,
+    CPU_PATH_AVX512
+};
+
+/**
+ * @brief cpuPath
+ * The instruction set level used by the kernels.
+ * @return
+ */
+CPU_PATH cpuPath();
+
+/**
+ * @brief cpuPathName
+ * Name of an instruction set level as used by DUALMC_CPU_PATH.
+ * @param path
+ * @return
+ */
+const char * cpuPathName( const CPU_PATH path );
+
+/**
+ * @brief classifyCellRow
+ * Compute the plain cube codes of a row of cells from the four voxel rows at
+ * ( y, z ), ( y + 1, z ), ( y, z + 1 ) and ( y + 1, z + 1 ).
+ * @param rows
+ * The four voxel rows in this order.
+ * @param numVoxels
+ * Number of voxels per row, the row has one cell less.
+ * @param isoValue
+ * @param columns
+ * Buffer for the inside bits of the voxel columns with numVoxels entries.
+ * @param codes
+ * Output cube codes with numVoxels - 1 entries.
+ */
+void classifyCellRow( const uint8_t * const rows[4],
+                      const int32_t numVoxels,
+                      const uint8_t isoValue,
+                      uint8_t * columns,
+                      uint8_t * codes );
+
+/**
+ * @brief extendRowRange
+ * Extend the range [minimum, maximum] by the values of a voxel row.
+ * @param row
+ * @param length
+ * @param minimum
+ * @param maximum
+ */
+void extendRowRange( const uint8_t * row,
+                     const size_t length,
+                     uint8_t & minimum,
+                     uint8_t & maximum );
+
+}
+
+#endif // CPUDISPATCH_H
@@ -1,313 +1,481 @@
 #include "dualmc.h"
+#include "linearvolume.h"
+
+// STL includes
+#include <algorithm>
+#include <chrono>
+
+#include "parallel.h"
 
 namespace dualmc
 {
 
-/**
- * @brief DualMC::index
- * @param x
- * @param y
- * @param z
- * @return
- */
-int32_t DualMC::_index( const int32_t x, const int32_t y, const int32_t z ) const
+namespace
 {
-    return x + _volumeDimensions[0] * (y + _volumeDimensions[1] * z);
-}
 
+/// Edge length of the cubic tiles of cells collected into meshlets
+const int32_t MESHLET_TILE_SIZE = 8;
 
-/**
- * @brief DualMC::getCellCode
- * @param x
- * @param y
- * @param z
- * @param isoValue
- * @return
- */
-int DualMC::_getCellCode( const int32_t x, const int32_t y, const int32_t z,
-                         const uint8_t isoValue ) const
+/// Offset of the base voxel of each cell edge from the cell, by edge index
+const int32_t EDGE_BASE_OFFSETS[12][3] =
 {
-    // Determine for each cube corner if it is outside or inside
-    int code = 0;
+    { 0, 0, 0 }, { 1, 0, 0 }, { 0, 0, 1 }, { 0, 0, 0 },
+    { 0, 1, 0 }, { 1, 1, 0 }, { 0, 1, 1 }, { 0, 1, 0 },
+    { 0, 0, 0 }, { 1, 0, 0 }, { 1, 0, 1 }, { 0, 0, 1 }
+};
 
-    if( _volumeGrid[_index( x, y, z )] >= isoValue )
-        code |= 1;
-    if( _volumeGrid[_index( x + 1, y, z )] >= isoValue )
-        code |= 2;
-    if( _volumeGrid[_index( x, y + 1, z )] >= isoValue )
-        code |= 4;
-    if( _volumeGrid[_index( x + 1, y + 1, z )] >= isoValue )
-        code |= 8;
-    if( _volumeGrid[_index( x, y, z + 1 )] >= isoValue )
-        code |= 16;
-    if( _volumeGrid[_index( x + 1, y, z + 1 )] >= isoValue )
-        code |= 32;
-    if( _volumeGrid[_index( x, y + 1, z + 1 )] >= isoValue )
-        code |= 64;
-    if( _volumeGrid[_index( x + 1, y + 1, z + 1 )] >= isoValue )
-        code |= 128;
+/// Edge length of the blocks of cells with a bitmap of visited edges
+const int32_t VISITED_BLOCK_SIZE = 8;
 
-    return code;
-}
+/// Number of 64-bit words of the bitmap of a block with three edges per cell
+const size_t VISITED_BLOCK_WORDS = 3 * VISITED_BLOCK_SIZE * VISITED_BLOCK_SIZE * VISITED_BLOCK_SIZE / 64;
+
+/// Axis of each cell edge, by edge index
+const int EDGE_AXES[12] = { 0, 2, 0, 2, 0, 2, 0, 2, 1, 1, 1, 1 };
+
+/// Offsets of the four cells around the edge along each axis starting at a
+/// voxel, in the order of the quad vertices
+const int32_t QUAD_CELL_OFFSETS[3][4][3] =
+{
+    { { 0, 0, 0 }, { 0, 0, -1 }, { 0, -1, -1 }, { 0, -1, 0 } },
+    { { 0, 0, 0 }, { 0, 0, -1 }, { -1, 0, -1 }, { -1, 0, 0 } },
+    { { 0, 0, 0 }, { -1, 0, 0 }, { -1, -1, 0 }, { 0, -1, 0 } }
+};
+
+/// The edge along each axis as seen from the four cells around it
+const DMC_EDGE_CODE QUAD_CELL_EDGES[3][4] =
+{
+    { EDGE0, EDGE2, EDGE6, EDGE4 },
+    { EDGE8, EDGE11, EDGE10, EDGE9 },
+    { EDGE3, EDGE1, EDGE5, EDGE7 }
+};
+
+/// Base voxel and axis of an edge queued by the surface tracking
+struct QueuedEdge
+{
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    int axis;
+};
+
+/// Clock used for timing the build phases
+typedef std::chrono::steady_clock PhaseClock;
 
 /**
- * @brief DualMC::getDualPointCode
- * @param x
- * @param y
- * @param z
- * @param isoValue
- * @param edge
+ * @brief secondsSince
+ * Wall time in seconds elapsed since the given time point.
+ * @param start
  * @return
  */
-int DualMC::_getDualPointCode( const int32_t x, const int32_t y, const int32_t z,
-                              const uint8_t isoValue,
-                              const DMC_EDGE_CODE edge) const
+inline double secondsSince( const PhaseClock::time_point start )
 {
-    // Get the code of the cube that corresponds to the given XYZ voxel
-    int cubeCode = _getCellCode( x, y, z, isoValue );
+    return std::chrono::duration< double >( PhaseClock::now() - start ).count();
+}
 
-    // Is manifold dual marching cubes desired?
-    if(_generateManifold)
+/**
+ * @brief The SliceRingVolume class
+ * Volume accessor for an implicit volume. It keeps a ring buffer of z-slices,
+ * which are sampled right before the extraction reaches them. Each voxel is
+ * sampled exactly once.
+ * Processing voxel layer z reads slices z - 2 up to z + 2, where the outer
+ * ones are only needed for manifold neighbor checks. Eight slices in the ring
+ * are enough and allow for wrapping with a bit mask.
+ */
+class SliceRingVolume
+{
+public:
+
+    /// Initializing constructor
+    SliceRingVolume( const DualMC::RowSampler & sampler,
+                     const int32_t x, const int32_t y, const int32_t z,
+                     const unsigned int numThreads )
+        : _sampler( sampler ),
+          _numThreads( numThreads ),
+          _nextSlice( 0 ),
+          _samplingTime( 0.0 )
     {
-        // The Manifold Dual Marching Cubes approach from Rephael Wenger as
-        // described in chapter 3.3.5 of his book "Isosurfaces: Geometry,
-        // Topology, and Algorithms" is implemente here.
-        // If a problematic C16 or C19 configuration shares the ambiguous face
-        // with another C16 or C19 configuration we simply invert the cube code
-        // before looking up dual points.
-        // Doing this for these pairs ensures manifold meshes.
-        // But this removes the dualism to marching cubes.
+        _dimensions[0] = x;
+        _dimensions[1] = y;
+        _dimensions[2] = z;
+        _slices.resize( size_t( RING_SIZE ) * size_t( x ) * size_t( y ));
+    }
 
-        // Check if we have a potentially problematic configuration
-        const uint8_t direction = problematicConfigs[uint8_t( cubeCode )];
+    /// The voxel value at ( x, y, z )
+    uint8_t operator()( const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        return _slices[ x + size_t( _dimensions[0] ) *
+                ( y + size_t( _dimensions[1] ) * size_t( z & RING_MASK ))];
+    }
 
-        // If the direction code is in {0,...,5} we have a C16 or C19 configuration.
-        if( direction != 255 )
+    /// Sample all slices needed for processing voxel layer z
+    void prepareLayer( const int32_t z )
+    {
+        int32_t const lastSlice = std::min( z + LOOKAHEAD, _dimensions[2] - 1 );
+        if( _nextSlice > lastSlice )
         {
-            // We have to check the neighboring cube, which shares the ambiguous
-            // face. For this we decode the direction. This could also be done
-            // with another lookup table.
-            // Copy current cube coordinates into an array.
-            int32_t neighborCoords[] = {x,y,z};
-
-            // Get the dimension of the non-zero coordinate axis
-            unsigned int const component = direction >> 1;
-
-            // Get the sign of the direction
-            int32_t delta = (direction & 1) == 1 ? 1 : -1;
-
-            // Modify the correspong cube coordinate
-            neighborCoords[component] += delta;
+            return;
+        }
 
-            // Have we left the volume in this direction?
-            if( neighborCoords[component] >= 0 &&
-                neighborCoords[component] < ( _volumeDimensions[component] - 1 ))
+        DUALMC_STAT( PhaseClock::time_point const start = PhaseClock::now() );
+        for( ; _nextSlice <= lastSlice; ++_nextSlice )
+        {
+            // Sample the rows of the slice, optionally in parallel
+            int32_t const sliceZ = _nextSlice;
+            uint8_t * const slice = &_slices[ size_t( _dimensions[0] ) *
+                    size_t( _dimensions[1] ) * size_t( sliceZ & RING_MASK )];
+            parallelFor( 0, _dimensions[1], [ & ]( const int32_t y )
             {
-                // Get the cube configuration of the relevant neighbor
-                int neighborCubeCode = _getCellCode( neighborCoords[0],
-                                                    neighborCoords[1],
-                                                    neighborCoords[2],
-                                                    isoValue );
-
-                // Look up the neighbor configuration ambiguous face direction.
-                // If the direction is valid we have a C16 or C19 neighbor.
-                // As C16 and C19 have exactly one ambiguous face this face is
-                // guaranteed to be shared for the pair.
-                if( problematicConfigs[uint8_t( neighborCubeCode )] != 255 )
-                {
-                    // Replace the cube configuration with its inverse.
-                    cubeCode ^= 0xff;
-                }
-            }
+                _sampler( y, sliceZ, slice + size_t( _dimensions[0] ) * size_t( y ));
+            }, _numThreads );
         }
+        DUALMC_STAT( _samplingTime += secondsSince( start ));
     }
 
-    for( int i = 0; i < 4; ++i )
+    /// Accumulated wall time spent in the sampler
+    double samplingTime() const
     {
-        if( dualPointsList[ cubeCode ][ i ] & edge )
-        {
-            return dualPointsList[ cubeCode ][ i ];
-        }
+        return _samplingTime;
     }
 
-    return 0;
-}
+private:
 
+    // Ring of slices and the slice lookahead of a voxel layer
+    static constexpr int32_t RING_SIZE = 8;
+    static constexpr int32_t RING_MASK = RING_SIZE - 1;
+    static constexpr int32_t LOOKAHEAD = 2;
+
+    const DualMC::RowSampler & _sampler;
+    unsigned int _numThreads;
+    int32_t _dimensions[3];
+    std::vector< uint8_t > _slices;
+    int32_t _nextSlice;
+    double _samplingTime;
+};
 
 /**
- * @brief DualMC::calculateDualPoint
- * @param x
- * @param y
- * @param z
- * @param isoValue
- * @param pointCode
- * @param v
+ * @brief The LayerNotifyingVolume class
+ * Volume accessor wrapper, which calls a function whenever the builder
+ * prepares the next voxel layer, that is when all previous layers are done.
  */
-void DualMC::_calculateDualPoint( const int32_t x,
-                                  const int32_t y,
-                                  const int32_t z,
-                                  const uint8_t isoValue,
-                                  const int pointCode,
-                                  Vertex & v ) const
+template< class Volume >
+class LayerNotifyingVolume
 {
-    // Initialize the point with lower voxel coordinates
-    v.x = x;
-    v.y = y;
-    v.z = z;
-
-    // Compute the dual point as the mean of the face vertices belonging to the
-    // original marching cubes face
-    Vertex p;
-    p.x = 0; p.y = 0; p.z = 0;
-
-    int points = 0;
+public:
 
-    // Sum edge intersection vertices using the point code
-    if( pointCode & EDGE0 )
+    /// Initializing constructor
+    LayerNotifyingVolume( Volume & volume, const std::function< void() > & notify )
+        : _volume( volume ),
+          _notify( notify ),
+          _started( false )
     {
-        p.x += (( float ) isoValue - ( float ) _volumeGrid[_index( x, y, z )]) /
-                (( float ) _volumeGrid[_index( x + 1, y, z )] -
-                ( float ) _volumeGrid[_index( x, y, z )]);
-        points++;
+        /// EMPTY
     }
 
-    if( pointCode & EDGE1 )
+    /// The voxel value at ( x, y, z )
+    uint8_t operator()( const int32_t x, const int32_t y, const int32_t z ) const
     {
-        p.x += 1.0f;
-        p.z += (( float ) isoValue - ( float ) _volumeGrid[_index(x + 1, y, z )]) /
-                (( float ) _volumeGrid[_index( x + 1, y, z + 1 )] -
-                ( float ) _volumeGrid[_index(x + 1, y, z )]);
-        points++;
+        return _volume( x, y, z );
     }
 
-    if( pointCode & EDGE2 )
+    /// Notify about the previous layer and prepare voxel layer z
+    void prepareLayer( const int32_t z )
     {
-        p.x += (( float ) isoValue - ( float ) _volumeGrid[_index( x, y, z + 1 )]) /
-                (( float ) _volumeGrid[_index( x + 1, y, z + 1 )] -
-                ( float ) _volumeGrid[_index( x, y, z + 1 )]);
-        p.z += 1.0f;
-        points++;
+        if( _started )
+        {
+            _notify();
+        }
+        _started = true;
+        _volume.prepareLayer( z );
     }
 
-    if( pointCode & EDGE3 )
+private:
+
+    Volume & _volume;
+    const std::function< void() > & _notify;
+    bool _started;
+};
+
+}
+
+/**
+ * @brief DualMC::DualMC
+ */
+DualMC::DualMC()
+    : _generateManifold( false ),
+      pointToIndex( 0, DualPointKeyHash(), std::equal_to< DualPointKey >(),
+                    PointMap::allocator_type( &_scratch ))
+{
+    _volumeDimensions[0] = _volumeDimensions[1] = _volumeDimensions[2] = 0;
+    _cellBegin[0] = _cellBegin[1] = _cellBegin[2] = 0;
+    _cellEnd[0] = _cellEnd[1] = _cellEnd[2] = 0;
+    _origin[0] = _origin[1] = _origin[2] = 0;
+}
+
+/**
+ * @brief DualMC::DualMC
+ * @param other
+ */
+DualMC::DualMC( const DualMC & other )
+    : _generateManifold( other._generateManifold ),
+      _stats( other._stats ),
+      pointToIndex( other.pointToIndex, PointMap::allocator_type( &_scratch )),
+      _activeCells( other._activeCells ),
+      _visitedBlocks( other._visitedBlocks ),
+      _visitedEdges( other._visitedEdges )
+{
+    _copyRanges( other );
+    _scratch.setHugePages( other._scratch.hugePages());
+}
+
+/**
+ * @brief DualMC::DualMC
+ * @param other
+ */
+DualMC::DualMC( DualMC && other )
+    : _generateManifold( other._generateManifold ),
+      _stats( other._stats ),
+      pointToIndex( std::move( other.pointToIndex ), PointMap::allocator_type( &_scratch )),
+      _activeCells( std::move( other._activeCells )),
+      _visitedBlocks( std::move( other._visitedBlocks )),
+      _visitedEdges( std::move( other._visitedEdges ))
+{
+    _copyRanges( other );
+    _scratch.setHugePages( other._scratch.hugePages());
+}
+
+/**
+ * @brief DualMC::operator =
+ * @param other
+ * @return
+ */
+DualMC & DualMC::operator=( const DualMC & other )
+{
+    if( this != &other )
     {
-        p.z += (( float ) isoValue - ( float ) _volumeGrid[_index( x, y, z )] ) /
-                (( float ) _volumeGrid[_index( x, y, z + 1)] -
-                ( float ) _volumeGrid[_index( x, y, z )]);
-        points++;
+        // The map keeps its allocator, so the points are copied into the
+        // own arena after releasing the old ones
+        _resetScratch();
+        pointToIndex = other.pointToIndex;
+        _scratch.setHugePages( other._scratch.hugePages());
+        _copyRanges( other );
+        _generateManifold = other._generateManifold;
+        _stats = other._stats;
+        _activeCells = other._activeCells;
+        _visitedBlocks = other._visitedBlocks;
+        _visitedEdges = other._visitedEdges;
     }
+    return *this;
+}
 
-    if( pointCode & EDGE4 )
+/**
+ * @brief DualMC::operator =
+ * @param other
+ * @return
+ */
+DualMC & DualMC::operator=( DualMC && other )
+{
+    if( this != &other )
     {
-        p.x += (( float ) isoValue - ( float ) _volumeGrid[_index( x, y + 1, z )]) /
-                (( float ) _volumeGrid[_index( x + 1, y + 1, z )] -
-                ( float ) _volumeGrid[_index( x, y + 1, z )]);
-        p.y += 1.0f;
-        points++;
+        // The arenas differ, so the points are moved one by one
+        _resetScratch();
+        pointToIndex = std::move( other.pointToIndex );
+        _scratch.setHugePages( other._scratch.hugePages());
+        _copyRanges( other );
+        _generateManifold = other._generateManifold;
+        _stats = other._stats;
+        _activeCells = std::move( other._activeCells );
+        _visitedBlocks = std::move( other._visitedBlocks );
+        _visitedEdges = std::move( other._visitedEdges );
     }
+    return *this;
+}
 
-    if( pointCode & EDGE5 )
+/**
+ * @brief DualMC::copyRanges
+ * @param other
+ */
+void DualMC::_copyRanges( const DualMC & other )
+{
+    for( int i = 0; i < 3; ++i )
     {
-        p.x += 1.0f;
-        p.z += (( float ) isoValue - ( float ) _volumeGrid[_index( x + 1, y + 1, z )]) /
-                (( float ) _volumeGrid[_index( x + 1, y + 1, z + 1 )] -
-                ( float ) _volumeGrid[_index( x + 1, y + 1, z )]);
-        p.y += 1.0f;
-        points++;
+        _volumeDimensions[i] = other._volumeDimensions[i];
+        _cellBegin[i] = other._cellBegin[i];
+        _cellEnd[i] = other._cellEnd[i];
+        _origin[i] = other._origin[i];
     }
+}
 
-    if( pointCode & EDGE6 )
+/**
+ * @brief DualMC::wrapPeriodicPoints
+ * @param dimensions
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ */
+void DualMC::_wrapPeriodicPoints( const int32_t dimensions[3], const bool generateSoup,
+                                  std::vector<Vertex> & vertices, std::vector<Quad> & quads ) const
+{
+    // The first padded cell layer repeats the cells at the end of the volume
+    float const layerEnd = float( BoundaryVolume< LinearVolume >::PADDING_BEGIN );
+    if( generateSoup )
     {
-        p.x += (( float ) isoValue - ( float ) _volumeGrid[_index( x, y + 1, z + 1 )]) /
-                (( float ) _volumeGrid[_index( x + 1, y + 1, z + 1 )] -
-                ( float ) _volumeGrid[_index( x, y + 1, z + 1 )]);
-        p.z += 1.0f;
-        p.y += 1.0f;
-        points++;
+        for( Vertex & vertex : vertices )
+        {
+            float * const coords[] = { &vertex.x, &vertex.y, &vertex.z };
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                if( *coords[ axis ] < layerEnd )
+                {
+                    *coords[ axis ] += float( dimensions[ axis ] );
+                }
+            }
+        }
+        return;
     }
 
-    if( pointCode & EDGE7 )
+    // Keys of the shared vertices
+    std::vector< DualPointKey > keys( vertices.size());
+    for( auto const & entry : pointToIndex )
     {
-        p.z += (( float ) isoValue - ( float ) _volumeGrid[_index( x, y + 1 , z )]) /
-                (( float ) _volumeGrid[_index( x, y + 1, z + 1 )] -
-                ( float ) _volumeGrid[_index( x, y + 1 , z )]);
-        p.y += 1.0f;
-        points++;
+        keys[ entry.second ] = entry.first;
     }
 
-    if( pointCode & EDGE8 )
+    // Points of cells inside the volume keep their keys, the others are
+    // looked up by the keys of the repeated cells
+    std::unordered_map< DualPointKey, int32_t, DualPointKeyHash > wrappedPoints;
+    wrappedPoints.reserve( vertices.size());
+    std::vector< int32_t > remap( vertices.size(), -1 );
+    for( int pass = 0; pass < 2; ++pass )
     {
-        p.y += (( float ) isoValue - ( float ) _volumeGrid[_index( x, y, z )]) /
-                (( float ) _volumeGrid[_index(x, y + 1, z )] -
-                ( float ) _volumeGrid[_index( x, y, z )]);
-        points++;
+        for( size_t i = 0; i < vertices.size(); ++i )
+        {
+            int32_t const cell = keys[i].linearizedCellID;
+            int32_t coords[] = { cell % _volumeDimensions[0],
+                                 ( cell / _volumeDimensions[0] ) % _volumeDimensions[1],
+                                 cell / ( _volumeDimensions[0] * _volumeDimensions[1] ) };
+            bool const repeated = coords[0] == 0 || coords[1] == 0 || coords[2] == 0;
+            if( repeated != ( pass == 1 ))
+            {
+                continue;
+            }
+
+            DualPointKey key = keys[i];
+            float * const position[] = { &vertices[i].x, &vertices[i].y, &vertices[i].z };
+            bool moved[3] = { false, false, false };
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                if( coords[ axis ] == 0 )
+                {
+                    coords[ axis ] = dimensions[ axis ];
+                    moved[ axis ] = true;
+                }
+            }
+            key.linearizedCellID = _index( coords[0], coords[1], coords[2] );
+
+            auto const inserted = wrappedPoints.emplace( key, int32_t( i ));
+            remap[i] = inserted.first->second;
+            for( int axis = 0; inserted.second && axis < 3; ++axis )
+            {
+                *position[ axis ] += moved[ axis ] ? float( dimensions[ axis ] ) : 0.0f;
+            }
+        }
     }
 
-    if( pointCode & EDGE9 )
+    // Drop the merged points and renumber the quads
+    std::vector< int32_t > newIndex( vertices.size());
+    int32_t numKept = 0;
+    for( size_t i = 0; i < vertices.size(); ++i )
     {
-        p.x += 1.0f;
-        p.y += (( float ) isoValue - ( float ) _volumeGrid[_index( x + 1, y, z )]) /
-                (( float ) _volumeGrid[_index(x + 1, y + 1, z )] -
-                ( float ) _volumeGrid[_index( x + 1, y, z )]);
-        points++;
+        if( remap[i] == int32_t( i ))
+        {
+            newIndex[i] = numKept;
+            vertices[ numKept++ ] = vertices[i];
+        }
     }
-
-    if( pointCode & EDGE10 )
+    for( size_t i = 0; i < newIndex.size(); ++i )
     {
-        p.x += 1.0f;
-        p.y += (( float ) isoValue - ( float ) _volumeGrid[_index(x + 1, y, z + 1 )]) /
-                (( float ) _volumeGrid[_index( x + 1, y + 1, z + 1 )] -
-                ( float ) _volumeGrid[_index( x + 1, y, z + 1 )]);
-        p.z += 1.0f;
-        points++;
+        newIndex[i] = newIndex[ remap[i] ];
     }
-
-    if( pointCode & EDGE11 )
+    vertices.resize( numKept );
+    for( Quad & quad : quads )
     {
-        p.z += 1.0f;
-        p.y += (( float ) isoValue - ( float ) _volumeGrid[_index( x, y, z + 1 )]) /
-                (( float ) _volumeGrid[_index( x, y + 1, z + 1 )] -
-                ( float ) _volumeGrid[_index( x, y, z + 1 )]);
-        points++;
+        for( int k = 0; k < 4; ++k )
+        {
+            quad[k] = newIndex[ quad[k] ];
+        }
     }
+}
 
-    // Divide by number of accumulated points
-    float invPoints = 1.0f / ( float ) points;
-    p.x *= invPoints; p.y *= invPoints; p.z *= invPoints;
+/**
+ * @brief DualMC::setHugePages
+ * @param enable
+ */
+void DualMC::setHugePages( const bool enable )
+{
+    _scratch.setHugePages( enable );
+}
+
+/**
+ * @brief DualMC::resetScratch
+ */
+void DualMC::_resetScratch()
+{
+    // Swapping with an empty map releases the nodes and buckets, which have
+    // to be gone before the arena is reset
+    size_t const numPoints = pointToIndex.size();
+    PointMap( 0, DualPointKeyHash(), std::equal_to< DualPointKey >(),
+              pointToIndex.get_allocator()).swap( pointToIndex );
+    _scratch.reset();
+    pointToIndex.reserve( numPoints );
+}
 
-    // Offset point by voxel coordinates
-    v.x += p.x;
-    v.y += p.y;
-    v.z += p.z;
+/**
+ * @brief DualMC::index
+ * @param x
+ * @param y
+ * @param z
+ * @return
+ */
+int32_t DualMC::_index( const int32_t x, const int32_t y, const int32_t z ) const
+{
+    return x + _volumeDimensions[0] * (y + _volumeDimensions[1] * z);
 }
 
+
+
 /**
  * @brief DualMC::getSharedDualPointIndex
+ * @param volume
  * @param x
  * @param y
  * @param z
  * @param isoValue
- * @param edge
+ * @param pointCode
  * @param vertices
  * @return
  */
-int32_t DualMC::_getSharedDualPointIndex( const int32_t x,
+template< class Volume, class VertexType >
+int32_t DualMC::_getSharedDualPointIndex( const Volume & volume,
+                                          const int32_t x,
                                           const int32_t y,
                                           const int32_t z,
                                           const uint8_t isoValue,
-                                          const DMC_EDGE_CODE edge,
-                                          std::vector<Vertex> & vertices )
+                                          const int pointCode,
+                                          std::vector<VertexType> & vertices )
 {
     // Create a key for the dual point from its linearized cell ID and point code
     DualPointKey key;
     key.linearizedCellID = _index(x,y,z);
-    key.pointCode = _getDualPointCode(x,y,z,isoValue,edge);
+    key.pointCode = pointCode;
+    DUALMC_STAT( ++_stats.pointLookups );
 
     // have we already computed the dual point?
     auto iterator = pointToIndex.find( key );
     if( iterator != pointToIndex.end())
     {
         // Just return the dual point index
+        DUALMC_STAT( ++_stats.pointLookupHits );
         return iterator->second;
     }
     else
@@ -315,7 +483,7 @@ int32_t DualMC::_getSharedDualPointIndex( const int32_t x,
         // Create new vertex and vertex id
         int32_t newVertexId = vertices.size();
         vertices.emplace_back();
-        _calculateDualPoint( x, y, z, isoValue, key.pointCode, vertices.back());
+        _calculateDualPoint( volume, x, y, z, isoValue, key.pointCode, vertices.back());
 
         // Insert vertex ID into map and also return it
         pointToIndex[key] = newVertexId;
@@ -323,6 +491,112 @@ int32_t DualMC::_getSharedDualPointIndex( const int32_t x,
     }
 }
 
+/**
+ * @brief The DualMC::SharedVertexSink class
+ * Appends quads with shared vertex indices. The indices of the four dual
+ * points are looked up in the order of the cells, so new vertices are
+ * numbered in the order in which the sweep first reaches them.
+ */
+template< class VertexType >
+class DualMC::SharedVertexSink
+{
+public:
+
+    /// Initializing constructor
+    SharedVertexSink( DualMC & builder, const uint8_t isoValue,
+                      std::vector<VertexType> & vertices, std::vector<Quad> & quads )
+        : _builder( builder ),
+          _isoValue( isoValue ),
+          _vertices( vertices ),
+          _quads( quads )
+    {
+        /// EMPTY
+    }
+
+    /// Append the quad of the dual points of four cells
+    template< class Volume >
+    void addQuad( const Volume & volume, const int32_t cells[4][3],
+                  const int pointCodes[4], const bool flip )
+    {
+        int32_t indices[4];
+        for( int k = 0; k < 4; ++k )
+        {
+            indices[k] = _builder._getSharedDualPointIndex( volume, cells[k][0], cells[k][1], cells[k][2],
+                                                            _isoValue, pointCodes[k], _vertices );
+        }
+
+        if( flip )
+        {
+            _quads.emplace_back( indices[0], indices[3], indices[2], indices[1] );
+        }
+        else
+        {
+            _quads.emplace_back( indices[0], indices[1], indices[2], indices[3] );
+        }
+    }
+
+private:
+
+    DualMC & _builder;
+    uint8_t _isoValue;
+    std::vector<VertexType> & _vertices;
+    std::vector<Quad> & _quads;
+};
+
+/**
+ * @brief The DualMC::QuadSoupSink class
+ * Appends the four dual points of each quad to a quad soup.
+ */
+template< class VertexType >
+class DualMC::QuadSoupSink
+{
+public:
+
+    /// Initializing constructor
+    QuadSoupSink( const DualMC & builder, const uint8_t isoValue,
+                  std::vector<VertexType> & vertices )
+        : _builder( builder ),
+          _isoValue( isoValue ),
+          _vertices( vertices )
+    {
+        /// EMPTY
+    }
+
+    /// Append the dual points of four cells
+    template< class Volume >
+    void addQuad( const Volume & volume, const int32_t cells[4][3],
+                  const int pointCodes[4], const bool flip )
+    {
+        VertexType points[4];
+        for( int k = 0; k < 4; ++k )
+        {
+            _builder._calculateDualPoint( volume, cells[k][0], cells[k][1], cells[k][2],
+                                          _isoValue, pointCodes[k], points[k] );
+        }
+
+        if( flip )
+        {
+            _vertices.emplace_back( points[0] );
+            _vertices.emplace_back( points[3] );
+            _vertices.emplace_back( points[2] );
+            _vertices.emplace_back( points[1] );
+        }
+        else
+        {
+            _vertices.emplace_back( points[0] );
+            _vertices.emplace_back( points[1] );
+            _vertices.emplace_back( points[2] );
+            _vertices.emplace_back( points[3] );
+        }
+    }
+
+private:
+
+    const DualMC & _builder;
+    uint8_t _isoValue;
+    std::vector<VertexType> & _vertices;
+};
+
 /**
  * @brief DualMC::build
  * @param data
@@ -334,6 +608,7 @@ int32_t DualMC::_getSharedDualPointIndex( const int32_t x,
  * @param generateSoup
  * @param vertices
  * @param quads
+ * @param stats
  */
 void DualMC::build(const uint8_t* data,
                    const int32_t x, const int32_t y, const int32_t z,
@@ -341,272 +616,1266 @@ void DualMC::build(const uint8_t* data,
                    const bool generateManifold,
                    const bool generateSoup,
                    std::vector<Vertex> & vertices,
-                   std::vector<Quad> & quads)
+                   std::vector<Quad> & quads,
+                   BuildStats * stats )
 {
-
-    // Set members
-    this->_volumeDimensions[0] = x;
-    this->_volumeDimensions[1] = y;
-    this->_volumeDimensions[2] = z;
-    this->_volumeGrid = data;
-    this->_generateManifold = generateManifold;
-
-    // Clear vertices and quad indices
-    vertices.clear();
-    quads.clear();
-
-    // Generate quad soup or shared vertices quad list
-    if( generateSoup )
-    {
-        _buildQuadSoup( isoValue, vertices, quads );
-    }
-    else
+    _resetScratch();
+    // Sweep all cells with cube codes computed once per cell layer
+    LinearVolume linearVolume( data, x, y, z );
+    CellCodeVolume< LinearVolume > volume( linearVolume, x, y, z, isoValue, generateManifold, &_scratch );
+    _build( volume, x, y, z, isoValue, generateManifold, generateSoup,
+            vertices, quads, nullptr );
+
+    // Hand out the statistics of this build
+    if( stats )
     {
-        _buildSharedVerticesQuads( isoValue, vertices, quads );
+        *stats = _stats;
     }
 }
 
 /**
- * @brief DualMC::buildSharedVerticesQuads
+ * @brief DualMC::build
+ * @param data
+ * @param x
+ * @param y
+ * @param z
  * @param isoValue
+ * @param generateManifold
+ * @param filter
  * @param vertices
  * @param quads
+ * @param stats
  */
-void DualMC::_buildSharedVerticesQuads( const uint8_t isoValue,
-                                       std::vector<Vertex> & vertices,
-                                       std::vector<Quad> & quads)
+void DualMC::build( const uint8_t* data,
+                    const int32_t x, const int32_t y, const int32_t z,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    const ComponentFilter & filter,
+                    std::vector<Vertex> & vertices,
+                    std::vector<Quad> & quads,
+                    BuildStats * stats )
 {
-    // TODO: Why the volume dimensions are reduced by two ?!!
-    int32_t const reducedX = _volumeDimensions[0] - 2;
-    int32_t const reducedY = _volumeDimensions[1] - 2;
-    int32_t const reducedZ = _volumeDimensions[2] - 2;
-
-    int32_t i0, i1, i2, i3;
-
-    pointToIndex.clear();
-
-    // Iterate voxels
-    for( int32_t z = 0; z < reducedZ; ++z )
+    _resetScratch();
+    // The sweep extracts into its own buffers. After each finished layer
+    // the labeler hands out the finished components above the limits and
+    // drops the others.
+    ComponentLabeler labeler( filter, vertices, quads );
+    std::vector< Vertex > sweepVertices;
+    std::vector< Quad > pendingQuads;
+    std::function< void() > const joinLayer = [ & ]()
     {
-        for( int32_t y = 0; y < reducedY; ++y )
-        {
-            for( int32_t x = 0; x < reducedX; ++x )
-            {
-                // Construct quads for X edge
-                if( z > 0 && y > 0 )
-                {
-                    bool const entering = _volumeGrid[_index( x, y, z)] < isoValue &&
-                                          _volumeGrid[_index( x + 1, y, z)] >= isoValue;
-                    bool const exiting  = _volumeGrid[_index( x, y, z)] >= isoValue &&
-                                          _volumeGrid[_index( x + 1, y, z)] < isoValue;
-                    if( entering || exiting )
-                    {
-                        // Generate quad
-                        i0 = _getSharedDualPointIndex( x, y, z,
-                                                      isoValue, EDGE0, vertices );
-                        i1 = _getSharedDualPointIndex( x, y, z - 1,
-                                                      isoValue, EDGE2, vertices );
-                        i2 = _getSharedDualPointIndex( x, y - 1, z - 1,
-                                                      isoValue, EDGE6, vertices );
-                        i3 = _getSharedDualPointIndex( x, y - 1, z,
-                                                      isoValue, EDGE4, vertices );
-
-                        if( entering )
-                        {
-                            quads.emplace_back( i0, i1, i2, i3);
-                        }
-                        else
-                        {
-                            quads.emplace_back( i0, i3, i2, i1 );
-                        }
-                    }
-                }
+        labeler.addLayer( sweepVertices, pendingQuads );
+    };
 
-                // Construct quads for y edge
-                if( z > 0 && x > 0 )
-                {
-                    bool const entering = _volumeGrid[_index( x, y, z )] < isoValue &&
-                                          _volumeGrid[_index( x, y + 1, z )] >= isoValue;
-                    bool const exiting  = _volumeGrid[_index( x, y, z )] >= isoValue &&
-                                          _volumeGrid[_index( x, y + 1, z )] < isoValue;
+    LinearVolume linearVolume( data, x, y, z );
+    LayerNotifyingVolume< LinearVolume > notifyingVolume( linearVolume, joinLayer );
+    CellCodeVolume< LayerNotifyingVolume< LinearVolume > > volume( notifyingVolume, x, y, z,
+                                                                   isoValue, generateManifold, &_scratch );
+    _build( volume, x, y, z, isoValue, generateManifold, false, sweepVertices, pendingQuads, nullptr );
 
-                    if( entering || exiting )
-                    {
-                        // Generate quad
-                        i0 = _getSharedDualPointIndex( x, y, z,
-                                                      isoValue, EDGE8, vertices );
-                        i1 = _getSharedDualPointIndex( x, y, z - 1,
-                                                      isoValue, EDGE11, vertices );
-                        i2 = _getSharedDualPointIndex( x - 1, y, z - 1,
-                                                      isoValue, EDGE10, vertices );
-                        i3 = _getSharedDualPointIndex( x - 1, y, z,
-                                                      isoValue, EDGE9, vertices );
-
-                        if( exiting )
-                        {
-                            quads.emplace_back( i0, i1, i2, i3 );
-                        }
-                        else
-                        {
-                            quads.emplace_back( i0, i3, i2, i1 );
-                        }
-                    }
-                }
+    labeler.finish( sweepVertices, pendingQuads );
 
-                // Construct quads for z edge
-                if( x > 0 && y > 0 )
-                {
-                    bool const entering = _volumeGrid[_index( x, y, z )] < isoValue &&
-                                          _volumeGrid[_index( x, y, z + 1 )] >= isoValue;
-                    bool const exiting  = _volumeGrid[_index( x, y, z )] >= isoValue &&
-                                          _volumeGrid[_index( x, y, z + 1 )] < isoValue;
-                    if( entering || exiting )
-                    {
-                        // Generate quad
-                        i0 = _getSharedDualPointIndex( x, y, z,
-                                                      isoValue, EDGE3, vertices);
-                        i1 = _getSharedDualPointIndex( x - 1, y, z,
-                                                      isoValue, EDGE1, vertices);
-                        i2 = _getSharedDualPointIndex( x - 1, y - 1, z,
-                                                      isoValue, EDGE5, vertices);
-                        i3 = _getSharedDualPointIndex( x, y - 1, z,
-                                                      isoValue, EDGE7, vertices );
-
-                        if( exiting )
-                        {
-                            quads.emplace_back( i0, i1, i2, i3 );
-                        }
-                        else
-                        {
-                            quads.emplace_back( i0, i3, i2, i1 );
-                        }
-                    }
-                }
-            }
-        }
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
     }
 }
 
+/**
+ * @brief DualMC::build
+ * @param data
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param stats
+ */
+void DualMC::build( const uint8_t* data,
+                    const int32_t x, const int32_t y, const int32_t z,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    const bool generateSoup,
+                    std::vector<CompactVertex> & vertices,
+                    std::vector<Quad> & quads,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    LinearVolume linearVolume( data, x, y, z );
+    CellCodeVolume< LinearVolume > volume( linearVolume, x, y, z, isoValue, generateManifold, &_scratch );
+    _build( volume, x, y, z, isoValue, generateManifold, generateSoup,
+            vertices, quads, nullptr );
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
 
-void DualMC::_buildQuadSoup(uint8_t const isoValue,
-    std::vector<Vertex> & vertices,
-    std::vector<Quad> & quads
-    ) {
-
-    int32_t const reducedX = _volumeDimensions[0] - 2;
-    int32_t const reducedY = _volumeDimensions[1] - 2;
-    int32_t const reducedZ = _volumeDimensions[2] - 2;
-
-    Vertex vertex0;
-    Vertex vertex1;
-    Vertex vertex2;
-    Vertex vertex3;
-    int pointCode;
-
-    // iterate voxels
-    for(int32_t z = 0; z < reducedZ; ++z)
-        for(int32_t y = 0; y < reducedY; ++y)
-            for(int32_t x = 0; x < reducedX; ++x) {
-                // construct quad for x edge
-                if(z > 0 && y > 0) {
-                    // is edge intersected?
-                    bool const entering = _volumeGrid[_index(x,y,z)] < isoValue && _volumeGrid[_index(x+1,y,z)] >= isoValue;
-                    bool const exiting  = _volumeGrid[_index(x,y,z)] >= isoValue && _volumeGrid[_index(x+1,y,z)] < isoValue;
-                    if(entering || exiting){
-                        // generate quad
-                        pointCode = _getDualPointCode(x,y,z,isoValue,EDGE0);
-                        _calculateDualPoint(x,y,z,isoValue,pointCode, vertex0);
-
-                        pointCode = _getDualPointCode(x,y,z-1,isoValue,EDGE2);
-                        _calculateDualPoint(x,y,z-1,isoValue,pointCode, vertex1);
-
-                        pointCode = _getDualPointCode(x,y-1,z-1,isoValue,EDGE6);
-                        _calculateDualPoint(x,y-1,z-1,isoValue,pointCode, vertex2);
-
-                        pointCode = _getDualPointCode(x,y-1,z,isoValue,EDGE4);
-                        _calculateDualPoint(x,y-1,z,isoValue,pointCode, vertex3);
-
-                        if(entering) {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex1);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex3);
-                        } else {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex3);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex1);
-                        }
-                    }
+/**
+ * @brief DualMC::build
+ * @param data
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param generateManifold
+ * @param vertices
+ * @param meshlets
+ * @param quads
+ * @param stats
+ */
+void DualMC::build( const uint8_t* data,
+                    const int32_t x, const int32_t y, const int32_t z,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    std::vector<Vertex> & vertices,
+                    MeshletMesh & meshlets,
+                    std::vector<Quad> * quads,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    DUALMC_STAT( _stats.reset() );
+    DUALMC_STAT( PhaseClock::time_point const phaseStart = PhaseClock::now() );
+
+    // Set up the members as for the sweep of the shared vertex build
+    _volumeDimensions[0] = x;
+    _volumeDimensions[1] = y;
+    _volumeDimensions[2] = z;
+    _generateManifold = generateManifold;
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        _cellBegin[ axis ] = 0;
+        _cellEnd[ axis ] = _volumeDimensions[ axis ] - 2;
+        _origin[ axis ] = 0;
+    }
+    vertices.clear();
+    if( quads )
+    {
+        quads->clear();
+    }
+
+    LinearVolume linearVolume( data, x, y, z );
+    CellCodeVolume< LinearVolume > volume( linearVolume, x, y, z, isoValue, generateManifold, &_scratch );
+    if( generateManifold )
+    {
+        _buildMeshlets< true >( volume, isoValue, vertices, meshlets, quads );
+    }
+    else
+    {
+        _buildMeshlets< false >( volume, isoValue, vertices, meshlets, quads );
+    }
+    DUALMC_STAT( _stats.phaseTimes[PHASE_EXTRACTION] = secondsSince( phaseStart ) );
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param data
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param boundaryPolicy
+ * @param exteriorValue
+ * @param vertices
+ * @param quads
+ * @param stats
+ */
+void DualMC::build( const uint8_t* data,
+                    const int32_t x, const int32_t y, const int32_t z,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    const bool generateSoup,
+                    const BOUNDARY_POLICY boundaryPolicy,
+                    const uint8_t exteriorValue,
+                    std::vector<Vertex> & vertices,
+                    std::vector<Quad> & quads,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    if( boundaryPolicy == BOUNDARY_NONE )
+    {
+        build( data, x, y, z, isoValue, generateManifold, generateSoup,
+               vertices, quads, stats );
+        return;
+    }
+
+    // Extract on the virtually padded volume
+    typedef BoundaryVolume< LinearVolume > PaddedVolume;
+    LinearVolume linearVolume( data, x, y, z );
+    PaddedVolume paddedVolume( linearVolume, x, y, z, boundaryPolicy, exteriorValue );
+    int32_t const paddedX = PaddedVolume::paddedDimension( x );
+    int32_t const paddedY = PaddedVolume::paddedDimension( y );
+    int32_t const paddedZ = PaddedVolume::paddedDimension( z );
+    CellCodeVolume< PaddedVolume > volume( paddedVolume, paddedX, paddedY, paddedZ,
+                                           isoValue, generateManifold, &_scratch );
+
+    // A periodic volume has as many edges as voxels along each axis. The
+    // edges of the first padded voxel layer repeat the last ones, so only
+    // the quads of the cells after it are extracted.
+    int32_t const periodicBegin[] = { 1, 1, 1 };
+    _build( volume, paddedX, paddedY, paddedZ, isoValue, generateManifold, generateSoup,
+            vertices, quads, nullptr,
+            boundaryPolicy == BOUNDARY_PERIODIC ? periodicBegin : nullptr );
+    if( boundaryPolicy == BOUNDARY_PERIODIC )
+    {
+        int32_t const dimensions[] = { x, y, z };
+        _wrapPeriodicPoints( dimensions, generateSoup, vertices, quads );
+    }
+
+    // Move the vertices back into the coordinate frame of the volume
+    for( Vertex & vertex : vertices )
+    {
+        vertex.x -= PaddedVolume::PADDING_BEGIN;
+        vertex.y -= PaddedVolume::PADDING_BEGIN;
+        vertex.z -= PaddedVolume::PADDING_BEGIN;
+    }
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param data
+ * @param x
+ * @param y
+ * @param z
+ * @param regionOffset
+ * @param regionExtent
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param stats
+ */
+void DualMC::build( const uint8_t* data,
+                    const int32_t x, const int32_t y, const int32_t z,
+                    const int32_t regionOffset[3],
+                    const int32_t regionExtent[3],
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    const bool generateSoup,
+                    std::vector<Vertex> & vertices,
+                    std::vector<Quad> & quads,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    // Cells with all corners inside the region
+    int32_t cellEnd[3];
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        cellEnd[ axis ] = regionOffset[ axis ] + regionExtent[ axis ] - 1;
+    }
+
+    // The cell codes of the full volume are not cached, as the region may be
+    // a small part of it
+    LinearVolume volume( data, x, y, z );
+    _build( volume, x, y, z, isoValue, generateManifold, generateSoup,
+            vertices, quads, nullptr, regionOffset, cellEnd );
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param data
+ * @param x
+ * @param y
+ * @param z
+ * @param seed
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param stats
+ */
+void DualMC::build( const uint8_t* data,
+                    const int32_t x, const int32_t y, const int32_t z,
+                    const int32_t seed[3],
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    const bool generateSoup,
+                    std::vector<Vertex> & vertices,
+                    std::vector<Quad> & quads,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    // The surface is tracked in no particular layer order, so cell codes are
+    // not cached
+    LinearVolume volume( data, x, y, z );
+    _build( volume, x, y, z, isoValue, generateManifold, generateSoup,
+            vertices, quads, nullptr, nullptr, nullptr, nullptr, seed );
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param brickData
+ * @param partition
+ * @param brick
+ * @param isoValue
+ * @param generateManifold
+ * @param mesh
+ * @param stats
+ */
+void DualMC::build( const uint8_t* brickData,
+                    const BrickPartition & partition,
+                    const int32_t brick,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    BrickMesh & mesh,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    // Sweep the owned cells in the coordinates of the brick data
+    int32_t offset[3], extent[3], cellBegin[3], cellEnd[3];
+    partition.dataRange( brick, offset, extent );
+    partition.cellRange( brick, cellBegin, cellEnd );
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        cellBegin[ axis ] -= offset[ axis ];
+        cellEnd[ axis ] -= offset[ axis ];
+    }
+
+    // The ghost layer clipped at the volume border leaves the manifold
+    // neighbor checks of the owned cells unchanged
+    mesh.clear();
+    LinearVolume linearVolume( brickData, extent[0], extent[1], extent[2] );
+    CellCodeVolume< LinearVolume > volume( linearVolume, extent[0], extent[1], extent[2],
+                                           isoValue, generateManifold, &_scratch );
+    _build( volume, extent[0], extent[1], extent[2], isoValue, generateManifold, false,
+            mesh.vertices, mesh.quads, nullptr, cellBegin, cellEnd, offset );
+
+    // Derive the global keys from the local keys of the shared vertices
+    uint64_t const volumeX = uint64_t( partition.dimension( 0 ));
+    uint64_t const volumeY = uint64_t( partition.dimension( 1 ));
+    mesh.keys.resize( mesh.vertices.size());
+    for( auto const & entry : pointToIndex )
+    {
+        int32_t const cell = entry.first.linearizedCellID;
+        uint64_t const x = uint64_t( cell % extent[0] + offset[0] );
+        uint64_t const y = uint64_t(( cell / extent[0] ) % extent[1] + offset[1] );
+        uint64_t const z = uint64_t( cell / ( extent[0] * extent[1] ) + offset[2] );
+        mesh.keys[ entry.second ] = globalDualPointKey( x + volumeX * ( y + volumeY * z ),
+                                                        entry.first.pointCode );
+    }
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param data
+ * @param index
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param stats
+ */
+void DualMC::build( const uint8_t* data,
+                    const SpanSpaceIndex & index,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    const bool generateSoup,
+                    std::vector<Vertex> & vertices,
+                    std::vector<Quad> & quads,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    // Query the cells intersecting the iso surface
+    DUALMC_STAT( PhaseClock::time_point const queryStart = PhaseClock::now() );
+    index.activeCells( isoValue, _activeCells );
+    DUALMC_STAT( double const queryTime = secondsSince( queryStart ));
+
+    int32_t const x = index.dimension( 0 );
+    int32_t const y = index.dimension( 1 );
+    int32_t const z = index.dimension( 2 );
+    LinearVolume volume( data, x, y, z );
+    _build( volume, x, y, z, isoValue, generateManifold, generateSoup,
+            vertices, quads, &_activeCells );
+    DUALMC_STAT( _stats.phaseTimes[PHASE_CELL_QUERY] = queryTime );
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param view
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param stats
+ */
+void DualMC::build( const StridedVolume & view,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    const bool generateSoup,
+                    std::vector<Vertex> & vertices,
+                    std::vector<Quad> & quads,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    int32_t const x = view.dimension( 0 );
+    int32_t const y = view.dimension( 1 );
+    int32_t const z = view.dimension( 2 );
+    StridedVolume stridedVolume( view );
+    CellCodeVolume< StridedVolume > volume( stridedVolume, x, y, z, isoValue, generateManifold, &_scratch );
+    _build( volume, x, y, z, isoValue, generateManifold, generateSoup,
+            vertices, quads, nullptr );
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param volume
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param stats
+ */
+void DualMC::build( const BrickedVolume & volume,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    const bool generateSoup,
+                    std::vector<Vertex> & vertices,
+                    std::vector<Quad> & quads,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    BrickedVolumeAccessor accessor( volume );
+    _build( accessor, volume.dimension( 0 ), volume.dimension( 1 ), volume.dimension( 2 ),
+            isoValue, generateManifold, generateSoup, vertices, quads, nullptr );
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param volume
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param stats
+ */
+void DualMC::build( const MortonVolume & volume,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    const bool generateSoup,
+                    std::vector<Vertex> & vertices,
+                    std::vector<Quad> & quads,
+                    BuildStats * stats )
+{
+    _resetScratch();
+    MortonVolumeAccessor accessor( volume );
+    _build( accessor, volume.dimension( 0 ), volume.dimension( 1 ), volume.dimension( 2 ),
+            isoValue, generateManifold, generateSoup, vertices, quads, nullptr );
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param sampler
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param generateManifold
+ * @param vertices
+ * @param quads
+ * @param layerCallback
+ * @param stats
+ * @param numThreads
+ */
+void DualMC::build( const RowSampler & sampler,
+                    const int32_t x, const int32_t y, const int32_t z,
+                    const uint8_t isoValue,
+                    const bool generateManifold,
+                    std::vector<Vertex> & vertices,
+                    std::vector<Quad> & quads,
+                    const LayerCallback & layerCallback,
+                    BuildStats * stats,
+                    const unsigned int numThreads )
+{
+    _buildImplicit( sampler, x, y, z, isoValue, generateManifold, false,
+                    vertices, quads, stats, numThreads, &layerCallback );
+}
+
+/**
+ * @brief DualMC::buildImplicit
+ * @param sampler
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param stats
+ * @param numThreads
+ * @param layerCallback
+ */
+void DualMC::_buildImplicit( const RowSampler & sampler,
+                             const int32_t x, const int32_t y, const int32_t z,
+                             const uint8_t isoValue,
+                             const bool generateManifold,
+                             const bool generateSoup,
+                             std::vector<Vertex> & vertices,
+                             std::vector<Quad> & quads,
+                             BuildStats * stats,
+                             const unsigned int numThreads,
+                             const LayerCallback * layerCallback )
+{
+    _resetScratch();
+    SliceRingVolume ringVolume( sampler, x, y, z, numThreads );
+    if( layerCallback )
+    {
+        // Hand out the mesh before each layer and once after the sweep
+        std::function< void() > const notify = [ & ]()
+        {
+            ( *layerCallback )( vertices, quads );
+        };
+        LayerNotifyingVolume< SliceRingVolume > notifyingVolume( ringVolume, notify );
+        CellCodeVolume< LayerNotifyingVolume< SliceRingVolume > > volume(
+                    notifyingVolume, x, y, z, isoValue, generateManifold, &_scratch );
+        _build( volume, x, y, z, isoValue, generateManifold, generateSoup,
+                vertices, quads, nullptr );
+        notify();
+    }
+    else
+    {
+        CellCodeVolume< SliceRingVolume > volume( ringVolume, x, y, z, isoValue, generateManifold, &_scratch );
+        _build( volume, x, y, z, isoValue, generateManifold, generateSoup,
+                vertices, quads, nullptr );
+    }
+
+    // Sampling happens interleaved with the extraction. Account for it
+    // separately.
+    DUALMC_STAT( _stats.phaseTimes[PHASE_SAMPLING] = ringVolume.samplingTime());
+    DUALMC_STAT( _stats.phaseTimes[PHASE_EXTRACTION] -= ringVolume.samplingTime());
+
+    // Hand out the statistics of this build
+    if( stats )
+    {
+        *stats = _stats;
+    }
+}
+
+/**
+ * @brief DualMC::build
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param generateManifold
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param activeCells
+ * @param cellBegin
+ * @param cellEnd
+ * @param origin
+ * @param seed
+ */
+template< class Volume, class VertexType >
+void DualMC::_build( Volume & volume,
+                     const int32_t x, const int32_t y, const int32_t z,
+                     const uint8_t isoValue,
+                     const bool generateManifold,
+                     const bool generateSoup,
+                     std::vector<VertexType> & vertices,
+                     std::vector<Quad> & quads,
+                     const std::vector< uint32_t > * activeCells,
+                     const int32_t * cellBegin,
+                     const int32_t * cellEnd,
+                     const int32_t * origin,
+                     const int32_t * seed )
+{
+    DUALMC_STAT( _stats.reset() );
+    DUALMC_STAT( PhaseClock::time_point phaseStart = PhaseClock::now() );
+
+    // Set members
+    this->_volumeDimensions[0] = x;
+    this->_volumeDimensions[1] = y;
+    this->_volumeDimensions[2] = z;
+    this->_generateManifold = generateManifold;
+
+    // The traversal only visits voxels up to dimension - 2 and processes the
+    // edges leaving them, so the edges between the last two voxel layers are
+    // skipped. Boundary policies compensate this with a virtual padding of
+    // one voxel before and two voxels after the volume, see BoundaryVolume.
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        int32_t const reduced = _volumeDimensions[ axis ] - 2;
+        _cellBegin[ axis ] = cellBegin ? std::max( cellBegin[ axis ], 0 ) : 0;
+        _cellEnd[ axis ] = cellEnd ? std::min( cellEnd[ axis ], reduced ) : reduced;
+        _origin[ axis ] = origin ? origin[ axis ] : 0;
+    }
+
+    // Clear vertices and quad indices
+    vertices.clear();
+    quads.clear();
+
+    DUALMC_STAT( _stats.phaseTimes[PHASE_SETUP] = secondsSince( phaseStart ) );
+    DUALMC_STAT( phaseStart = PhaseClock::now() );
+
+    // Generate quad soup or shared vertices quad list
+    if( generateManifold )
+    {
+        _extract< true >( volume, isoValue, generateSoup, vertices, quads, activeCells, seed );
+    }
+    else
+    {
+        _extract< false >( volume, isoValue, generateSoup, vertices, quads, activeCells, seed );
+    }
+
+    DUALMC_STAT( _stats.phaseTimes[PHASE_EXTRACTION] = secondsSince( phaseStart ) );
+
+    // Connect the quad soup vertices
+    if( generateSoup )
+    {
+        DUALMC_STAT( phaseStart = PhaseClock::now() );
+        _buildQuadSoupIndices( vertices, quads );
+        DUALMC_STAT( _stats.phaseTimes[PHASE_INDEXING] = secondsSince( phaseStart ) );
+    }
+}
+
+/**
+ * @brief DualMC::extract
+ * @param volume
+ * @param isoValue
+ * @param generateSoup
+ * @param vertices
+ * @param quads
+ * @param activeCells
+ * @param seed
+ */
+template< bool GenerateManifold, class Volume, class VertexType >
+void DualMC::_extract( Volume & volume,
+                       const uint8_t isoValue,
+                       const bool generateSoup,
+                       std::vector<VertexType> & vertices,
+                       std::vector<Quad> & quads,
+                       const std::vector< uint32_t > * activeCells,
+                       const int32_t * seed )
+{
+    if( generateSoup )
+    {
+        QuadSoupSink< VertexType > sink( *this, isoValue, vertices );
+        _extractQuads< GenerateManifold >( volume, isoValue, activeCells, seed, sink );
+    }
+    else
+    {
+        SharedVertexSink< VertexType > sink( *this, isoValue, vertices, quads );
+        _extractQuads< GenerateManifold >( volume, isoValue, activeCells, seed, sink );
+    }
+}
+
+/**
+ * @brief DualMC::extractQuads
+ * @param volume
+ * @param isoValue
+ * @param activeCells
+ * @param seed
+ * @param sink
+ */
+template< bool GenerateManifold, class Volume, class Sink >
+void DualMC::_extractQuads( Volume & volume,
+                            const uint8_t isoValue,
+                            const std::vector< uint32_t > * activeCells,
+                            const int32_t * seed,
+                            Sink & sink )
+{
+    if( seed )
+    {
+        _traverseSurfaceEdges< GenerateManifold >( volume, seed, isoValue,
+                               [ & ]( const int32_t x, const int32_t y, const int32_t z,
+                                      const int edgeMask )
+        {
+            _buildQuadsAt< GenerateManifold >( volume, x, y, z, isoValue, sink, edgeMask );
+        });
+    }
+    else
+    {
+        _traverseCells( volume, activeCells,
+                        [ & ]( const int32_t x, const int32_t y, const int32_t z )
+        {
+            _buildQuadsAt< GenerateManifold >( volume, x, y, z, isoValue, sink );
+        });
+    }
+}
+
+/**
+ * @brief DualMC::buildQuadsAt
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param sink
+ * @param edgeMask
+ */
+template< bool GenerateManifold, class Volume, class Sink >
+void DualMC::_buildQuadsAt( const Volume & volume,
+                            const int32_t x,
+                            const int32_t y,
+                            const int32_t z,
+                            const uint8_t isoValue,
+                            Sink & sink,
+                            const int edgeMask )
+{
+    // Skip voxels without intersected edges
+    int const corners = _getEdgeCornerCode( volume, x, y, z, isoValue );
+    if( corners == 0 || corners == 0x17 )
+    {
+        return;
+    }
+    bool const inside = ( corners & 1 ) != 0;
+
+    // Construct quad for x edge, which is flipped when exiting the surface
+    if(( edgeMask & 1 ) && z > 0 && y > 0 && inside != (( corners & 2 ) != 0 ))
+    {
+        DUALMC_STAT( ++_stats.crossingEdges[0] );
+        DUALMC_STAT( ++_stats.quadsEmitted );
+        _buildQuad< GenerateManifold >( volume, x, y, z, 0, isoValue, inside, sink );
+    }
+
+    // Construct quad for y edge, which is flipped when entering the surface
+    if(( edgeMask & 2 ) && z > 0 && x > 0 && inside != (( corners & 4 ) != 0 ))
+    {
+        DUALMC_STAT( ++_stats.crossingEdges[1] );
+        DUALMC_STAT( ++_stats.quadsEmitted );
+        _buildQuad< GenerateManifold >( volume, x, y, z, 1, isoValue, !inside, sink );
+    }
+
+    // Construct quad for z edge, which is flipped when entering the surface
+    if(( edgeMask & 4 ) && x > 0 && y > 0 && inside != (( corners & 16 ) != 0 ))
+    {
+        DUALMC_STAT( ++_stats.crossingEdges[2] );
+        DUALMC_STAT( ++_stats.quadsEmitted );
+        _buildQuad< GenerateManifold >( volume, x, y, z, 2, isoValue, !inside, sink );
+    }
+}
+
+/**
+ * @brief DualMC::buildQuad
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param axis
+ * @param isoValue
+ * @param flip
+ * @param sink
+ */
+template< bool GenerateManifold, class Volume, class Sink >
+void DualMC::_buildQuad( const Volume & volume,
+                         const int32_t x, const int32_t y, const int32_t z,
+                         const int axis,
+                         const uint8_t isoValue,
+                         const bool flip,
+                         Sink & sink )
+{
+    int32_t cells[4][3];
+    int pointCodes[4];
+    for( int k = 0; k < 4; ++k )
+    {
+        cells[k][0] = x + QUAD_CELL_OFFSETS[ axis ][k][0];
+        cells[k][1] = y + QUAD_CELL_OFFSETS[ axis ][k][1];
+        cells[k][2] = z + QUAD_CELL_OFFSETS[ axis ][k][2];
+        pointCodes[k] = _getDualPointCode( volume, cells[k][0], cells[k][1], cells[k][2], isoValue,
+                                           QUAD_CELL_EDGES[ axis ][k], ManifoldPolicy< GenerateManifold >());
+    }
+    sink.addQuad( volume, cells, pointCodes, flip );
+}
+
+/**
+ * @brief DualMC::buildMeshlets
+ * @param volume
+ * @param isoValue
+ * @param vertices
+ * @param meshlets
+ * @param quads
+ */
+template< bool GenerateManifold, class Volume >
+void DualMC::_buildMeshlets( Volume & volume,
+                             const uint8_t isoValue,
+                             std::vector<Vertex> & vertices,
+                             MeshletMesh & meshlets,
+                             std::vector<Quad> * quads )
+{
+    int32_t const tilesX = ( std::max( _cellEnd[0], 0 ) + MESHLET_TILE_SIZE - 1 ) / MESHLET_TILE_SIZE;
+    int32_t const tilesY = ( std::max( _cellEnd[1], 0 ) + MESHLET_TILE_SIZE - 1 ) / MESHLET_TILE_SIZE;
+    MeshletAssembler assembler( meshlets, tilesX * tilesY );
+
+    // The quads of a cell are collected in a small buffer, unless all quads
+    // are requested
+    std::vector<Quad> cellQuads;
+    std::vector<Quad> & output = quads ? *quads : cellQuads;
+    SharedVertexSink< Vertex > sink( *this, isoValue, vertices, output );
+    int32_t slab = 0;
+    _traverseCells( volume, nullptr, [ & ]( const int32_t x, const int32_t y, const int32_t z )
+    {
+        if( z / MESHLET_TILE_SIZE != slab )
+        {
+            assembler.flush( vertices );
+            slab = z / MESHLET_TILE_SIZE;
+        }
+
+        size_t const first = output.size();
+        _buildQuadsAt< GenerateManifold >( volume, x, y, z, isoValue, sink );
+        if( output.size() == first )
+        {
+            return;
+        }
+
+        int32_t const tile = x / MESHLET_TILE_SIZE + tilesX * ( y / MESHLET_TILE_SIZE );
+        for( size_t i = first; i < output.size(); ++i )
+        {
+            assembler.addQuad( tile, output[i], vertices );
+        }
+        if( !quads )
+        {
+            cellQuads.clear();
+        }
+    });
+    assembler.flush( vertices );
+}
+
+/**
+ * @brief DualMC::traverseCells
+ * @param volume
+ * @param activeCells
+ * @param function
+ */
+template< class Volume, class Function >
+void DualMC::_traverseCells( Volume & volume,
+                             const std::vector< uint32_t > * activeCells,
+                             const Function & function )
+{
+    // Iterate voxels
+    if( activeCells == nullptr )
+    {
+        for( int32_t z = _cellBegin[2]; z < _cellEnd[2]; ++z )
+        {
+            volume.prepareLayer( z );
+
+            for( int32_t y = _cellBegin[1]; y < _cellEnd[1]; ++y )
+            {
+                for( int32_t x = _cellBegin[0]; x < _cellEnd[0]; ++x )
+                {
+                    DUALMC_STAT( ++_stats.cellsVisited );
+                    function( x, y, z );
                 }
+            }
+        }
+        return;
+    }
 
-                // construct quad for y edge
-                if(z > 0 && x > 0) {
-                    // is edge intersected?
-                    bool const entering = _volumeGrid[_index(x,y,z)] < isoValue && _volumeGrid[_index(x,y+1,z)] >= isoValue;
-                    bool const exiting  = _volumeGrid[_index(x,y,z)] >= isoValue && _volumeGrid[_index(x,y+1,z)] < isoValue;
-                    if(entering || exiting){
-                        // generate quad
-                        pointCode = _getDualPointCode(x,y,z,isoValue,EDGE8);
-                        _calculateDualPoint(x,y,z,isoValue,pointCode, vertex0);
-
-                        pointCode = _getDualPointCode(x,y,z-1,isoValue,EDGE11);
-                        _calculateDualPoint(x,y,z-1,isoValue,pointCode, vertex1);
-
-                        pointCode = _getDualPointCode(x-1,y,z-1,isoValue,EDGE10);
-                        _calculateDualPoint(x-1,y,z-1,isoValue,pointCode, vertex2);
-
-                        pointCode = _getDualPointCode(x-1,y,z,isoValue,EDGE9);
-                        _calculateDualPoint(x-1,y,z,isoValue,pointCode, vertex3);
-
-                        if(exiting) {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex1);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex3);
-                        } else {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex3);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex1);
-                        }
-                    }
+    _traverseActiveCells( volume, *activeCells, function );
+}
+
+/**
+ * @brief DualMC::traverseActiveCells
+ * @param volume
+ * @param activeCells
+ * @param function
+ */
+template< class Volume, class Function >
+void DualMC::_traverseActiveCells( Volume & volume,
+                                   const std::vector< uint32_t > & activeCells,
+                                   const Function & function )
+{
+    int32_t const reducedX = _volumeDimensions[0] - 2;
+    int32_t const reducedY = _volumeDimensions[1] - 2;
+    int32_t const reducedZ = _volumeDimensions[2] - 2;
+
+    // Iterate only the given cells. Their edges are the only ones, which can
+    // intersect the iso surface. The cells are sorted by their linearized
+    // index, so voxel layers are still prepared in ascending order.
+    int32_t preparedLayer = -1;
+    for( uint32_t const cell : activeCells )
+    {
+        int32_t const x = int32_t( cell % uint32_t( _volumeDimensions[0] ));
+        int32_t const y = int32_t(( cell / uint32_t( _volumeDimensions[0] )) %
+                                  uint32_t( _volumeDimensions[1] ));
+        int32_t const z = int32_t( cell / ( uint32_t( _volumeDimensions[0] ) *
+                                            uint32_t( _volumeDimensions[1] )));
+        if( x >= reducedX || y >= reducedY || z >= reducedZ )
+        {
+            continue;
+        }
+
+        if( z != preparedLayer )
+        {
+            volume.prepareLayer( z );
+            preparedLayer = z;
+        }
+
+        DUALMC_STAT( ++_stats.cellsVisited );
+        function( x, y, z );
+    }
+}
+
+/**
+ * @brief DualMC::traverseSurfaceEdges
+ * @param volume
+ * @param seed
+ * @param isoValue
+ * @param function
+ */
+template< bool GenerateManifold, class Volume, class Function >
+void DualMC::_traverseSurfaceEdges( const Volume & volume,
+                                    const int32_t seed[3],
+                                    const uint8_t isoValue,
+                                    const Function & function )
+{
+    int32_t const extentX = _cellEnd[0] - _cellBegin[0];
+    int32_t const extentY = _cellEnd[1] - _cellBegin[1];
+    int32_t const extentZ = _cellEnd[2] - _cellBegin[2];
+    if( extentX <= 0 || extentY <= 0 || extentZ <= 0 )
+    {
+        return;
+    }
+    // The visited edges are kept in bitmaps of blocks of cells, which are
+    // only allocated once the surface reaches them
+    int32_t const blocksX = ( extentX + VISITED_BLOCK_SIZE - 1 ) / VISITED_BLOCK_SIZE;
+    int32_t const blocksY = ( extentY + VISITED_BLOCK_SIZE - 1 ) / VISITED_BLOCK_SIZE;
+    int32_t const blocksZ = ( extentZ + VISITED_BLOCK_SIZE - 1 ) / VISITED_BLOCK_SIZE;
+    _visitedBlocks.assign( size_t( blocksX ) * size_t( blocksY ) * size_t( blocksZ ), 0 );
+    _visitedEdges.clear();
+
+    // Queue an edge of the cell range, which has not been visited yet. The
+    // bitmap of a block holds three bits per cell for its x, y and z edge.
+    std::vector< QueuedEdge > queue;
+    auto const visit = [ & ]( const int32_t x, const int32_t y, const int32_t z, const int axis )
+    {
+        if( x < _cellBegin[0] || x >= _cellEnd[0] ||
+                y < _cellBegin[1] || y >= _cellEnd[1] ||
+                z < _cellBegin[2] || z >= _cellEnd[2] )
+        {
+            return;
+        }
+
+        int32_t const cx = x - _cellBegin[0];
+        int32_t const cy = y - _cellBegin[1];
+        int32_t const cz = z - _cellBegin[2];
+        uint32_t & block = _visitedBlocks[ size_t( cx / VISITED_BLOCK_SIZE ) + size_t( blocksX ) *
+                ( size_t( cy / VISITED_BLOCK_SIZE ) + size_t( blocksY ) * size_t( cz / VISITED_BLOCK_SIZE ))];
+        if( block == 0 )
+        {
+            _visitedEdges.resize( _visitedEdges.size() + VISITED_BLOCK_WORDS, 0 );
+            block = uint32_t( _visitedEdges.size() / VISITED_BLOCK_WORDS );
+        }
+
+        int32_t const cell = cx % VISITED_BLOCK_SIZE + VISITED_BLOCK_SIZE *
+                ( cy % VISITED_BLOCK_SIZE + VISITED_BLOCK_SIZE * ( cz % VISITED_BLOCK_SIZE ));
+        int32_t const bit = 3 * cell + axis;
+        uint64_t const mask = uint64_t( 1 ) << ( bit & 63 );
+        uint64_t & word = _visitedEdges[ size_t( block - 1 ) * VISITED_BLOCK_WORDS + size_t( bit >> 6 )];
+        if(( word & mask ) == 0 )
+        {
+            word |= mask;
+            queue.push_back( QueuedEdge{ x, y, z, axis } );
+        }
+    };
+
+    // Walk from the seed to the first x edge with a quad
+    if( seed[1] >= _cellBegin[1] && seed[1] < _cellEnd[1] &&
+            seed[2] >= _cellBegin[2] && seed[2] < _cellEnd[2] )
+    {
+        for( int32_t x = std::max( seed[0], _cellBegin[0] ); x < _cellEnd[0]; ++x )
+        {
+            if( _getQuadEdgeCode( volume, x, seed[1], seed[2], isoValue ) & 1 )
+            {
+                visit( x, seed[1], seed[2], 0 );
+                break;
+            }
+        }
+    }
+
+    // Grow the component breadth first over the edges of its quads
+    for( size_t next = 0; next < queue.size(); ++next )
+    {
+        QueuedEdge const edge = queue[ next ];
+        if(( _getQuadEdgeCode( volume, edge.x, edge.y, edge.z, isoValue ) & ( 1 << edge.axis )) == 0 )
+        {
+            continue;
+        }
+        DUALMC_STAT( ++_stats.cellsVisited );
+        function( edge.x, edge.y, edge.z, 1 << edge.axis );
+
+        // Every edge of the dual points of the quad has a quad of the
+        // same component
+        for( int corner = 0; corner < 4; ++corner )
+        {
+            int32_t const x = edge.x + QUAD_CELL_OFFSETS[ edge.axis ][ corner ][0];
+            int32_t const y = edge.y + QUAD_CELL_OFFSETS[ edge.axis ][ corner ][1];
+            int32_t const z = edge.z + QUAD_CELL_OFFSETS[ edge.axis ][ corner ][2];
+            int const pointCode = _getDualPointCode( volume, x, y, z, isoValue,
+                                                     QUAD_CELL_EDGES[ edge.axis ][ corner ],
+                                                     ManifoldPolicy< GenerateManifold >());
+            for( int pointEdge = 0; pointEdge < 12; ++pointEdge )
+            {
+                if( pointCode & ( 1 << pointEdge ))
+                {
+                    visit( x + EDGE_BASE_OFFSETS[ pointEdge ][0],
+                           y + EDGE_BASE_OFFSETS[ pointEdge ][1],
+                           z + EDGE_BASE_OFFSETS[ pointEdge ][2],
+                           EDGE_AXES[ pointEdge ] );
                 }
+            }
+        }
+    }
+}
+
+/**
+ * @brief DualMC::getQuadEdgeCode
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @return
+ */
+template< class Volume >
+int DualMC::_getQuadEdgeCode( const Volume & volume,
+                              const int32_t x, const int32_t y, const int32_t z,
+                              const uint8_t isoValue ) const
+{
+    // Same conditions as for the quads of _buildQuadsAt
+    int const corners = _getEdgeCornerCode( volume, x, y, z, isoValue );
+    bool const inside = ( corners & 1 ) != 0;
+    int code = 0;
+    if( z > 0 && y > 0 && inside != (( corners & 2 ) != 0 ))
+    {
+        code |= 1;
+    }
+    if( z > 0 && x > 0 && inside != (( corners & 4 ) != 0 ))
+    {
+        code |= 2;
+    }
+    if( x > 0 && y > 0 && inside != (( corners & 16 ) != 0 ))
+    {
+        code |= 4;
+    }
+    return code;
+}
 
-                // construct quad for z edge
-                if(x > 0 && y > 0) {
-                    // is edge intersected?
-                    bool const entering = _volumeGrid[_index(x,y,z)] < isoValue && _volumeGrid[_index(x,y,z+1)] >= isoValue;
-                    bool const exiting  = _volumeGrid[_index(x,y,z)] >= isoValue && _volumeGrid[_index(x,y,z+1)] < isoValue;
-                    if(entering || exiting){
-                        // generate quad
-                        pointCode = _getDualPointCode(x,y,z,isoValue,EDGE3);
-                        _calculateDualPoint(x,y,z,isoValue,pointCode, vertex0);
-
-                        pointCode = _getDualPointCode(x-1,y,z,isoValue,EDGE1);
-                        _calculateDualPoint(x-1,y,z,isoValue,pointCode, vertex1);
-
-                        pointCode = _getDualPointCode(x-1,y-1,z,isoValue,EDGE5);
-                        _calculateDualPoint(x-1,y-1,z,isoValue,pointCode, vertex2);
-
-                        pointCode = _getDualPointCode(x,y-1,z,isoValue,EDGE7);
-                        _calculateDualPoint(x,y-1,z,isoValue,pointCode, vertex3);
-
-                        if(exiting) {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex1);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex3);
-                        } else {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex3);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex1);
+/**
+ * @brief DualMC::traverseCells
+ * @param volume
+ * @param activeCells
+ * @param function
+ */
+template< class Function >
+void DualMC::_traverseCells( BrickedVolumeAccessor & volume,
+                             const std::vector< uint32_t > * activeCells,
+                             const Function & function )
+{
+    int32_t const reducedX = _volumeDimensions[0] - 2;
+    int32_t const reducedY = _volumeDimensions[1] - 2;
+    int32_t const reducedZ = _volumeDimensions[2] - 2;
+    int32_t const brickSize = volume.volume().brickSize();
+
+    // Iterate active cells, switching bricks as needed
+    if( activeCells != nullptr )
+    {
+        for( uint32_t const cell : *activeCells )
+        {
+            int32_t const x = int32_t( cell % uint32_t( _volumeDimensions[0] ));
+            int32_t const y = int32_t(( cell / uint32_t( _volumeDimensions[0] )) %
+                                      uint32_t( _volumeDimensions[1] ));
+            int32_t const z = int32_t( cell / ( uint32_t( _volumeDimensions[0] ) *
+                                                uint32_t( _volumeDimensions[1] )));
+            if( x >= reducedX || y >= reducedY || z >= reducedZ )
+            {
+                continue;
+            }
+
+            volume.selectBrick( x / brickSize, y / brickSize, z / brickSize );
+            DUALMC_STAT( ++_stats.cellsVisited );
+            function( x, y, z );
+        }
+        return;
+    }
+
+    // Iterate bricks and the voxels inside of each brick
+    for( int32_t bz = 0; bz * brickSize < reducedZ; ++bz )
+    {
+        int32_t const endZ = std::min( ( bz + 1 ) * brickSize, reducedZ );
+        for( int32_t by = 0; by * brickSize < reducedY; ++by )
+        {
+            int32_t const endY = std::min( ( by + 1 ) * brickSize, reducedY );
+            for( int32_t bx = 0; bx * brickSize < reducedX; ++bx )
+            {
+                int32_t const endX = std::min( ( bx + 1 ) * brickSize, reducedX );
+                volume.selectBrick( bx, by, bz );
+
+                for( int32_t z = bz * brickSize; z < endZ; ++z )
+                {
+                    for( int32_t y = by * brickSize; y < endY; ++y )
+                    {
+                        for( int32_t x = bx * brickSize; x < endX; ++x )
+                        {
+                            DUALMC_STAT( ++_stats.cellsVisited );
+                            function( x, y, z );
                         }
                     }
                 }
             }
+        }
+    }
+}
+
+/**
+ * @brief DualMC::traverseCells
+ * @param volume
+ * @param activeCells
+ * @param function
+ */
+template< class Function >
+void DualMC::_traverseCells( MortonVolumeAccessor & volume,
+                             const std::vector< uint32_t > * activeCells,
+                             const Function & function )
+{
+    if( activeCells != nullptr )
+    {
+        _traverseActiveCells( volume, *activeCells, function );
+        return;
+    }
+
+    int32_t const reduced[] =
+    {
+        _volumeDimensions[0] - 2, _volumeDimensions[1] - 2, _volumeDimensions[2] - 2
+    };
+    if( reduced[0] <= 0 || reduced[1] <= 0 || reduced[2] <= 0 )
+    {
+        return;
+    }
+
+    int const bits[] =
+    {
+        volume.volume().bits( 0 ), volume.volume().bits( 1 ), volume.volume().bits( 2 )
+    };
+    int const maxBits = std::max( bits[0], std::max( bits[1], bits[2] ));
+    _traverseMortonBlock( maxBits - 1, 0, 0, 0, reduced, bits, function );
+}
+
+/**
+ * @brief DualMC::traverseMortonBlock
+ * @param bit
+ * @param x
+ * @param y
+ * @param z
+ * @param reduced
+ * @param bits
+ * @param function
+ */
+template< class Function >
+void DualMC::_traverseMortonBlock( const int bit,
+                                   const int32_t x, const int32_t y, const int32_t z,
+                                   const int32_t reduced[3], const int bits[3],
+                                   const Function & function )
+{
+    // Skip blocks without cells
+    if( x >= reduced[0] || y >= reduced[1] || z >= reduced[2] )
+    {
+        return;
+    }
+
+    if( bit < 0 )
+    {
+        DUALMC_STAT( ++_stats.cellsVisited );
+        function( x, y, z );
+        return;
+    }
+
+    // Split the axes, which still have coordinate bits at this level
+    int32_t const stepX = bit < bits[0] ? int32_t( 1 ) << bit : 0;
+    int32_t const stepY = bit < bits[1] ? int32_t( 1 ) << bit : 0;
+    int32_t const stepZ = bit < bits[2] ? int32_t( 1 ) << bit : 0;
+    for( int32_t cz = 0; cz <= stepZ; cz += std::max( stepZ, 1 ))
+    {
+        for( int32_t cy = 0; cy <= stepY; cy += std::max( stepY, 1 ))
+        {
+            for( int32_t cx = 0; cx <= stepX; cx += std::max( stepX, 1 ))
+            {
+                _traverseMortonBlock( bit - 1, x + cx, y + cy, z + cz,
+                                      reduced, bits, function );
+            }
+        }
+    }
+}
 
+/**
+ * @brief DualMC::buildQuadSoupIndices
+ * @param vertices
+ * @param quads
+ */
+template< class VertexType >
+void DualMC::_buildQuadSoupIndices( const std::vector<VertexType> & vertices,
+                                    std::vector<Quad> & quads ) const
+{
     // generate triangle soup quads
     size_t const numQuads = vertices.size() / 4;
     quads.reserve(numQuads);
@@ -2,13 +2,29 @@
 #define DUALMC_H_INCLUDED
 
 // C includes
+#include <cstddef>
 #include <cstdint>
 
 // STL includes
+#include <functional>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "arena.h"
+#include "boundaryvolume.h"
+#include "brickedvolume.h"
+#include "brickmesh.h"
+#include "brickpartition.h"
+#include "buildstats.h"
+#include "cellcodevolume.h"
+#include "compactvertex.h"
+#include "meshcomponents.h"
+#include "meshlet.h"
+#include "mortonvolume.h"
 #include "quad.h"
+#include "spanspaceindex.h"
+#include "stridedvolume.h"
 #include "vertex.h"
 #include "tables.h"
 
@@ -31,6 +47,29 @@ class DualMC
 {
 public:
 
+    /// Builder without a mesh
+    DualMC();
+
+    /**
+     * @brief DualMC
+     * Copies and moves take the shared vertices over into a scratch arena
+     * of their own, as the hash map of the builder refers to its arena.
+     * @param other
+     */
+    DualMC( const DualMC & other );
+    DualMC( DualMC && other );
+
+    DualMC & operator=( const DualMC & other );
+    DualMC & operator=( DualMC && other );
+
+    /**
+     * @brief setHugePages
+     * Back the scratch memory of the builder by transparent huge pages,
+     * which pays off for large volumes.
+     * @param enable
+     */
+    void setHugePages( const bool enable );
+
     /**
      * @brief build
      * Extracts the iso surface for a given volume and iso value.
@@ -47,36 +86,711 @@ public:
      * @param generateSoup
      * @param vertices
      * @param quads
+     * @param stats
+     * Optional statistics output. Counters are only gathered if the builder
+     * is compiled with DUALMC_ENABLE_STATS.
      */
     void build( const uint8_t* volumeGrid,
                 int32_t const x, int32_t const y, int32_t const z,
                 uint8_t const isoValue,
                 bool const _generateManifold, bool const generateSoup,
-                std::vector<Vertex> & vertices, std::vector<Quad> & quads );
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface for a given volume and iso value without its
+     * small connected components. The components are labeled during the
+     * extraction by joining the quads of each voxel layer right after the
+     * layer is done. A component is finished, once a layer adds no quad to
+     * it. Its quads are then appended to the output, or dropped if it is
+     * below the filter limits, so dropped quads are never written to the
+     * output. The vertices of the sweep are kept until the sweep is done,
+     * because the shared dual points refer to them by index. The mesh uses
+     * shared vertices and has the quads of the full build with
+     * filterComponents, up to their order.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     * @param filter
+     * @param vertices
+     * @param quads
+     * @param stats
+     */
+    void build( const uint8_t* volumeGrid,
+                int32_t const x, int32_t const y, int32_t const z,
+                uint8_t const isoValue,
+                bool const generateManifold,
+                const ComponentFilter & filter,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface for a given volume and iso value into compact
+     * vertices, which store the cell of each dual point and its quantized
+     * offset inside of the cell in 64 bits. The mesh is the same as for the
+     * build with float vertices up to the quantization. Use decodeVertices
+     * with the volume dimensions to obtain float vertices.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param stats
+     */
+    void build( const uint8_t* volumeGrid,
+                int32_t const x, int32_t const y, int32_t const z,
+                uint8_t const isoValue,
+                bool const generateManifold, bool const generateSoup,
+                std::vector<CompactVertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface for a given volume and iso value into
+     * meshlets with shared vertices. While sweeping the cells, each quad is
+     * split into two triangles and added to the open meshlet of the tile of
+     * cells around its edge, so meshlets are spatially coherent without a
+     * separate clustering pass. Dense quad indices are only generated on
+     * request.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     * @param vertices
+     * @param meshlets
+     * Output meshlets, built with the limits given in the mesh.
+     * @param quads
+     * Optional output of the dense quad indices.
+     * @param stats
+     */
+    void build( const uint8_t* volumeGrid,
+                int32_t const x, int32_t const y, int32_t const z,
+                uint8_t const isoValue,
+                bool const generateManifold,
+                std::vector<Vertex> & vertices, MeshletMesh & meshlets,
+                std::vector<Quad> * quads = nullptr,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface for a given volume and iso value with a
+     * boundary policy for the voxels outside of the volume. Except for
+     * BOUNDARY_NONE, all edges with at least one voxel inside the volume are
+     * processed, so surfaces leaving the volume are closed by a constant
+     * exterior or continue into the clamped exterior. A periodic volume
+     * wraps around, its mesh is closed on the torus with vertex coordinates
+     * between 0 and the dimension. The exterior is padded virtually without
+     * copying the volume. Vertex coordinates are relative to the volume
+     * origin as usual.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param boundaryPolicy
+     * @param exteriorValue
+     * Value of the exterior voxels for BOUNDARY_CONSTANT.
+     * @param vertices
+     * @param quads
+     * @param stats
+     */
+    void build( const uint8_t* volumeGrid,
+                int32_t const x, int32_t const y, int32_t const z,
+                uint8_t const isoValue,
+                bool const generateManifold, bool const generateSoup,
+                BOUNDARY_POLICY const boundaryPolicy, uint8_t const exteriorValue,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface inside a region of interest of a given volume
+     * without copying the region. Only cells with all corners inside the
+     * region are visited. Dual points are computed in the full volume, so
+     * vertices are in global coordinates and match the full build at the
+     * region border. Regions sharing one voxel layer with their neighbors
+     * tile the mesh of the full build.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param regionOffset
+     * First voxel of the region.
+     * @param regionExtent
+     * Number of voxels of the region along each axis.
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param stats
+     */
+    void build( const uint8_t* volumeGrid,
+                int32_t const x, int32_t const y, int32_t const z,
+                const int32_t regionOffset[3], const int32_t regionExtent[3],
+                uint8_t const isoValue,
+                bool const generateManifold, bool const generateSoup,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts only the connected component of the iso surface around a seed
+     * voxel, for example a single organ or molecule in a larger volume.
+     * Starting at the seed, the voxels are walked along +x up to the first
+     * edge crossing the surface. From there, the surface is tracked from quad
+     * to quad through their shared dual points, while bitmaps allocated per
+     * block of cells mark the visited edges. The extraction time is thus
+     * proportional to the area of the component instead of the volume. The
+     * quads are the quads of the component in the full build, up to their
+     * order. The mesh is empty, if no surface is hit.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param seed
+     * Seed voxel inside of or in front of the component along +x.
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param stats
+     */
+    void build( const uint8_t* volumeGrid,
+                int32_t const x, int32_t const y, int32_t const z,
+                const int32_t seed[3],
+                uint8_t const isoValue,
+                bool const generateManifold, bool const generateSoup,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface of one brick of a partitioned volume, given
+     * only the voxels of the brick and its ghost layer. Bricks can thus be
+     * meshed by separate processes, each holding a part of the volume. Only
+     * the quads of the cells owned by the brick are generated. Vertices are
+     * in the coordinates of the full volume and carry their global dual
+     * point key, so stitchBrickMeshes merges the bricks into the mesh of the
+     * full build.
+     * @param brickGrid
+     * Voxels of the data range of the brick in linear x-fastest layout, see
+     * BrickPartition::copyBrickData.
+     * @param partition
+     * @param brick
+     * @param isoValue
+     * @param generateManifold
+     * @param mesh
+     * @param stats
+     */
+    void build( const uint8_t* brickGrid,
+                const BrickPartition & partition, int32_t const brick,
+                uint8_t const isoValue,
+                bool const generateManifold,
+                BrickMesh & mesh,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface for a given volume and iso value, visiting
+     * only the cells which a precomputed span space index reports as
+     * intersecting the iso surface. The output is identical to the full
+     * build, but the extraction time is proportional to the number of
+     * active cells. The index has to be built for the given volume.
+     * @param volumeGrid
+     * @param index
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param stats
+     */
+    void build( const uint8_t* volumeGrid,
+                const SpanSpaceIndex & index,
+                uint8_t const isoValue,
+                bool const generateManifold, bool const generateSoup,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface for a volume view with explicit strides. The
+     * voxels are read in place, so volumes with padded rows or slices and
+     * single channels of interleaved voxels need no repacking. The output is
+     * identical to the build for the equivalent dense volume.
+     * @param view
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param stats
+     */
+    void build( const StridedVolume & view,
+                uint8_t const isoValue,
+                bool const generateManifold, bool const generateSoup,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface for a bricked volume and iso value. The cells
+     * are traversed brick by brick, so voxel accesses stay local to a brick.
+     * The output describes the same surface as the build for the linear
+     * volume, but vertices and quads are ordered by bricks.
+     * @param volume
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param stats
+     */
+    void build( const BrickedVolume & volume,
+                uint8_t const isoValue,
+                bool const generateManifold, bool const generateSoup,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface for a volume in Morton order and an iso value.
+     * The cells are traversed along the Z-order curve, so consecutive cells
+     * are neighbors on all scales. The output describes the same surface as
+     * the build for the linear volume, but vertices and quads are ordered
+     * along the curve.
+     * @param volume
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param stats
+     */
+    void build( const MortonVolume & volume,
+                uint8_t const isoValue,
+                bool const generateManifold, bool const generateSoup,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr );
+
+    /**
+     * @brief build
+     * Extracts the iso surface of an implicit volume, which is given by a
+     * sampling functor uint8_t sampler( int32_t x, int32_t y, int32_t z ).
+     * No volume is materialized. Instead the functor is evaluated slice by
+     * slice into a small rolling buffer right before the extraction reaches
+     * the slice, so memory scales with x * y. Each grid point is evaluated
+     * exactly once.
+     * @param sampler
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param stats
+     * @param numThreads
+     * Number of threads sampling the rows of a slice in parallel. The
+     * sampler has to be thread safe for more than one thread. Zero uses all
+     * hardware threads.
+     */
+    template< class Sampler,
+              class = typename std::enable_if< !std::is_pointer< Sampler >::value >::type >
+    void build( const Sampler & sampler,
+                int32_t const x, int32_t const y, int32_t const z,
+                uint8_t const isoValue,
+                bool const generateManifold, bool const generateSoup,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                BuildStats * stats = nullptr,
+                unsigned int const numThreads = 1 )
+    {
+        // Sample whole rows to keep the indirection out of the voxel loop
+        _buildImplicit( [ &sampler, x ]( const int32_t y, const int32_t z, uint8_t * row )
+                        {
+                            for( int32_t i = 0; i < x; ++i )
+                            {
+                                row[ i ] = sampler( i, y, z );
+                            }
+                        },
+                        x, y, z, isoValue, generateManifold, generateSoup,
+                        vertices, quads, stats, numThreads );
+    }
+
+    /**
+     * @brief RowSampler
+     * Function filling the voxel row at ( y, z ) of an implicit volume.
+     */
+    typedef std::function< void( int32_t y, int32_t z, uint8_t * row ) > RowSampler;
+
+    /**
+     * @brief LayerCallback
+     * Function notified during a streamed build whenever the cells of
+     * another voxel layer are processed, with the mesh extracted so far.
+     */
+    typedef std::function< void( const std::vector<Vertex> & vertices,
+                                 const std::vector<Quad> & quads ) > LayerCallback;
+
+    /**
+     * @brief build
+     * Extracts the iso surface of a volume, which is streamed slice by slice
+     * through a row sampler, while the mesh is consumed layer by layer. Rows
+     * are sampled in ascending slices right before the extraction reaches
+     * them, so the sampler may wait for slices still being loaded. Vertices
+     * and quads are only appended during the sweep, and quads only reference
+     * vertices appended before them. Whenever a voxel layer is done, the
+     * layer callback can thus hand the new vertices and quads to a consumer,
+     * for example a writer thread, while the extraction continues. The
+     * callback is called on the extracting thread and a final time after
+     * the sweep. The mesh always uses shared vertices.
+     * @param sampler
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     * @param vertices
+     * @param quads
+     * @param layerCallback
+     * @param stats
+     * @param numThreads
+     * Number of threads sampling the rows of a slice in parallel.
+     */
+    void build( const RowSampler & sampler,
+                int32_t const x, int32_t const y, int32_t const z,
+                uint8_t const isoValue,
+                bool const generateManifold,
+                std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                const LayerCallback & layerCallback,
+                BuildStats * stats = nullptr,
+                unsigned int const numThreads = 1 );
 
 private:
 
     /**
-     * @brief _buildSharedVerticesQuads
-     * Extract quad mesh with shared vertex indices.
-     * @param iso
+     * @brief _buildImplicit
+     * Extract the iso surface of an implicit volume given by a row sampler.
+     * @param sampler
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param stats
+     * @param numThreads
+     * @param layerCallback
+     * Optional function notified whenever a voxel layer is done.
+     */
+    void _buildImplicit( const RowSampler & sampler,
+                         int32_t const x, int32_t const y, int32_t const z,
+                         uint8_t const isoValue,
+                         bool const generateManifold, bool const generateSoup,
+                         std::vector<Vertex> & vertices, std::vector<Quad> & quads,
+                         BuildStats * stats,
+                         unsigned int const numThreads,
+                         const LayerCallback * layerCallback = nullptr );
+
+    /**
+     * @brief _build
+     * Common build implementation for all volume accessors. A volume
+     * accessor returns the voxel value for operator()( x, y, z ) and is
+     * notified with prepareLayer( z ) before a voxel layer is processed.
+     * The vertex type is either Vertex or CompactVertex.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     * @param activeCells
+     * Optional sorted list of linearized cells to visit instead of all cells.
+     * @param cellBegin
+     * @param cellEnd
+     * Optional cell range [cellBegin, cellEnd) to visit instead of all cells.
+     * @param origin
+     * Optional position of the volume inside of a larger volume, which is
+     * added to the vertex coordinates.
+     * @param seed
+     * Optional seed voxel, only the surface component around it is tracked.
+     */
+    template< class Volume, class VertexType >
+    void _build( Volume & volume,
+                 int32_t const x, int32_t const y, int32_t const z,
+                 uint8_t const isoValue,
+                 bool const generateManifold, bool const generateSoup,
+                 std::vector<VertexType> & vertices, std::vector<Quad> & quads,
+                 const std::vector< uint32_t > * activeCells,
+                 const int32_t * cellBegin = nullptr,
+                 const int32_t * cellEnd = nullptr,
+                 const int32_t * origin = nullptr,
+                 const int32_t * seed = nullptr );
+
+    /// Compile-time choice of the plain or the manifold dual point codes
+    template< bool GenerateManifold >
+    using ManifoldPolicy = std::integral_constant< bool, GenerateManifold >;
+
+    /**
+     * @brief The SharedVertexSink class
+     * Output of the extraction kernel, which appends quads with shared
+     * vertex indices.
+     */
+    template< class VertexType >
+    class SharedVertexSink;
+
+    /**
+     * @brief The QuadSoupSink class
+     * Output of the extraction kernel, which appends the four vertices of
+     * each quad.
+     */
+    template< class VertexType >
+    class QuadSoupSink;
+
+    /**
+     * @brief _extract
+     * Extract the surface into a quad soup or a quad mesh with shared vertex
+     * indices. The mode is resolved here once, so the kernel is instantiated
+     * without mode branches.
+     * @param volume
+     * @param isoValue
+     * @param generateSoup
      * @param vertices
      * @param quads
+     * @param activeCells
+     * @param seed
+     */
+    template< bool GenerateManifold, class Volume, class VertexType >
+    void _extract( Volume & volume,
+                   const uint8_t isoValue,
+                   const bool generateSoup,
+                   std::vector<VertexType> & vertices,
+                   std::vector<Quad> & quads,
+                   const std::vector< uint32_t > * activeCells,
+                   const int32_t * seed );
+
+    /**
+     * @brief _extractQuads
+     * Run the extraction kernel on all cells, the active cells or the surface
+     * component around a seed voxel.
+     * @param volume
+     * @param isoValue
+     * @param activeCells
+     * @param seed
+     * @param sink
+     */
+    template< bool GenerateManifold, class Volume, class Sink >
+    void _extractQuads( Volume & volume,
+                        const uint8_t isoValue,
+                        const std::vector< uint32_t > * activeCells,
+                        const int32_t * seed,
+                        Sink & sink );
+
+    /**
+     * @brief _buildQuadsAt
+     * Extraction kernel, which passes the quads of the three edges starting
+     * at voxel ( x, y, z ) to the sink.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param sink
+     * @param edgeMask
+     * Edges to process, bit a for the edge along axis a.
+     */
+    template< bool GenerateManifold, class Volume, class Sink >
+    void _buildQuadsAt( const Volume & volume,
+                        const int32_t x,
+                        const int32_t y,
+                        const int32_t z,
+                        const uint8_t isoValue,
+                        Sink & sink,
+                        const int edgeMask = 0x7 );
+
+    /**
+     * @brief _buildQuad
+     * Compute the dual point codes of the four cells around the edge along
+     * the axis starting at voxel ( x, y, z ) and pass the quad to the sink.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
+     * @param axis
+     * @param isoValue
+     * @param flip
+     * Whether the quad is oriented against the order of the cells.
+     * @param sink
+     */
+    template< bool GenerateManifold, class Volume, class Sink >
+    void _buildQuad( const Volume & volume,
+                     const int32_t x, const int32_t y, const int32_t z,
+                     const int axis,
+                     const uint8_t isoValue,
+                     const bool flip,
+                     Sink & sink );
+
+    /**
+     * @brief _buildMeshlets
+     * Extract meshlets with shared vertex indices. The cells are grouped into
+     * cubic tiles, each with an open meshlet, and the open meshlets are
+     * closed whenever the sweep leaves a slab of tiles.
+     * @param volume
+     * @param isoValue
+     * @param vertices
+     * @param meshlets
+     * @param quads
+     * Optional output of the dense quad indices.
+     */
+    template< bool GenerateManifold, class Volume >
+    void _buildMeshlets( Volume & volume,
+                         const uint8_t isoValue,
+                         std::vector<Vertex> & vertices,
+                         MeshletMesh & meshlets,
+                         std::vector<Quad> * quads );
+
+    /**
+     * @brief _traverseCells
+     * Call function( x, y, z ) for all cells, whose edges are processed. If
+     * a list of active cells is given, only these cells are visited.
+     * @param volume
+     * @param activeCells
+     * @param function
+     */
+    template< class Volume, class Function >
+    void _traverseCells( Volume & volume,
+                         const std::vector< uint32_t > * activeCells,
+                         const Function & function );
+
+    /**
+     * @brief _traverseCells
+     * Call function( x, y, z ) for all cells of a bricked volume brick by
+     * brick, selecting the brick of the cells in the accessor. Active cells
+     * are visited in the given order.
+     * @param volume
+     * @param activeCells
+     * @param function
+     */
+    template< class Function >
+    void _traverseCells( BrickedVolumeAccessor & volume,
+                         const std::vector< uint32_t > * activeCells,
+                         const Function & function );
+
+    /**
+     * @brief _traverseCells
+     * Call function( x, y, z ) for all cells of a volume in Morton order
+     * along the Z-order curve.
+     * @param volume
+     * @param activeCells
+     * @param function
+     */
+    template< class Function >
+    void _traverseCells( MortonVolumeAccessor & volume,
+                         const std::vector< uint32_t > * activeCells,
+                         const Function & function );
+
+    /**
+     * @brief _traverseMortonBlock
+     * Recursively visit the cells of a block along the Z-order curve.
+     * Children are split along the axes with coordinate bits left at the
+     * given bit level and visited in the order x, y, z.
+     * @param bit
+     * Bit level of the block, the block spans 2^( bit + 1 ) voxels along
+     * each axis with bits left.
+     * @param x
+     * @param y
+     * @param z
+     * @param reduced
+     * Number of cells to visit along each axis.
+     * @param bits
+     * Number of coordinate bits of each axis.
+     * @param function
+     */
+    template< class Function >
+    void _traverseMortonBlock( const int bit,
+                               const int32_t x, const int32_t y, const int32_t z,
+                               const int32_t reduced[3], const int bits[3],
+                               const Function & function );
+
+    /**
+     * @brief _traverseActiveCells
+     * Call function( x, y, z ) for the given sorted active cells in
+     * ascending order, preparing their voxel layers.
+     * @param volume
+     * @param activeCells
+     * @param function
+     */
+    template< class Volume, class Function >
+    void _traverseActiveCells( Volume & volume,
+                               const std::vector< uint32_t > & activeCells,
+                               const Function & function );
+
+    /**
+     * @brief _traverseSurfaceEdges
+     * Call function( x, y, z, edgeMask ) for the edges of the surface
+     * component around a seed voxel, where the mask selects a single edge
+     * starting at voxel ( x, y, z ). The edges are visited in breadth first
+     * order from the first crossing x edge along +x from the seed. The
+     * neighbors of an edge are all edges of the dual points of its quad. The
+     * voxel layers of the volume are not prepared, so the volume has to be
+     * randomly accessible.
+     * @param volume
+     * @param seed
+     * @param isoValue
+     * @param function
      */
-    void _buildSharedVerticesQuads( const uint8_t iso,
-                                   std::vector<Vertex> & vertices,
-                                   std::vector<Quad> & quads );
+    template< bool GenerateManifold, class Volume, class Function >
+    void _traverseSurfaceEdges( const Volume & volume,
+                                const int32_t seed[3],
+                                const uint8_t isoValue,
+                                const Function & function );
 
     /**
-     * @brief _buildQuadSoup
-     * Extract quad soup.
+     * @brief _getQuadEdgeCode
+     * Get the mask of the edges starting at voxel ( x, y, z ), which cross
+     * the iso surface and have a quad. Bit a is set for the edge along axis a.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
      * @param isoValue
+     * @return
+     */
+    template< class Volume >
+    int _getQuadEdgeCode( const Volume & volume,
+                          const int32_t x, const int32_t y, const int32_t z,
+                          const uint8_t isoValue ) const;
+
+    /**
+     * @brief _buildQuadSoupIndices
+     * Generate the quad indices for the four consecutive vertices of each
+     * quad in the soup.
      * @param vertices
      * @param quads
      */
-    void _buildQuadSoup( const uint8_t isoValue,
-                        std::vector<Vertex> & vertices,
-                        std::vector<Quad> & quads );
+    template< class VertexType >
+    void _buildQuadSoupIndices( const std::vector<VertexType> & vertices,
+                                std::vector<Quad> & quads ) const;
 
 private:
 
@@ -84,15 +798,52 @@ private:
      * @brief _getCellCode
      * Get the 8-bit in-out mask for the voxel corners of the cell cube at
      * ( x, y, z ) and the given iso value.
+     * @param volume
      * @param x
      * @param y
      * @param z
      * @param isoValue
      * @return
      */
-    int _getCellCode( const int32_t x, const int32_t y, const int32_t z,
+    template< class Volume >
+    int _getCellCode( const Volume & volume,
+                      const int32_t x, const int32_t y, const int32_t z,
                       const uint8_t isoValue ) const;
 
+    /**
+     * @brief _getEdgeCornerCode
+     * Get the in-out mask of the cell corners 0, 1, 2 and 4 of the cell cube
+     * at ( x, y, z ), which are the end points of the three edges starting
+     * at voxel ( x, y, z ). Bits are at the same positions as in the cell
+     * code.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @return
+     */
+    template< class Volume >
+    int _getEdgeCornerCode( const Volume & volume,
+                            const int32_t x, const int32_t y, const int32_t z,
+                            const uint8_t isoValue ) const;
+
+    /**
+     * @brief _getEdgeCornerCode
+     * Get the edge corner mask from the precomputed cell code, masked to
+     * the corners 0, 1, 2 and 4.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @return
+     */
+    template< class Volume >
+    int _getEdgeCornerCode( const CellCodeVolume< Volume > & volume,
+                            const int32_t x, const int32_t y, const int32_t z,
+                            const uint8_t isoValue ) const;
+
     /**
      * @brief _getDualPointCode
      * Get the 12-bit dual point code mask, which encodes the traditional
@@ -100,6 +851,26 @@ private:
      * corresponds to the dual point.
      * This is also where the manifold dual marching cubes algorithm is
      * implemented.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param edge
+     * @return
+     */
+    template< class Volume, bool GenerateManifold >
+    int _getDualPointCode( const Volume & volume,
+                           const int32_t x, const int32_t y, const int32_t z,
+                           const uint8_t isoValue,
+                           const DMC_EDGE_CODE edge,
+                           ManifoldPolicy< GenerateManifold > ) const;
+
+    /**
+     * @brief _getDualPointCode
+     * Get the 12-bit dual point code mask from the precomputed effective
+     * cube code of the cell.
+     * @param volume
      * @param x
      * @param y
      * @param z
@@ -107,13 +878,35 @@ private:
      * @param edge
      * @return
      */
-    int _getDualPointCode( const int32_t x, const int32_t y, const int32_t z,
+    template< class Volume, bool GenerateManifold >
+    int _getDualPointCode( const CellCodeVolume< Volume > & volume,
+                           const int32_t x, const int32_t y, const int32_t z,
                            const uint8_t isoValue,
-                           const DMC_EDGE_CODE edge ) const;
+                           const DMC_EDGE_CODE edge,
+                           ManifoldPolicy< GenerateManifold > ) const;
+
+    /**
+     * @brief _calculateDualPointOffset
+     * Given a dual point code and iso value, compute the offset of the dual
+     * point inside of its cell.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param pointCode
+     * @param p
+     */
+    template< class Volume >
+    void _calculateDualPointOffset( const Volume & volume,
+                                    const int32_t x, const int32_t y, const int32_t z,
+                                    uint8_t const isoValue, int const pointCode,
+                                    Vertex &p ) const;
 
     /**
      * @brief _calculateDualPoint
      * Given a dual point code and iso value, compute the dual point.
+     * @param volume
      * @param x
      * @param y
      * @param z
@@ -121,29 +914,81 @@ private:
      * @param pointCode
      * @param v
      */
-    void _calculateDualPoint( const int32_t x, const int32_t y, const int32_t z,
+    template< class Volume >
+    void _calculateDualPoint( const Volume & volume,
+                              const int32_t x, const int32_t y, const int32_t z,
                               uint8_t const isoValue, int const pointCode,
                               Vertex &v ) const;
 
+    /**
+     * @brief _calculateDualPoint
+     * Given a dual point code and iso value, compute the compact dual point.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param pointCode
+     * @param v
+     */
+    template< class Volume >
+    void _calculateDualPoint( const Volume & volume,
+                              const int32_t x, const int32_t y, const int32_t z,
+                              uint8_t const isoValue, int const pointCode,
+                              CompactVertex &v ) const;
+
     /**
      * @brief _getSharedDualPointIndex
      * Get the shared index of a dual point which is uniquly identified by its
-     * cell cube index and a cube edge. The dual point is computed, if it has
-     * not been computed before.
+     * cell cube index and its point code. The dual point is computed, if it
+     * has not been computed before.
+     * @param volume
      * @param x
      * @param y
      * @param cz
      * @param isoValue
-     * @param edge
+     * @param pointCode
      * @param vertices
      * @return
      */
-    int32_t _getSharedDualPointIndex( const int32_t x,
+    template< class Volume, class VertexType >
+    int32_t _getSharedDualPointIndex( const Volume & volume,
+                                      const int32_t x,
                                       const int32_t y,
                                       const int32_t cz,
                                       const uint8_t isoValue,
-                                      const DMC_EDGE_CODE edge,
-                                      std::vector<Vertex> & vertices );
+                                      const int pointCode,
+                                      std::vector<VertexType> & vertices );
+
+    /**
+     * @brief _resetScratch
+     * Release the scratch memory of the previous build. The hash map is
+     * emptied before the arena and reserves the size of the previous build.
+     */
+    void _resetScratch();
+
+    /**
+     * @brief _copyRanges
+     * Copy the volume dimensions, the cell range and the origin of another
+     * builder.
+     * @param other
+     */
+    void _copyRanges( const DualMC & other );
+
+    /**
+     * @brief _wrapPeriodicPoints
+     * Close the mesh of a periodic volume on the torus. The dual points of
+     * the first padded cell layers are merged with the points of the cells
+     * they repeat at the end of the volume, or moved there if these cells
+     * have no points. Quad soup points are moved by their position.
+     * @param dimensions
+     * Dimensions of the volume without padding.
+     * @param generateSoup
+     * @param vertices
+     * @param quads
+     */
+    void _wrapPeriodicPoints( const int32_t dimensions[3], const bool generateSoup,
+                              std::vector<Vertex> & vertices, std::vector<Quad> & quads ) const;
 
     /**
      * @brief _index
@@ -164,11 +1009,18 @@ private:
     int32_t _volumeDimensions[3];
 
     /**
-     * @brief _volumeGrid
-     * The input volume grid.
+     * @brief _cellBegin, _cellEnd
+     * Range of cells visited by the traversal of all cells.
      */
-    uint8_t const * _volumeGrid;
-    
+    int32_t _cellBegin[3];
+    int32_t _cellEnd[3];
+
+    /**
+     * @brief _origin
+     * Position of the volume inside of a larger volume, added to the
+     * coordinates of the float vertices.
+     */
+    int32_t _origin[3];
 
     /**
      * @brief _generateManifold
@@ -176,6 +1028,13 @@ private:
      */
     bool _generateManifold;
 
+    /**
+     * @brief _stats
+     * Statistics of the current build. Mutable, as counters are also updated
+     * by const lookup functions.
+     */
+    mutable BuildStats _stats;
+
     /**
      * @brief The DualPointKey struct
      * Dual point key structure for hashing of shared vertices
@@ -203,11 +1062,44 @@ private:
         }
     };
 
+    /// Hash map of dual points to shared vertex indices in the scratch arena
+    typedef std::unordered_map< DualPointKey, int32_t, DualPointKeyHash, std::equal_to< DualPointKey >,
+                                ArenaAllocator< std::pair< const DualPointKey, int32_t > > > PointMap;
+
+    /**
+     * @brief _scratch
+     * Arena for the scratch memory of a build, which is kept between builds.
+     * Holds the hash map nodes and the cell code planes.
+     */
+    Arena _scratch;
+
     /**
      * @brief pointToIndex
      * Hash map for shared vertex index computations
      */
-    std::unordered_map< DualPointKey, int32_t, DualPointKeyHash > pointToIndex;
+    PointMap pointToIndex;
+
+    /**
+     * @brief _activeCells
+     * Cells returned by a span space index query.
+     */
+    std::vector< uint32_t > _activeCells;
+
+    /**
+     * @brief _visitedBlocks, _visitedEdges
+     * Bitmaps of the edges visited by the surface tracking, three per cell.
+     * Each block of cells refers to its bitmap in the edge words, where zero
+     * means that no edge of the block has been visited.
+     */
+    std::vector< uint32_t > _visitedBlocks;
+    std::vector< uint64_t > _visitedEdges;
+
+    // The incremental and level of detail builders reuse the per-cell functions
+    friend class IncrementalDualMC;
+    friend class LodDualMC;
 };
 }
+
+#include "dualmc.tpp"
+
 #endif // DUALMC_H_INCLUDED
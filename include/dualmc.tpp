@@ -0,0 +1,350 @@
+#ifndef DUALMC_TPP_INCLUDED
+#define DUALMC_TPP_INCLUDED
+
+// Template implementation of the per-cell functions of the dual marching
+// cubes builder. They are parameterized on the volume accessor and shared by
+// all builders working on top of DualMC.
+
+namespace dualmc
+{
+
+/**
+ * @brief DualMC::getCellCode
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @return
+ */
+template< class Volume >
+int DualMC::_getCellCode( const Volume & volume,
+                          const int32_t x, const int32_t y, const int32_t z,
+                          const uint8_t isoValue ) const
+{
+    // Determine for each cube corner if it is outside or inside
+    int code = 0;
+
+    if( volume( x, y, z ) >= isoValue )
+        code |= 1;
+    if( volume( x + 1, y, z ) >= isoValue )
+        code |= 2;
+    if( volume( x, y + 1, z ) >= isoValue )
+        code |= 4;
+    if( volume( x + 1, y + 1, z ) >= isoValue )
+        code |= 8;
+    if( volume( x, y, z + 1 ) >= isoValue )
+        code |= 16;
+    if( volume( x + 1, y, z + 1 ) >= isoValue )
+        code |= 32;
+    if( volume( x, y + 1, z + 1 ) >= isoValue )
+        code |= 64;
+    if( volume( x + 1, y + 1, z + 1 ) >= isoValue )
+        code |= 128;
+
+    return code;
+}
+
+/**
+ * @brief DualMC::getEdgeCornerCode
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @return
+ */
+template< class Volume >
+int DualMC::_getEdgeCornerCode( const Volume & volume,
+                                const int32_t x, const int32_t y, const int32_t z,
+                                const uint8_t isoValue ) const
+{
+    int code = 0;
+
+    if( volume( x, y, z ) >= isoValue )
+        code |= 1;
+    if( volume( x + 1, y, z ) >= isoValue )
+        code |= 2;
+    if( volume( x, y + 1, z ) >= isoValue )
+        code |= 4;
+    if( volume( x, y, z + 1 ) >= isoValue )
+        code |= 16;
+
+    return code;
+}
+
+/**
+ * @brief DualMC::getEdgeCornerCode
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @return
+ */
+template< class Volume >
+int DualMC::_getEdgeCornerCode( const CellCodeVolume< Volume > & volume,
+                                const int32_t x, const int32_t y, const int32_t z,
+                                const uint8_t ) const
+{
+    // Only the corners 0, 1, 2 and 4 are end points of the edges
+    return volume.rawCellCode( x, y, z ) & 0x17;
+}
+
+/**
+ * @brief DualMC::getDualPointCode
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param edge
+ * @return
+ */
+template< class Volume, bool GenerateManifold >
+int DualMC::_getDualPointCode( const Volume & volume,
+                               const int32_t x, const int32_t y, const int32_t z,
+                               const uint8_t isoValue,
+                               const DMC_EDGE_CODE edge,
+                               ManifoldPolicy< GenerateManifold > ) const
+{
+    // Get the code of the cube that corresponds to the given XYZ voxel
+    int cubeCode = _getCellCode( volume, x, y, z, isoValue );
+
+    // Is manifold dual marching cubes desired?
+    if( GenerateManifold )
+    {
+        int const resolvedCode = resolveManifoldCode(
+                    cubeCode, x, y, z, _volumeDimensions,
+                    [ & ]( const int32_t nx, const int32_t ny, const int32_t nz )
+                    {
+                        return _getCellCode( volume, nx, ny, nz, isoValue );
+                    });
+        DUALMC_STAT( _stats.manifoldInversions += resolvedCode != cubeCode ? 1 : 0 );
+        cubeCode = resolvedCode;
+    }
+
+    // Look up the face containing the edge
+    return edgeDualPoints[ cubeCode ][ edgeIndex( edge ) ];
+}
+
+/**
+ * @brief DualMC::getDualPointCode
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param edge
+ * @return
+ */
+template< class Volume, bool GenerateManifold >
+int DualMC::_getDualPointCode( const CellCodeVolume< Volume > & volume,
+                               const int32_t x, const int32_t y, const int32_t z,
+                               const uint8_t,
+                               const DMC_EDGE_CODE edge,
+                               ManifoldPolicy< GenerateManifold > ) const
+{
+    // The cube code is already resolved for manifold meshes
+    int const cubeCode = volume.cellCode( x, y, z );
+    DUALMC_STAT( _stats.manifoldInversions += cubeCode != volume.rawCellCode( x, y, z ) ? 1 : 0 );
+    return edgeDualPoints[ cubeCode ][ edgeIndex( edge ) ];
+}
+
+/**
+ * @brief DualMC::calculateDualPointOffset
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param pointCode
+ * @param p
+ */
+template< class Volume >
+void DualMC::_calculateDualPointOffset( const Volume & volume,
+                                        const int32_t x,
+                                        const int32_t y,
+                                        const int32_t z,
+                                        const uint8_t isoValue,
+                                        const int pointCode,
+                                        Vertex & p ) const
+{
+    // Compute the dual point as the mean of the face vertices belonging to the
+    // original marching cubes face
+    p.x = 0; p.y = 0; p.z = 0;
+
+    int points = 0;
+
+    // Sum edge intersection vertices using the point code
+    if( pointCode & EDGE0 )
+    {
+        p.x += (( float ) isoValue - ( float ) volume( x, y, z )) /
+                (( float ) volume( x + 1, y, z ) -
+                ( float ) volume( x, y, z ));
+        points++;
+    }
+
+    if( pointCode & EDGE1 )
+    {
+        p.x += 1.0f;
+        p.z += (( float ) isoValue - ( float ) volume( x + 1, y, z )) /
+                (( float ) volume( x + 1, y, z + 1 ) -
+                ( float ) volume( x + 1, y, z ));
+        points++;
+    }
+
+    if( pointCode & EDGE2 )
+    {
+        p.x += (( float ) isoValue - ( float ) volume( x, y, z + 1 )) /
+                (( float ) volume( x + 1, y, z + 1 ) -
+                ( float ) volume( x, y, z + 1 ));
+        p.z += 1.0f;
+        points++;
+    }
+
+    if( pointCode & EDGE3 )
+    {
+        p.z += (( float ) isoValue - ( float ) volume( x, y, z ) ) /
+                (( float ) volume( x, y, z + 1 ) -
+                ( float ) volume( x, y, z ));
+        points++;
+    }
+
+    if( pointCode & EDGE4 )
+    {
+        p.x += (( float ) isoValue - ( float ) volume( x, y + 1, z )) /
+                (( float ) volume( x + 1, y + 1, z ) -
+                ( float ) volume( x, y + 1, z ));
+        p.y += 1.0f;
+        points++;
+    }
+
+    if( pointCode & EDGE5 )
+    {
+        p.x += 1.0f;
+        p.z += (( float ) isoValue - ( float ) volume( x + 1, y + 1, z )) /
+                (( float ) volume( x + 1, y + 1, z + 1 ) -
+                ( float ) volume( x + 1, y + 1, z ));
+        p.y += 1.0f;
+        points++;
+    }
+
+    if( pointCode & EDGE6 )
+    {
+        p.x += (( float ) isoValue - ( float ) volume( x, y + 1, z + 1 )) /
+                (( float ) volume( x + 1, y + 1, z + 1 ) -
+                ( float ) volume( x, y + 1, z + 1 ));
+        p.z += 1.0f;
+        p.y += 1.0f;
+        points++;
+    }
+
+    if( pointCode & EDGE7 )
+    {
+        p.z += (( float ) isoValue - ( float ) volume( x, y + 1 , z )) /
+                (( float ) volume( x, y + 1, z + 1 ) -
+                ( float ) volume( x, y + 1 , z ));
+        p.y += 1.0f;
+        points++;
+    }
+
+    if( pointCode & EDGE8 )
+    {
+        p.y += (( float ) isoValue - ( float ) volume( x, y, z )) /
+                (( float ) volume( x, y + 1, z ) -
+                ( float ) volume( x, y, z ));
+        points++;
+    }
+
+    if( pointCode & EDGE9 )
+    {
+        p.x += 1.0f;
+        p.y += (( float ) isoValue - ( float ) volume( x + 1, y, z )) /
+                (( float ) volume( x + 1, y + 1, z ) -
+                ( float ) volume( x + 1, y, z ));
+        points++;
+    }
+
+    if( pointCode & EDGE10 )
+    {
+        p.x += 1.0f;
+        p.y += (( float ) isoValue - ( float ) volume( x + 1, y, z + 1 )) /
+                (( float ) volume( x + 1, y + 1, z + 1 ) -
+                ( float ) volume( x + 1, y, z + 1 ));
+        p.z += 1.0f;
+        points++;
+    }
+
+    if( pointCode & EDGE11 )
+    {
+        p.z += 1.0f;
+        p.y += (( float ) isoValue - ( float ) volume( x, y, z + 1 )) /
+                (( float ) volume( x, y + 1, z + 1 ) -
+                ( float ) volume( x, y, z + 1 ));
+        points++;
+    }
+
+    // Divide by number of accumulated points
+    float invPoints = 1.0f / ( float ) points;
+    p.x *= invPoints; p.y *= invPoints; p.z *= invPoints;
+}
+
+/**
+ * @brief DualMC::calculateDualPoint
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param pointCode
+ * @param v
+ */
+template< class Volume >
+void DualMC::_calculateDualPoint( const Volume & volume,
+                                  const int32_t x,
+                                  const int32_t y,
+                                  const int32_t z,
+                                  const uint8_t isoValue,
+                                  const int pointCode,
+                                  Vertex & v ) const
+{
+    Vertex p;
+    _calculateDualPointOffset( volume, x, y, z, isoValue, pointCode, p );
+
+    // Offset point by voxel coordinates
+    v.x = ( float )( x + _origin[0] ) + p.x;
+    v.y = ( float )( y + _origin[1] ) + p.y;
+    v.z = ( float )( z + _origin[2] ) + p.z;
+}
+
+/**
+ * @brief DualMC::calculateDualPoint
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param pointCode
+ * @param v
+ */
+template< class Volume >
+void DualMC::_calculateDualPoint( const Volume & volume,
+                                  const int32_t x,
+                                  const int32_t y,
+                                  const int32_t z,
+                                  const uint8_t isoValue,
+                                  const int pointCode,
+                                  CompactVertex & v ) const
+{
+    Vertex p;
+    _calculateDualPointOffset( volume, x, y, z, isoValue, pointCode, p );
+
+    // Pack the linearized cell and the offset inside of it
+    uint64_t const cell = uint64_t( x ) + uint64_t( _volumeDimensions[0] ) *
+            ( uint64_t( y ) + uint64_t( _volumeDimensions[1] ) * uint64_t( z ));
+    v = CompactVertex( cell, p.x, p.y, p.z );
+}
+
+}
+
+#endif // DUALMC_TPP_INCLUDED
@@ -0,0 +1,591 @@
+#include "incrementaldualmc.h"
+
+// STL includes
+#include <algorithm>
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Filler for unused quad slots
+const Quad DEGENERATE_QUAD( 0, 0, 0, 0 );
+
+/**
+ * @brief insideAnyBox
+ * @param boxes
+ * @param x
+ * @param y
+ * @param z
+ * @return True, if ( x, y, z ) lies inside one of the boxes.
+ */
+bool insideAnyBox( const std::vector< IncrementalDualMC::Box > & boxes,
+                   const int32_t x, const int32_t y, const int32_t z )
+{
+    for( auto const & box : boxes )
+    {
+        if( x >= box.begin[0] && x < box.end[0] &&
+            y >= box.begin[1] && y < box.end[1] &&
+            z >= box.begin[2] && z < box.end[2] )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+/**
+ * @brief IncrementalDualMC::IncrementalDualMC
+ * @param brickSize
+ */
+IncrementalDualMC::IncrementalDualMC( const int32_t brickSize )
+    : _volumeGrid( nullptr ),
+      _isoValue( 0 ),
+      _brickSize( std::max( brickSize, 1 )),
+      _updateStamp( 0 )
+{
+    _numBricks[0] = _numBricks[1] = _numBricks[2] = 0;
+}
+
+/**
+ * @brief IncrementalDualMC::build
+ * @param volumeGrid
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param generateManifold
+ */
+void IncrementalDualMC::build( const uint8_t * volumeGrid,
+                               const int32_t x, const int32_t y, const int32_t z,
+                               const uint8_t isoValue,
+                               const bool generateManifold )
+{
+    // Set up the builder for the per-cell functions
+    _builder._volumeDimensions[0] = x;
+    _builder._volumeDimensions[1] = y;
+    _builder._volumeDimensions[2] = z;
+    _builder._generateManifold = generateManifold;
+    _volumeGrid = volumeGrid;
+    _isoValue = isoValue;
+
+    // Bricks partition the voxels, which are the base of edges processed by
+    // the builder. See DualMC::_buildQuadsAt.
+    for( int a = 0; a < 3; ++a )
+    {
+        int32_t const reduced = std::max( _builder._volumeDimensions[a] - 2, 0 );
+        _numBricks[a] = ( reduced + _brickSize - 1 ) / _brickSize;
+    }
+
+    // Reset the mesh
+    Brick emptyBrick;
+    emptyBrick.quadBegin = 0;
+    emptyBrick.quadCount = 0;
+    emptyBrick.quadCapacity = 0;
+    _bricks.assign( size_t( _numBricks[0] ) * _numBricks[1] * _numBricks[2], emptyBrick );
+    _vertices.clear();
+    _vertexKeys.clear();
+    _vertexReferences.clear();
+    _vertexStamps.clear();
+    _freeVertices.clear();
+    _quads.clear();
+    _pointToIndex.clear();
+    _modifiedVertices.clear();
+    _modifiedQuadRanges.clear();
+    ++_updateStamp;
+
+    // Mesh all bricks
+    std::vector< Box > const noChangedCells;
+    for( int32_t brick = 0; brick < int32_t( _bricks.size()); ++brick )
+    {
+        if( _builder._generateManifold )
+        {
+            _meshBrick< true >( brick, noChangedCells );
+        }
+        else
+        {
+            _meshBrick< false >( brick, noChangedCells );
+        }
+    }
+
+    // Everything is new
+    _modifiedVertices.clear();
+    _modifiedQuadRanges.clear();
+    _modifiedVertexRanges.clear();
+    if( !_vertices.empty())
+    {
+        _modifiedVertexRanges.push_back( Range{ 0, _vertices.size() } );
+    }
+    if( !_quads.empty())
+    {
+        _modifiedQuadRanges.push_back( Range{ 0, _quads.size() } );
+    }
+}
+
+/**
+ * @brief IncrementalDualMC::update
+ * @param dirtyBoxes
+ */
+void IncrementalDualMC::update( const std::vector< Box > & dirtyBoxes )
+{
+    ++_updateStamp;
+    _modifiedVertices.clear();
+    _modifiedQuadRanges.clear();
+    _releasedVertices.clear();
+
+    // A modified voxel changes the dual points of its adjacent cells, which
+    // are used by quads of edges up to one voxel away. With manifold dual
+    // marching cubes the cube codes of the neighboring cells change as well.
+    int32_t const apron = _builder._generateManifold ? 2 : 1;
+
+    std::vector< Box > changedCells;
+    std::vector< char > affected( _bricks.size(), 0 );
+    for( auto const & dirty : dirtyBoxes )
+    {
+        Box cells;
+        int32_t firstBrick[3];
+        int32_t lastBrick[3];
+        bool empty = false;
+        for( int a = 0; a < 3; ++a )
+        {
+            int32_t const dimension = _builder._volumeDimensions[a];
+            int32_t const begin = std::max( dirty.begin[a], 0 );
+            int32_t const end = std::min( dirty.end[a], dimension );
+            empty = empty || begin >= end;
+
+            // Cells containing modified voxels
+            cells.begin[a] = std::max( begin - 1, 0 );
+            cells.end[a] = std::min( end, dimension - 1 );
+
+            // Bricks containing affected edge base voxels
+            int32_t const first = std::max( begin - apron, 0 );
+            int32_t const last = std::min( end - 1 + apron, _numBricks[a] * _brickSize - 1 );
+            firstBrick[a] = first / _brickSize;
+            lastBrick[a] = std::min( last / _brickSize, _numBricks[a] - 1 );
+            empty = empty || first > last;
+        }
+        if( empty )
+        {
+            continue;
+        }
+
+        changedCells.push_back( cells );
+        for( int32_t bz = firstBrick[2]; bz <= lastBrick[2]; ++bz )
+            for( int32_t by = firstBrick[1]; by <= lastBrick[1]; ++by )
+                for( int32_t bx = firstBrick[0]; bx <= lastBrick[0]; ++bx )
+                    affected[ bx + _numBricks[0] * ( by + _numBricks[1] * bz )] = 1;
+    }
+
+    // Release all affected bricks first, so dual points still used after
+    // meshing them again keep their vertex slots
+    for( int32_t brick = 0; brick < int32_t( _bricks.size()); ++brick )
+    {
+        if( affected[ brick ])
+        {
+            _releaseBrick( brick );
+        }
+    }
+
+    for( int32_t brick = 0; brick < int32_t( _bricks.size()); ++brick )
+    {
+        if( !affected[ brick ])
+        {
+            continue;
+        }
+        if( _builder._generateManifold )
+        {
+            _meshBrick< true >( brick, changedCells );
+        }
+        else
+        {
+            _meshBrick< false >( brick, changedCells );
+        }
+    }
+
+    // Free the slots of dual points, which are not referenced anymore
+    for( int32_t const vertex : _releasedVertices )
+    {
+        if( _vertexReferences[ vertex ] == 0 )
+        {
+            _pointToIndex.erase( _vertexKeys[ vertex ]);
+            _vertexReferences[ vertex ] = -1;
+            _freeVertices.push_back( vertex );
+        }
+    }
+
+    _finishModifiedRanges();
+}
+
+/**
+ * @brief IncrementalDualMC::vertices
+ * @return
+ */
+const std::vector< Vertex > & IncrementalDualMC::vertices() const
+{
+    return _vertices;
+}
+
+/**
+ * @brief IncrementalDualMC::quads
+ * @return
+ */
+const std::vector< Quad > & IncrementalDualMC::quads() const
+{
+    return _quads;
+}
+
+/**
+ * @brief IncrementalDualMC::modifiedVertexRanges
+ * @return
+ */
+const std::vector< IncrementalDualMC::Range > & IncrementalDualMC::modifiedVertexRanges() const
+{
+    return _modifiedVertexRanges;
+}
+
+/**
+ * @brief IncrementalDualMC::modifiedQuadRanges
+ * @return
+ */
+const std::vector< IncrementalDualMC::Range > & IncrementalDualMC::modifiedQuadRanges() const
+{
+    return _modifiedQuadRanges;
+}
+
+/**
+ * @brief IncrementalDualMC::compact
+ * @param vertices
+ * @param quads
+ */
+void IncrementalDualMC::compact( std::vector< Vertex > & vertices,
+                                 std::vector< Quad > & quads ) const
+{
+    vertices.clear();
+    quads.clear();
+
+    // Renumber referenced vertices
+    std::vector< int32_t > newIndex( _vertices.size(), -1 );
+    for( size_t v = 0; v < _vertices.size(); ++v )
+    {
+        if( _vertexReferences[ v ] > 0 )
+        {
+            newIndex[ v ] = int32_t( vertices.size());
+            vertices.push_back( _vertices[ v ]);
+        }
+    }
+
+    // Copy the quads of all bricks
+    for( auto const & brick : _bricks )
+    {
+        for( size_t q = brick.quadBegin; q < brick.quadBegin + brick.quadCount; ++q )
+        {
+            Quad const & quad = _quads[ q ];
+            quads.emplace_back( newIndex[ quad.i0 ], newIndex[ quad.i1 ],
+                                newIndex[ quad.i2 ], newIndex[ quad.i3 ]);
+        }
+    }
+}
+
+/**
+ * @brief IncrementalDualMC::meshBrick
+ * @param brick
+ * @param changedCells
+ */
+template< bool GenerateManifold >
+void IncrementalDualMC::_meshBrick( const int32_t brick,
+                                    const std::vector< Box > & changedCells )
+{
+    LinearVolume const volume( _volumeGrid,
+                               _builder._volumeDimensions[0],
+                               _builder._volumeDimensions[1],
+                               _builder._volumeDimensions[2] );
+    uint8_t const isoValue = _isoValue;
+
+    // Edge base voxels of the brick
+    int32_t const brickCoords[] =
+    {
+        brick % _numBricks[0],
+        ( brick / _numBricks[0] ) % _numBricks[1],
+        brick / ( _numBricks[0] * _numBricks[1] )
+    };
+    int32_t begin[3];
+    int32_t end[3];
+    for( int a = 0; a < 3; ++a )
+    {
+        begin[a] = brickCoords[a] * _brickSize;
+        end[a] = std::min( begin[a] + _brickSize, _builder._volumeDimensions[a] - 2 );
+    }
+
+    _brickQuads.clear();
+    int32_t i0, i1, i2, i3;
+
+    // Same edge traversal as the shared vertices builder
+    for( int32_t z = begin[2]; z < end[2]; ++z )
+    {
+        for( int32_t y = begin[1]; y < end[1]; ++y )
+        {
+            for( int32_t x = begin[0]; x < end[0]; ++x )
+            {
+                // Construct quads for X edge
+                if( z > 0 && y > 0 )
+                {
+                    bool const entering = volume( x, y, z ) < isoValue &&
+                                          volume( x + 1, y, z ) >= isoValue;
+                    bool const exiting  = volume( x, y, z ) >= isoValue &&
+                                          volume( x + 1, y, z ) < isoValue;
+                    if( entering || exiting )
+                    {
+                        i0 = _acquireVertex< GenerateManifold >( volume, x, y, z, EDGE0, changedCells );
+                        i1 = _acquireVertex< GenerateManifold >( volume, x, y, z - 1, EDGE2, changedCells );
+                        i2 = _acquireVertex< GenerateManifold >( volume, x, y - 1, z - 1, EDGE6, changedCells );
+                        i3 = _acquireVertex< GenerateManifold >( volume, x, y - 1, z, EDGE4, changedCells );
+
+                        if( entering )
+                        {
+                            _brickQuads.emplace_back( i0, i1, i2, i3 );
+                        }
+                        else
+                        {
+                            _brickQuads.emplace_back( i0, i3, i2, i1 );
+                        }
+                    }
+                }
+
+                // Construct quads for y edge
+                if( z > 0 && x > 0 )
+                {
+                    bool const entering = volume( x, y, z ) < isoValue &&
+                                          volume( x, y + 1, z ) >= isoValue;
+                    bool const exiting  = volume( x, y, z ) >= isoValue &&
+                                          volume( x, y + 1, z ) < isoValue;
+                    if( entering || exiting )
+                    {
+                        i0 = _acquireVertex< GenerateManifold >( volume, x, y, z, EDGE8, changedCells );
+                        i1 = _acquireVertex< GenerateManifold >( volume, x, y, z - 1, EDGE11, changedCells );
+                        i2 = _acquireVertex< GenerateManifold >( volume, x - 1, y, z - 1, EDGE10, changedCells );
+                        i3 = _acquireVertex< GenerateManifold >( volume, x - 1, y, z, EDGE9, changedCells );
+
+                        if( exiting )
+                        {
+                            _brickQuads.emplace_back( i0, i1, i2, i3 );
+                        }
+                        else
+                        {
+                            _brickQuads.emplace_back( i0, i3, i2, i1 );
+                        }
+                    }
+                }
+
+                // Construct quads for z edge
+                if( x > 0 && y > 0 )
+                {
+                    bool const entering = volume( x, y, z ) < isoValue &&
+                                          volume( x, y, z + 1 ) >= isoValue;
+                    bool const exiting  = volume( x, y, z ) >= isoValue &&
+                                          volume( x, y, z + 1 ) < isoValue;
+                    if( entering || exiting )
+                    {
+                        i0 = _acquireVertex< GenerateManifold >( volume, x, y, z, EDGE3, changedCells );
+                        i1 = _acquireVertex< GenerateManifold >( volume, x - 1, y, z, EDGE1, changedCells );
+                        i2 = _acquireVertex< GenerateManifold >( volume, x - 1, y - 1, z, EDGE5, changedCells );
+                        i3 = _acquireVertex< GenerateManifold >( volume, x, y - 1, z, EDGE7, changedCells );
+
+                        if( exiting )
+                        {
+                            _brickQuads.emplace_back( i0, i1, i2, i3 );
+                        }
+                        else
+                        {
+                            _brickQuads.emplace_back( i0, i3, i2, i1 );
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    _storeBrickQuads( brick );
+}
+
+/**
+ * @brief IncrementalDualMC::storeBrickQuads
+ * @param brickIndex
+ */
+void IncrementalDualMC::_storeBrickQuads( const int32_t brickIndex )
+{
+    Brick & brick = _bricks[ brickIndex ];
+    size_t const count = _brickQuads.size();
+    size_t dirtyEnd = brick.quadBegin + std::max( count, brick.quadCount );
+
+    // Move the brick to the end of the quad list if its range is too small
+    // and leave degenerate quads in the old range
+    if( count > brick.quadCapacity )
+    {
+        if( brick.quadCount > 0 )
+        {
+            std::fill( _quads.begin() + brick.quadBegin,
+                       _quads.begin() + brick.quadBegin + brick.quadCount,
+                       DEGENERATE_QUAD );
+            _modifiedQuadRanges.push_back( Range{ brick.quadBegin,
+                                                  brick.quadBegin + brick.quadCount } );
+        }
+        brick.quadBegin = _quads.size();
+        brick.quadCapacity = count + count / 4;
+        _quads.resize( brick.quadBegin + brick.quadCapacity, DEGENERATE_QUAD );
+        dirtyEnd = brick.quadBegin + count;
+    }
+
+    // Write the new quads and clear the remainder of the old ones
+    std::copy( _brickQuads.begin(), _brickQuads.end(), _quads.begin() + brick.quadBegin );
+    if( count < brick.quadCount )
+    {
+        std::fill( _quads.begin() + brick.quadBegin + count,
+                   _quads.begin() + brick.quadBegin + brick.quadCount,
+                   DEGENERATE_QUAD );
+    }
+    brick.quadCount = count;
+
+    if( dirtyEnd > brick.quadBegin )
+    {
+        _modifiedQuadRanges.push_back( Range{ brick.quadBegin, dirtyEnd } );
+    }
+}
+
+/**
+ * @brief IncrementalDualMC::releaseBrick
+ * @param brickIndex
+ */
+void IncrementalDualMC::_releaseBrick( const int32_t brickIndex )
+{
+    Brick const & brick = _bricks[ brickIndex ];
+    for( size_t q = brick.quadBegin; q < brick.quadBegin + brick.quadCount; ++q )
+    {
+        int32_t const indices[] = { _quads[ q ].i0, _quads[ q ].i1,
+                                    _quads[ q ].i2, _quads[ q ].i3 };
+        for( int32_t const vertex : indices )
+        {
+            --_vertexReferences[ vertex ];
+            _releasedVertices.push_back( vertex );
+        }
+    }
+}
+
+/**
+ * @brief IncrementalDualMC::acquireVertex
+ * @param volume
+ * @param x
+ * @param y
+ * @param z
+ * @param edge
+ * @param changedCells
+ * @return
+ */
+template< bool GenerateManifold >
+int32_t IncrementalDualMC::_acquireVertex( const LinearVolume & volume,
+                                           const int32_t x, const int32_t y, const int32_t z,
+                                           const DMC_EDGE_CODE edge,
+                                           const std::vector< Box > & changedCells )
+{
+    DualMC::DualPointKey key;
+    key.linearizedCellID = _builder._index( x, y, z );
+    key.pointCode = _builder._getDualPointCode( volume, x, y, z, _isoValue, edge,
+                                                DualMC::ManifoldPolicy< GenerateManifold >());
+
+    int32_t vertex;
+    auto iterator = _pointToIndex.find( key );
+    if( iterator != _pointToIndex.end())
+    {
+        // Recompute existing dual points of changed cells once per update
+        vertex = iterator->second;
+        if( _vertexStamps[ vertex ] != _updateStamp &&
+            insideAnyBox( changedCells, x, y, z ))
+        {
+            _builder._calculateDualPoint( volume, x, y, z, _isoValue,
+                                          key.pointCode, _vertices[ vertex ]);
+            _vertexStamps[ vertex ] = _updateStamp;
+            _markVertex( vertex );
+        }
+    }
+    else
+    {
+        // Reuse a free vertex slot or append a new one
+        if( !_freeVertices.empty())
+        {
+            vertex = _freeVertices.back();
+            _freeVertices.pop_back();
+        }
+        else
+        {
+            vertex = int32_t( _vertices.size());
+            _vertices.emplace_back();
+            _vertexKeys.emplace_back();
+            _vertexReferences.push_back( 0 );
+            _vertexStamps.push_back( 0 );
+        }
+
+        _builder._calculateDualPoint( volume, x, y, z, _isoValue,
+                                      key.pointCode, _vertices[ vertex ]);
+        _vertexKeys[ vertex ] = key;
+        _vertexReferences[ vertex ] = 0;
+        _vertexStamps[ vertex ] = _updateStamp;
+        _pointToIndex[ key ] = vertex;
+        _markVertex( vertex );
+    }
+
+    ++_vertexReferences[ vertex ];
+    return vertex;
+}
+
+/**
+ * @brief IncrementalDualMC::markVertex
+ * @param vertex
+ */
+void IncrementalDualMC::_markVertex( const int32_t vertex )
+{
+    _modifiedVertices.push_back( vertex );
+}
+
+/**
+ * @brief IncrementalDualMC::finishModifiedRanges
+ */
+void IncrementalDualMC::_finishModifiedRanges()
+{
+    // Merge sorted vertex indices into ranges
+    _modifiedVertexRanges.clear();
+    std::sort( _modifiedVertices.begin(), _modifiedVertices.end());
+    for( int32_t const vertex : _modifiedVertices )
+    {
+        if( !_modifiedVertexRanges.empty() &&
+            _modifiedVertexRanges.back().end >= size_t( vertex ))
+        {
+            _modifiedVertexRanges.back().end = std::max( _modifiedVertexRanges.back().end,
+                                                         size_t( vertex ) + 1 );
+        }
+        else
+        {
+            _modifiedVertexRanges.push_back( Range{ size_t( vertex ), size_t( vertex ) + 1 } );
+        }
+    }
+
+    // Merge overlapping quad ranges
+    std::sort( _modifiedQuadRanges.begin(), _modifiedQuadRanges.end(),
+               []( const Range & a, const Range & b ) { return a.begin < b.begin; } );
+    std::vector< Range > merged;
+    for( auto const & range : _modifiedQuadRanges )
+    {
+        if( !merged.empty() && merged.back().end >= range.begin )
+        {
+            merged.back().end = std::max( merged.back().end, range.end );
+        }
+        else
+        {
+            merged.push_back( range );
+        }
+    }
+    _modifiedQuadRanges.swap( merged );
+}
+
+}
@@ -0,0 +1,297 @@
+#ifndef INCREMENTALDUALMC_H
+#define INCREMENTALDUALMC_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <unordered_map>
+#include <vector>
+
+#include "dualmc.h"
+#include "linearvolume.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief The IncrementalDualMC class
+ * Dual marching cubes builder for interactively edited volumes. The mesh is
+ * partitioned into bricks of voxels. After voxels of the volume have been
+ * modified in place, only the bricks overlapping the modified voxel boxes
+ * plus an apron are meshed again.
+ * Vertices are shared across brick borders and keep their indices as long as
+ * their dual point exists. Released vertex slots are reused by new vertices.
+ * Each brick owns a contiguous range of the quad list with some spare
+ * capacity, which is rewritten in place. Unused quad slots contain degenerate
+ * quads with all indices set to zero. The ranges modified by the last build
+ * or update can be queried for uploading partial buffer updates.
+ */
+class IncrementalDualMC
+{
+public:
+
+    /// Axis aligned voxel box [begin, end)
+    struct Box
+    {
+        int32_t begin[3];
+        int32_t end[3];
+    };
+
+    /// Modified element range [begin, end)
+    struct Range
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    /**
+     * @brief IncrementalDualMC
+     * @param brickSize
+     * Edge length of the bricks in voxels.
+     */
+    explicit IncrementalDualMC( const int32_t brickSize = 16 );
+
+    /**
+     * @brief build
+     * Extract the full mesh. The volume is referenced, not copied, and has
+     * to stay valid for subsequent updates.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     */
+    void build( const uint8_t * volumeGrid,
+                const int32_t x, const int32_t y, const int32_t z,
+                const uint8_t isoValue,
+                const bool generateManifold );
+
+    /**
+     * @brief update
+     * Update the mesh after the voxels inside the given boxes have changed.
+     * @param dirtyBoxes
+     */
+    void update( const std::vector< Box > & dirtyBoxes );
+
+    /**
+     * @brief vertices
+     * @return Vertex list, which may contain unreferenced vertex slots.
+     */
+    const std::vector< Vertex > & vertices() const;
+
+    /**
+     * @brief quads
+     * @return Quad list, which may contain degenerate quads.
+     */
+    const std::vector< Quad > & quads() const;
+
+    /**
+     * @brief modifiedVertexRanges
+     * @return Sorted vertex ranges modified by the last build or update.
+     */
+    const std::vector< Range > & modifiedVertexRanges() const;
+
+    /**
+     * @brief modifiedQuadRanges
+     * @return Sorted quad ranges modified by the last build or update.
+     */
+    const std::vector< Range > & modifiedQuadRanges() const;
+
+    /**
+     * @brief compact
+     * Copy the mesh without unreferenced vertices and degenerate quads.
+     * @param vertices
+     * @param quads
+     */
+    void compact( std::vector< Vertex > & vertices,
+                  std::vector< Quad > & quads ) const;
+
+private:
+
+    /// Range of the quad list owned by a brick
+    struct Brick
+    {
+        size_t quadBegin;
+        size_t quadCount;
+        size_t quadCapacity;
+    };
+
+    /**
+     * @brief _meshBrick
+     * Extract the quads of all voxel edges in a brick and store them in the
+     * range of the brick.
+     * @param brick
+     * @param changedCells
+     * Cell boxes with modified voxels, whose dual points are recomputed.
+     */
+    template< bool GenerateManifold >
+    void _meshBrick( const int32_t brick, const std::vector< Box > & changedCells );
+
+    /**
+     * @brief _storeBrickQuads
+     * Write the quads collected in _brickQuads into the range of the brick,
+     * relocating the range if it is too small.
+     * @param brick
+     */
+    void _storeBrickQuads( const int32_t brick );
+
+    /**
+     * @brief _releaseBrick
+     * Release the vertex references of all quads of a brick.
+     * @param brick
+     */
+    void _releaseBrick( const int32_t brick );
+
+    /**
+     * @brief _acquireVertex
+     * Get the shared index of the dual point for a cell and edge and add a
+     * reference to it. Existing dual points of changed cells are recomputed.
+     * @param volume
+     * @param x
+     * @param y
+     * @param z
+     * @param edge
+     * @param changedCells
+     * @return
+     */
+    template< bool GenerateManifold >
+    int32_t _acquireVertex( const LinearVolume & volume,
+                            const int32_t x, const int32_t y, const int32_t z,
+                            const DMC_EDGE_CODE edge,
+                            const std::vector< Box > & changedCells );
+
+    /**
+     * @brief _markVertex
+     * Register a vertex as modified.
+     * @param vertex
+     */
+    void _markVertex( const int32_t vertex );
+
+    /**
+     * @brief _finishModifiedRanges
+     * Convert the modified vertex indices into sorted ranges and sort the
+     * modified quad ranges.
+     */
+    void _finishModifiedRanges();
+
+private:
+
+    /**
+     * @brief _builder
+     * Builder providing the per-cell functions.
+     */
+    DualMC _builder;
+
+    /**
+     * @brief _volumeGrid
+     * The referenced input volume grid.
+     */
+    const uint8_t * _volumeGrid;
+
+    /**
+     * @brief _isoValue
+     */
+    uint8_t _isoValue;
+
+    /**
+     * @brief _brickSize
+     * Edge length of the bricks in voxels.
+     */
+    int32_t _brickSize;
+
+    /**
+     * @brief _numBricks
+     * Number of bricks along each axis.
+     */
+    int32_t _numBricks[3];
+
+    /**
+     * @brief _bricks
+     * Quad ranges of all bricks.
+     */
+    std::vector< Brick > _bricks;
+
+    /**
+     * @brief _vertices
+     * Shared vertices of the mesh.
+     */
+    std::vector< Vertex > _vertices;
+
+    /**
+     * @brief _vertexKeys
+     * Dual point key of each vertex slot.
+     */
+    std::vector< DualMC::DualPointKey > _vertexKeys;
+
+    /**
+     * @brief _vertexReferences
+     * Number of quads referencing each vertex slot.
+     */
+    std::vector< int32_t > _vertexReferences;
+
+    /**
+     * @brief _vertexStamps
+     * Update stamp of the last recomputation of each vertex slot.
+     */
+    std::vector< uint32_t > _vertexStamps;
+
+    /**
+     * @brief _freeVertices
+     * Unreferenced vertex slots for reuse.
+     */
+    std::vector< int32_t > _freeVertices;
+
+    /**
+     * @brief _quads
+     * Quad ranges of all bricks.
+     */
+    std::vector< Quad > _quads;
+
+    /**
+     * @brief _pointToIndex
+     * Hash map from dual points to vertex slots.
+     */
+    std::unordered_map< DualMC::DualPointKey, int32_t,
+                        DualMC::DualPointKeyHash > _pointToIndex;
+
+    /**
+     * @brief _updateStamp
+     * Counter of builds and updates.
+     */
+    uint32_t _updateStamp;
+
+    /**
+     * @brief _brickQuads
+     * Scratch list for the quads of one brick.
+     */
+    std::vector< Quad > _brickQuads;
+
+    /**
+     * @brief _releasedVertices
+     * Scratch list of vertices which lost a reference during an update.
+     */
+    std::vector< int32_t > _releasedVertices;
+
+    /**
+     * @brief _modifiedVertices
+     * Scratch list of modified vertex indices.
+     */
+    std::vector< int32_t > _modifiedVertices;
+
+    /**
+     * @brief _modifiedVertexRanges
+     */
+    std::vector< Range > _modifiedVertexRanges;
+
+    /**
+     * @brief _modifiedQuadRanges
+     */
+    std::vector< Range > _modifiedQuadRanges;
+};
+
+}
+
+#endif // INCREMENTALDUALMC_H
@@ -0,0 +1,59 @@
+#ifndef LINEARVOLUME_H
+#define LINEARVOLUME_H
+
+// c includes
+#include <cstddef>
+#include <cstdint>
+
+namespace dualmc
+{
+
+/**
+ * @brief The LinearVolume class
+ * Volume accessor for a dense volume in linear x-fastest layout.
+ * Volume accessors return the voxel value at ( x, y, z ) and are notified
+ * with prepareLayer( z ) before the builder processes a voxel layer.
+ */
+class LinearVolume
+{
+public:
+
+    /// Initializing constructor
+    LinearVolume( const uint8_t * data,
+                  const int32_t x, const int32_t y, const int32_t z )
+        : _data( data ),
+          _dimX( x ),
+          _sliceSize( size_t( x ) * size_t( y ))
+    {
+        ( void ) z;
+    }
+
+    /// The voxel value at ( x, y, z )
+    uint8_t operator()( const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        return _data[ x + _dimX * y + _sliceSize * z ];
+    }
+
+    /// The contiguous voxel row at ( y, z )
+    const uint8_t * row( const int32_t y, const int32_t z ) const
+    {
+        return _data + _dimX * y + _sliceSize * z;
+    }
+
+    /// All voxels are always available
+    void prepareLayer( const int32_t )
+    {
+        /// EMPTY
+    }
+
+private:
+
+    // Volume data and strides
+    const uint8_t * _data;
+    size_t _dimX;
+    size_t _sliceSize;
+};
+
+}
+
+#endif // LINEARVOLUME_H
@@ -0,0 +1,624 @@
+#include "loddualmc.h"
+
+// C includes
+#include <cmath>
+
+// STL includes
+#include <algorithm>
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Transverse axes of the edges along each axis
+const int TRANSVERSE_AXES[3][2] = { { 1, 2 }, { 0, 2 }, { 0, 1 } };
+
+/// Cell edges along each axis by their side on the transverse axes
+const DMC_EDGE_CODE CELL_EDGES[3][2][2] =
+{
+    { { EDGE0, EDGE2 }, { EDGE4, EDGE6 } },
+    { { EDGE8, EDGE11 }, { EDGE9, EDGE10 } },
+    { { EDGE3, EDGE7 }, { EDGE1, EDGE5 } }
+};
+
+/// Cells around an edge along each axis in quad order, given by their side
+/// on the transverse axes. See DualMC::_buildQuadsAt.
+const int QUADRANTS[3][4][2] =
+{
+    { { 0, 0 }, { 0, -1 }, { -1, -1 }, { -1, 0 } },
+    { { 0, 0 }, { 0, -1 }, { -1, -1 }, { -1, 0 } },
+    { { 0, 0 }, { -1, 0 }, { -1, -1 }, { 0, -1 } }
+};
+
+/**
+ * @brief cellEdge
+ * @param axis
+ * @param sides
+ * Side of the edge on each axis, the entry of the edge axis is ignored.
+ * @return The cell edge along axis at the given sides.
+ */
+DMC_EDGE_CODE cellEdge( const int axis, const int sides[3] )
+{
+    return CELL_EDGES[ axis ][ sides[ TRANSVERSE_AXES[ axis ][0] ]]
+            [ sides[ TRANSVERSE_AXES[ axis ][1] ]];
+}
+
+}
+
+/**
+ * @brief LodDualMC::LodDualMC
+ * @param pyramid
+ * @param brickSize
+ */
+LodDualMC::LodDualMC( const VolumePyramid & pyramid, const int32_t brickSize )
+    : _pyramid( pyramid ),
+      _brickSize( 1 ),
+      _brickShift( 0 ),
+      _isoValue( 0 )
+{
+    while( _brickSize < brickSize )
+    {
+        _brickSize <<= 1;
+        ++_brickShift;
+    }
+
+    // Bricks cover all cells of the finest level
+    size_t numBricksTotal = 1;
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        int32_t const cells = pyramid.numLevels() > 0 ?
+                    std::max( pyramid.dimension( 0, axis ) - 1, 0 ) : 0;
+        _numBricks[ axis ] = ( cells + _brickSize - 1 ) >> _brickShift;
+        numBricksTotal *= size_t( _numBricks[ axis ]);
+    }
+    _brickLevels.assign( numBricksTotal, 0 );
+}
+
+/**
+ * @brief LodDualMC::numBricks
+ * @param axis
+ * @return
+ */
+int32_t LodDualMC::numBricks( const int axis ) const
+{
+    return _numBricks[ axis ];
+}
+
+/**
+ * @brief LodDualMC::maxLevel
+ * @return
+ */
+int LodDualMC::maxLevel() const
+{
+    return std::max( std::min( _pyramid.numLevels() - 1, _brickShift ), 0 );
+}
+
+/**
+ * @brief LodDualMC::brickLevel
+ * @param bx
+ * @param by
+ * @param bz
+ * @return
+ */
+int LodDualMC::brickLevel( const int32_t bx, const int32_t by, const int32_t bz ) const
+{
+    return _brickLevels[ _brickIndex( bx, by, bz )];
+}
+
+/**
+ * @brief LodDualMC::setBrickLevel
+ * @param bx
+ * @param by
+ * @param bz
+ * @param level
+ */
+void LodDualMC::setBrickLevel( const int32_t bx, const int32_t by, const int32_t bz,
+                               const int level )
+{
+    _brickLevels[ _brickIndex( bx, by, bz )] =
+            uint8_t( std::max( std::min( level, maxLevel()), 0 ));
+}
+
+/**
+ * @brief LodDualMC::selectLevels
+ * @param viewpoint
+ * @param detailDistance
+ */
+void LodDualMC::selectLevels( const float viewpoint[3], const float detailDistance )
+{
+    for( int32_t bz = 0; bz < _numBricks[2]; ++bz )
+    {
+        for( int32_t by = 0; by < _numBricks[1]; ++by )
+        {
+            for( int32_t bx = 0; bx < _numBricks[0]; ++bx )
+            {
+                int32_t const brick[] = { bx, by, bz };
+                float distance = 0.0f;
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    float const d = ( float( brick[ axis ]) + 0.5f ) * float( _brickSize ) -
+                            viewpoint[ axis ];
+                    distance += d * d;
+                }
+                distance = std::sqrt( distance );
+
+                int level = 0;
+                if( distance >= detailDistance && detailDistance > 0.0f )
+                {
+                    level = int( std::floor( std::log2( distance / detailDistance ))) + 1;
+                }
+                setBrickLevel( bx, by, bz, level );
+            }
+        }
+    }
+}
+
+/**
+ * @brief LodDualMC::build
+ * @param isoValue
+ * @param vertices
+ * @param quads
+ */
+void LodDualMC::build( const uint8_t isoValue,
+                       std::vector< Vertex > & vertices,
+                       std::vector< Quad > & quads )
+{
+    _isoValue = isoValue;
+    vertices.clear();
+    quads.clear();
+    _pointToIndex.clear();
+
+    int32_t const numBricksTotal = int32_t( _brickLevels.size());
+    for( int32_t brick = 0; brick < numBricksTotal; ++brick )
+    {
+        _meshBrick( brick, vertices, quads );
+    }
+}
+
+/**
+ * @brief LodDualMC::pointLevel
+ * @param p
+ * @return
+ */
+int LodDualMC::_pointLevel( const int32_t p[3] ) const
+{
+    // Bricks touching the point along each axis
+    int32_t first[3];
+    int32_t last[3];
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        int32_t const brick = p[ axis ] >> _brickShift;
+        bool const border = ( p[ axis ] & ( _brickSize - 1 )) == 0;
+        first[ axis ] = std::max( border ? brick - 1 : brick, 0 );
+        last[ axis ] = std::min( brick, _numBricks[ axis ] - 1 );
+    }
+
+    int level = 0;
+    for( int32_t bz = first[2]; bz <= last[2]; ++bz )
+        for( int32_t by = first[1]; by <= last[1]; ++by )
+            for( int32_t bx = first[0]; bx <= last[0]; ++bx )
+                level = std::max( level, int( _brickLevels[ _brickIndex( bx, by, bz )]));
+    return level;
+}
+
+/**
+ * @brief LodDualMC::sample
+ * @param p
+ * @return
+ */
+uint8_t LodDualMC::_sample( const int32_t p[3] ) const
+{
+    int const level = _pointLevel( p );
+    int32_t const size = int32_t( 1 ) << level;
+
+    // Axes along which the point lies between lattice points of the level
+    int offAxes[3];
+    int numOffAxes = 0;
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        if(( p[ axis ] & ( size - 1 )) != 0 )
+        {
+            offAxes[ numOffAxes++ ] = axis;
+        }
+    }
+
+    // Lattice point of the level. A point on the border of a coarser brick
+    // can not lie inside of a coarser cell, so the third case does not occur.
+    if( numOffAxes == 0 || numOffAxes == 3 )
+    {
+        int32_t coords[3];
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            coords[ axis ] = std::min( p[ axis ] >> level,
+                                       _pyramid.dimension( level, axis ) - 1 );
+        }
+        return _pyramid( level, coords[0], coords[1], coords[2] );
+    }
+
+    // Point on an edge of a coarser cell
+    if( numOffAxes == 1 )
+    {
+        int const axis = offAxes[0];
+        int32_t low[] = { p[0], p[1], p[2] };
+        low[ axis ] &= ~( size - 1 );
+        int32_t high[] = { low[0], low[1], low[2] };
+        high[ axis ] += size;
+        int64_t const t = p[ axis ] - low[ axis ];
+        int64_t const value = int64_t( _sample( low )) * ( size - t ) +
+                int64_t( _sample( high )) * t;
+        return uint8_t(( value + size / 2 ) / size );
+    }
+
+    // Point inside of a face of a coarser cell
+    int const axisA = offAxes[0];
+    int const axisB = offAxes[1];
+    int32_t corner[] = { p[0], p[1], p[2] };
+    corner[ axisA ] &= ~( size - 1 );
+    corner[ axisB ] &= ~( size - 1 );
+    int64_t const ta = p[ axisA ] - corner[ axisA ];
+    int64_t const tb = p[ axisB ] - corner[ axisB ];
+
+    int64_t values[2][2];
+    for( int b = 0; b < 2; ++b )
+    {
+        for( int a = 0; a < 2; ++a )
+        {
+            int32_t q[] = { corner[0], corner[1], corner[2] };
+            q[ axisA ] += a * size;
+            q[ axisB ] += b * size;
+            values[b][a] = _sample( q );
+        }
+    }
+    int64_t const area = int64_t( size ) * int64_t( size );
+    int64_t const value = values[0][0] * ( size - ta ) * ( size - tb ) +
+            values[0][1] * ta * ( size - tb ) +
+            values[1][0] * ( size - ta ) * tb +
+            values[1][1] * ta * tb;
+    int64_t const interpolated = ( value + area / 2 ) / area;
+
+    // The dual point tables separate the inside corners of an ambiguous face,
+    // so its interior must not connect them
+    bool const inside00 = values[0][0] >= _isoValue;
+    bool const inside01 = values[0][1] >= _isoValue;
+    bool const inside10 = values[1][0] >= _isoValue;
+    bool const inside11 = values[1][1] >= _isoValue;
+    if( inside00 == inside11 && inside01 == inside10 && inside00 != inside01 )
+    {
+        return uint8_t( std::min< int64_t >( interpolated, int64_t( _isoValue ) - 1 ));
+    }
+    return uint8_t( interpolated );
+}
+
+/**
+ * @brief LodDualMC::meshBrick
+ * @param brick
+ * @param vertices
+ * @param quads
+ */
+void LodDualMC::_meshBrick( const int32_t brick,
+                            std::vector< Vertex > & vertices,
+                            std::vector< Quad > & quads )
+{
+    int32_t const brickCoords[] =
+    {
+        brick % _numBricks[0],
+        ( brick / _numBricks[0] ) % _numBricks[1],
+        brick / ( _numBricks[0] * _numBricks[1] )
+    };
+    int const level = _brickLevels[ brick ];
+    int32_t const size = int32_t( 1 ) << level;
+    int32_t const cells = _brickSize >> level;
+    int32_t const points = cells + 1;
+    int32_t origin[3];
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        origin[ axis ] = brickCoords[ axis ] << _brickShift;
+    }
+
+    // Sample the grid points of the brick. Interior points belong to the
+    // brick alone.
+    _samples.resize( size_t( points ) * size_t( points ) * size_t( points ));
+    for( int32_t k = 0; k < points; ++k )
+    {
+        for( int32_t j = 0; j < points; ++j )
+        {
+            for( int32_t i = 0; i < points; ++i )
+            {
+                int32_t const p[] = { origin[0] + i * size, origin[1] + j * size, origin[2] + k * size };
+                bool const interior = i > 0 && i < cells && j > 0 && j < cells && k > 0 && k < cells;
+                uint8_t value;
+                if( interior )
+                {
+                    value = _pyramid( level,
+                                      std::min( p[0] >> level, _pyramid.dimension( level, 0 ) - 1 ),
+                                      std::min( p[1] >> level, _pyramid.dimension( level, 1 ) - 1 ),
+                                      std::min( p[2] >> level, _pyramid.dimension( level, 2 ) - 1 ));
+                }
+                else
+                {
+                    value = _sample( p );
+                }
+                _samples[ i + points * ( j + points * size_t( k ))] = value;
+            }
+        }
+    }
+
+    int32_t const lastVoxel[] =
+    {
+        _pyramid.dimension( 0, 0 ) - 1,
+        _pyramid.dimension( 0, 1 ) - 1,
+        _pyramid.dimension( 0, 2 ) - 1
+    };
+    int32_t const stride[] = { 1, points, points * points };
+
+    for( int32_t k = 0; k < points; ++k )
+    {
+        for( int32_t j = 0; j < points; ++j )
+        {
+            for( int32_t i = 0; i < points; ++i )
+            {
+                int32_t const local[] = { i, j, k };
+                int32_t const p[] = { origin[0] + i * size, origin[1] + j * size, origin[2] + k * size };
+                uint8_t const value = _samples[ i + points * ( j + points * size_t( k ))];
+
+                for( int axis = 0; axis < 3; ++axis )
+                {
+                    if( local[ axis ] == cells || p[ axis ] + size > lastVoxel[ axis ])
+                    {
+                        continue;
+                    }
+                    int const u = TRANSVERSE_AXES[ axis ][0];
+                    int const v = TRANSVERSE_AXES[ axis ][1];
+                    if( p[u] > lastVoxel[u] || p[v] > lastVoxel[v] )
+                    {
+                        continue;
+                    }
+
+                    // Edges on the brick border belong to the finest touching
+                    // brick with the lowest index
+                    if( local[u] == 0 || local[u] == cells || local[v] == 0 || local[v] == cells )
+                    {
+                        int32_t first[3];
+                        int32_t last[3];
+                        for( int a = 0; a < 3; ++a )
+                        {
+                            first[a] = last[a] = brickCoords[a];
+                            if( a != axis && local[a] == 0 )
+                                first[a] = std::max( first[a] - 1, 0 );
+                            if( a != axis && local[a] == cells )
+                                last[a] = std::min( last[a] + 1, _numBricks[a] - 1 );
+                        }
+                        bool owned = true;
+                        for( int32_t bz = first[2]; bz <= last[2] && owned; ++bz )
+                            for( int32_t by = first[1]; by <= last[1] && owned; ++by )
+                                for( int32_t bx = first[0]; bx <= last[0] && owned; ++bx )
+                                {
+                                    int32_t const other = _brickIndex( bx, by, bz );
+                                    int const otherLevel = _brickLevels[ other ];
+                                    owned = otherLevel > level || ( otherLevel == level && other >= brick );
+                                }
+                        if( !owned )
+                        {
+                            continue;
+                        }
+                    }
+
+                    uint8_t const next = _samples[ i + points * ( j + points * size_t( k )) +
+                            size_t( stride[ axis ])];
+                    bool const entering = value < _isoValue && next >= _isoValue;
+                    bool const exiting  = value >= _isoValue && next < _isoValue;
+                    if( !entering && !exiting )
+                    {
+                        continue;
+                    }
+
+                    int32_t insideEnd[] = { p[0], p[1], p[2] };
+                    if( entering )
+                    {
+                        insideEnd[ axis ] += size;
+                    }
+
+                    // Find the cells around the edge, which may be coarser
+                    int32_t indices[4];
+                    bool complete = true;
+                    for( int n = 0; n < 4 && complete; ++n )
+                    {
+                        int32_t doubled[3];
+                        doubled[ axis ] = 2 * p[ axis ] + size;
+                        doubled[u] = 2 * p[u] + ( QUADRANTS[ axis ][n][0] == 0 ? 1 : -1 );
+                        doubled[v] = 2 * p[v] + ( QUADRANTS[ axis ][n][1] == 0 ? 1 : -1 );
+                        if( doubled[u] < 0 || doubled[v] < 0 )
+                        {
+                            complete = false;
+                            break;
+                        }
+                        int32_t const other = _brickIndex( doubled[0] >> ( _brickShift + 1 ),
+                                                           doubled[1] >> ( _brickShift + 1 ),
+                                                           doubled[2] >> ( _brickShift + 1 ));
+                        if( other < 0 )
+                        {
+                            complete = false;
+                            break;
+                        }
+                        int const otherLevel = _brickLevels[ other ];
+                        int32_t cell[3];
+                        for( int a = 0; a < 3; ++a )
+                        {
+                            cell[a] = doubled[a] >> ( otherLevel + 1 );
+                            complete = complete && ( cell[a] << otherLevel ) < lastVoxel[a];
+                        }
+                        if( !complete )
+                        {
+                            break;
+                        }
+
+                        // Cells of this brick read the sampled grid points
+                        int cubeCode;
+                        if( other == brick )
+                        {
+                            int32_t const base = ( cell[0] - ( origin[0] >> level )) +
+                                    points * (( cell[1] - ( origin[1] >> level )) +
+                                    points * ( cell[2] - ( origin[2] >> level )));
+                            cubeCode = 0;
+                            for( int corner = 0; corner < 8; ++corner )
+                            {
+                                int32_t const offset = ( corner & 1 ) +
+                                        ( corner & 2 ? stride[1] : 0 ) +
+                                        ( corner & 4 ? stride[2] : 0 );
+                                cubeCode |= _samples[ size_t( base + offset )] >= _isoValue ?
+                                            1 << corner : 0;
+                            }
+                        }
+                        else
+                        {
+                            LevelVolume const volume = { *this, otherLevel };
+                            cubeCode = _builder._getCellCode( volume, cell[0], cell[1], cell[2],
+                                                              _isoValue );
+                        }
+                        indices[n] = _dualPointIndex( otherLevel, cell, cubeCode, axis, p,
+                                                      insideEnd, vertices );
+                    }
+                    if( !complete )
+                    {
+                        continue;
+                    }
+
+                    bool const forward = axis == 0 ? entering : exiting;
+                    if( forward )
+                    {
+                        quads.emplace_back( indices[0], indices[1], indices[2], indices[3] );
+                    }
+                    else
+                    {
+                        quads.emplace_back( indices[0], indices[3], indices[2], indices[1] );
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief LodDualMC::dualPointIndex
+ * @param level
+ * @param cell
+ * @param cubeCode
+ * @param axis
+ * @param p
+ * @param insideEnd
+ * @param vertices
+ * @return
+ */
+int32_t LodDualMC::_dualPointIndex( const int level, const int32_t cell[3], const int cubeCode,
+                                    const int axis, const int32_t p[3],
+                                    const int32_t insideEnd[3],
+                                    std::vector< Vertex > & vertices )
+{
+    // Position of the edge relative to the cell
+    int32_t const size = int32_t( 1 ) << level;
+    int32_t offset[3];
+    int sides[3] = { 0, 0, 0 };
+    for( int a = 0; a < 3; ++a )
+    {
+        offset[a] = p[a] - ( cell[a] << level );
+        sides[a] = offset[a] == size ? 1 : 0;
+    }
+    int const u = TRANSVERSE_AXES[ axis ][0];
+    int const v = TRANSVERSE_AXES[ axis ][1];
+    bool const onBorderU = offset[u] == 0 || offset[u] == size;
+    bool const onBorderV = offset[v] == 0 || offset[v] == size;
+
+    DMC_EDGE_CODE edge;
+    if( onBorderU && onBorderV )
+    {
+        // The edge is a cell edge or a part of it
+        edge = cellEdge( axis, sides );
+    }
+    else
+    {
+        // The edge lies inside of a cell face. Use the crossing face edge
+        // closest to the inside end point, which belongs to the same patch.
+        int const across = onBorderU ? v : u;
+        int32_t inside[3];
+        for( int a = 0; a < 3; ++a )
+        {
+            inside[a] = insideEnd[a] - ( cell[a] << level );
+        }
+
+        int32_t bestDistance = -1;
+        edge = EDGE0;
+        for( int side = 0; side < 2; ++side )
+        {
+            // Face edges parallel to the edge
+            int parallelSides[] = { sides[0], sides[1], sides[2] };
+            parallelSides[ across ] = side;
+            DMC_EDGE_CODE const parallel = cellEdge( axis, parallelSides );
+            int32_t const parallelDistance = side == 0 ? inside[ across ] : size - inside[ across ];
+            if( edgeDualPoints[ cubeCode ][ edgeIndex( parallel )] != 0 &&
+                ( bestDistance < 0 || parallelDistance < bestDistance ))
+            {
+                bestDistance = parallelDistance;
+                edge = parallel;
+            }
+
+            // Face edges across the edge
+            int acrossSides[] = { sides[0], sides[1], sides[2] };
+            acrossSides[ axis ] = side;
+            DMC_EDGE_CODE const perpendicular = cellEdge( across, acrossSides );
+            int32_t const perpendicularDistance = side == 0 ? inside[ axis ] : size - inside[ axis ];
+            if( edgeDualPoints[ cubeCode ][ edgeIndex( perpendicular )] != 0 &&
+                ( bestDistance < 0 || perpendicularDistance < bestDistance ))
+            {
+                bestDistance = perpendicularDistance;
+                edge = perpendicular;
+            }
+        }
+    }
+
+    // Have we already computed the dual point?
+    int const pointCode = edgeDualPoints[ cubeCode ][ edgeIndex( edge )];
+    uint64_t const cellsX = uint64_t( _numBricks[0] * _brickSize ) >> level;
+    uint64_t const cellsY = uint64_t( _numBricks[1] * _brickSize ) >> level;
+    uint64_t const linearCell = uint64_t( cell[0] ) +
+            cellsX * ( uint64_t( cell[1] ) + cellsY * uint64_t( cell[2] ));
+    uint64_t const key = ( linearCell << 16 ) | ( uint64_t( level ) << 12 ) | uint64_t( pointCode );
+    auto const iterator = _pointToIndex.find( key );
+    if( iterator != _pointToIndex.end())
+    {
+        return iterator->second;
+    }
+
+    // Compute the dual point on the lattice of the level
+    int32_t const index = int32_t( vertices.size());
+    vertices.emplace_back();
+    Vertex & vertex = vertices.back();
+    LevelVolume const volume = { *this, level };
+    _builder._calculateDualPoint( volume, cell[0], cell[1], cell[2], _isoValue,
+                                  pointCode, vertex );
+    vertex.x *= float( size );
+    vertex.y *= float( size );
+    vertex.z *= float( size );
+    _pointToIndex[ key ] = index;
+    return index;
+}
+
+/**
+ * @brief LodDualMC::brickIndex
+ * @param bx
+ * @param by
+ * @param bz
+ * @return
+ */
+int32_t LodDualMC::_brickIndex( const int32_t bx, const int32_t by, const int32_t bz ) const
+{
+    if( bx < 0 || by < 0 || bz < 0 ||
+        bx >= _numBricks[0] || by >= _numBricks[1] || bz >= _numBricks[2] )
+    {
+        return -1;
+    }
+    return bx + _numBricks[0] * ( by + _numBricks[1] * bz );
+}
+
+}
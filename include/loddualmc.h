@@ -0,0 +1,211 @@
+#ifndef LODDUALMC_H
+#define LODDUALMC_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <unordered_map>
+#include <vector>
+
+#include "dualmc.h"
+#include "volumepyramid.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief The LodDualMC class
+ * Multi-resolution dual marching cubes builder. The volume is partitioned
+ * into cubic bricks, which are extracted at their own level of detail from a
+ * volume pyramid. Cells of a brick at level l span 2^l voxels of the finest
+ * level, so the quad count of a brick drops by a factor of about 4^l.
+ * Neighboring bricks may use arbitrary levels. Quads are generated for the
+ * edges of the finest brick touching them and connect the dual points of all
+ * cells around an edge, including coarser ones. Voxels of a finer brick on
+ * the border to a coarser brick are interpolated from the coarser grid, so
+ * both sides see the same surface crossings and the mesh stays watertight.
+ * Quads across level transitions may be degenerate, with two consecutive
+ * equal indices forming a triangle.
+ * Cells at the volume border are dropped like in the single resolution
+ * builder. Manifold dual marching cubes is not supported.
+ */
+class LodDualMC
+{
+public:
+
+    /**
+     * @brief LodDualMC
+     * @param pyramid
+     * The referenced volume pyramid, which has to stay valid.
+     * @param brickSize
+     * Edge length of the bricks in cells of the finest level. Rounded up to
+     * a power of two.
+     */
+    explicit LodDualMC( const VolumePyramid & pyramid, const int32_t brickSize = 32 );
+
+    /// Number of bricks along an axis
+    int32_t numBricks( const int axis ) const;
+
+    /// Coarsest level usable for a brick
+    int maxLevel() const;
+
+    /// Level of detail of a brick
+    int brickLevel( const int32_t bx, const int32_t by, const int32_t bz ) const;
+
+    /// Set the level of detail of a brick, clamped to [0, maxLevel()]
+    void setBrickLevel( const int32_t bx, const int32_t by, const int32_t bz,
+                        const int level );
+
+    /**
+     * @brief selectLevels
+     * Choose the level of each brick by the distance of its center to a
+     * viewpoint. Bricks closer than detailDistance use the finest level. Each
+     * doubling of the distance selects the next coarser level.
+     * @param viewpoint
+     * Viewpoint in voxel coordinates of the finest level.
+     * @param detailDistance
+     */
+    void selectLevels( const float viewpoint[3], const float detailDistance );
+
+    /**
+     * @brief build
+     * Extract the iso surface with the selected levels of detail. Vertices
+     * are in voxel coordinates of the finest level.
+     * @param isoValue
+     * @param vertices
+     * @param quads
+     */
+    void build( const uint8_t isoValue,
+                std::vector< Vertex > & vertices,
+                std::vector< Quad > & quads );
+
+private:
+
+    /**
+     * @brief _pointLevel
+     * Coarsest level of the bricks touching a grid point.
+     * @param p
+     * Point in voxel coordinates of the finest level.
+     * @return
+     */
+    int _pointLevel( const int32_t p[3] ) const;
+
+    /**
+     * @brief _sample
+     * Value of a grid point seen by all cells touching it. Points on the
+     * lattice of the coarsest touching brick read its pyramid level. Other
+     * points lie on an edge or face of a coarser cell and are interpolated
+     * from its corners. The interior of ambiguous faces is kept outside, as
+     * the dual point tables separate the inside corners of ambiguous faces.
+     * @param p
+     * Point in voxel coordinates of the finest level.
+     * @return
+     */
+    uint8_t _sample( const int32_t p[3] ) const;
+
+    /**
+     * @brief _meshBrick
+     * Generate the quads of the edges owned by a brick.
+     * @param brick
+     * @param vertices
+     * @param quads
+     */
+    void _meshBrick( const int32_t brick,
+                     std::vector< Vertex > & vertices,
+                     std::vector< Quad > & quads );
+
+    /**
+     * @brief _dualPointIndex
+     * Get the shared index of the dual point of the cell at level around the
+     * given quadrant of an edge. The edge lies on an edge or face of the cell.
+     * @param level
+     * @param cell
+     * Cell coordinates at the level.
+     * @param cubeCode
+     * @param axis
+     * @param p
+     * Edge base point in voxel coordinates of the finest level.
+     * @param insideEnd
+     * Edge end point, whose value is inside.
+     * @param vertices
+     * @return
+     */
+    int32_t _dualPointIndex( const int level, const int32_t cell[3], const int cubeCode,
+                             const int axis, const int32_t p[3],
+                             const int32_t insideEnd[3],
+                             std::vector< Vertex > & vertices );
+
+    /// Volume accessor for the grid points of a level
+    struct LevelVolume
+    {
+        const LodDualMC & lod;
+        int level;
+
+        /// The value of grid point ( x, y, z ) * 2^level
+        uint8_t operator()( const int32_t x, const int32_t y, const int32_t z ) const
+        {
+            int32_t const p[] = { x << level, y << level, z << level };
+            return lod._sample( p );
+        }
+    };
+
+    /// Linear index of a brick or -1 outside of the brick grid
+    int32_t _brickIndex( const int32_t bx, const int32_t by, const int32_t bz ) const;
+
+private:
+
+    /**
+     * @brief _builder
+     * Builder providing the per-cell functions.
+     */
+    DualMC _builder;
+
+    /**
+     * @brief _pyramid
+     * The referenced volume pyramid.
+     */
+    const VolumePyramid & _pyramid;
+
+    /**
+     * @brief _brickSize, _brickShift
+     * Edge length of the bricks in cells of the finest level and its log2.
+     */
+    int32_t _brickSize;
+    int _brickShift;
+
+    /**
+     * @brief _numBricks
+     * Number of bricks along each axis.
+     */
+    int32_t _numBricks[3];
+
+    /**
+     * @brief _brickLevels
+     * Level of detail of each brick.
+     */
+    std::vector< uint8_t > _brickLevels;
+
+    /**
+     * @brief _isoValue
+     */
+    uint8_t _isoValue;
+
+    /**
+     * @brief _samples
+     * Grid point values of the brick being meshed.
+     */
+    std::vector< uint8_t > _samples;
+
+    /**
+     * @brief _pointToIndex
+     * Shared vertex indices of the dual points keyed by level, cell and
+     * point code.
+     */
+    std::unordered_map< uint64_t, int32_t > _pointToIndex;
+};
+
+}
+
+#endif // LODDUALMC_H
@@ -0,0 +1,472 @@
+#include "meshcomponents.h"
+
+// C includes
+#include <cmath>
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+
+#include "parallel.h"
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Number of quads joined per parallel task
+const int32_t QUADS_PER_TASK = 1 << 15;
+
+/// Number of vertices labeled per parallel task
+const int32_t VERTICES_PER_TASK = 1 << 16;
+
+/// Number of tasks for the given number of elements
+inline int32_t numTasks( const size_t size, const int32_t perTask )
+{
+    return int32_t(( size + size_t( perTask ) - 1 ) / size_t( perTask ));
+}
+
+/// Surface area of a quad, half the length of the cross product of its diagonals
+inline double quadArea( const std::vector< Vertex > & vertices, const Quad & quad )
+{
+    const Vertex & v0 = vertices[ quad.i0 ];
+    const Vertex & v1 = vertices[ quad.i1 ];
+    const Vertex & v2 = vertices[ quad.i2 ];
+    const Vertex & v3 = vertices[ quad.i3 ];
+    float const ax = v2.x - v0.x, ay = v2.y - v0.y, az = v2.z - v0.z;
+    float const bx = v3.x - v1.x, by = v3.y - v1.y, bz = v3.z - v1.z;
+    float const cx = ay * bz - az * by;
+    float const cy = az * bx - ax * bz;
+    float const cz = ax * by - ay * bx;
+    return 0.5 * std::sqrt( double( cx * cx + cy * cy + cz * cz ));
+}
+
+/// A component is dropped, if it misses one of the filter limits
+inline bool isDropped( const ComponentFilter & filter, const size_t numQuads, const double area )
+{
+    return numQuads > 0 && ( numQuads < filter.minQuads || area < double( filter.minArea ));
+}
+
+/**
+ * @brief findRoot
+ * Root of the set of a vertex in a concurrent union find. Path halving
+ * replaces parents by grandparents, which is safe while other threads
+ * link roots.
+ * @param parents
+ * @param vertex
+ * @return
+ */
+int32_t findRoot( std::vector< std::atomic< int32_t > > & parents, int32_t vertex )
+{
+    for( ;; )
+    {
+        int32_t parent = parents[ vertex ].load( std::memory_order_relaxed );
+        if( parent == vertex )
+        {
+            return vertex;
+        }
+        int32_t const grandParent = parents[ parent ].load( std::memory_order_relaxed );
+        if( grandParent != parent )
+        {
+            parents[ vertex ].compare_exchange_weak( parent, grandParent, std::memory_order_relaxed );
+        }
+        vertex = grandParent;
+    }
+}
+
+/**
+ * @brief uniteRoots
+ * Join the sets of two vertices in a concurrent union find. The larger root
+ * is linked below the smaller one, if it is still a root, so no cycles can
+ * form and each root is the smallest vertex of its set.
+ * @param parents
+ * @param a
+ * @param b
+ */
+void uniteRoots( std::vector< std::atomic< int32_t > > & parents, int32_t a, int32_t b )
+{
+    for( ;; )
+    {
+        a = findRoot( parents, a );
+        b = findRoot( parents, b );
+        if( a == b )
+        {
+            return;
+        }
+        if( a < b )
+        {
+            std::swap( a, b );
+        }
+        int32_t expected = a;
+        if( parents[ a ].compare_exchange_strong( expected, b ))
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief numberRoots
+ * Replace the root of each vertex by a dense component label in the order
+ * of the smallest vertex of each component.
+ * @param labels
+ * Roots as input, labels as output.
+ * @return Number of components.
+ */
+int32_t numberRoots( std::vector< int32_t > & labels )
+{
+    // Roots are the smallest vertices of their sets, so they are labeled
+    // before the other vertices of their sets
+    int32_t numComponents = 0;
+    for( size_t v = 0; v < labels.size(); ++v )
+    {
+        int32_t const root = labels[v];
+        labels[v] = root == int32_t( v ) ? numComponents++ : labels[ root ];
+    }
+    return numComponents;
+}
+
+/**
+ * @brief removeComponents
+ * Remove the components below the filter limits from a labeled mesh.
+ * @param vertices
+ * @param quads
+ * @param labels
+ * @param numComponents
+ * @param filter
+ * @param numThreads
+ * @return Number of removed components.
+ */
+size_t removeComponents( std::vector< Vertex > & vertices,
+                         std::vector< Quad > & quads,
+                         const std::vector< int32_t > & labels,
+                         const int32_t numComponents,
+                         const ComponentFilter & filter,
+                         const unsigned int numThreads )
+{
+    // Quad count and area of each component
+    std::vector< size_t > componentQuads( numComponents, 0 );
+    std::vector< double > componentAreas( numComponents, 0.0 );
+    for( const Quad & quad : quads )
+    {
+        int32_t const component = labels[ quad.i0 ];
+        ++componentQuads[ component ];
+        if( filter.minArea > 0.0f )
+        {
+            componentAreas[ component ] += quadArea( vertices, quad );
+        }
+    }
+
+    size_t removed = 0;
+    std::vector< uint8_t > keep( numComponents, 1 );
+    for( int32_t c = 0; c < numComponents; ++c )
+    {
+        if( isDropped( filter, componentQuads[c], componentAreas[c] ))
+        {
+            keep[c] = 0;
+            ++removed;
+        }
+    }
+    if( removed == 0 )
+    {
+        return 0;
+    }
+
+    // Keep the quads of the remaining components and number their vertices
+    // in the previous order
+    quads.erase( std::remove_if( quads.begin(), quads.end(),
+                                 [ & ]( const Quad & quad ) { return keep[ labels[ quad.i0 ]] == 0; } ),
+                 quads.end());
+    std::vector< int32_t > remap( vertices.size(), -1 );
+    for( const Quad & quad : quads )
+    {
+        for( int k = 0; k < 4; ++k )
+        {
+            remap[ quad[k] ] = 0;
+        }
+    }
+    int32_t numVertices = 0;
+    for( size_t v = 0; v < vertices.size(); ++v )
+    {
+        if( remap[v] == 0 )
+        {
+            remap[v] = numVertices;
+            if( size_t( numVertices ) != v )
+            {
+                vertices[ numVertices ].x = vertices[v].x;
+                vertices[ numVertices ].y = vertices[v].y;
+                vertices[ numVertices ].z = vertices[v].z;
+            }
+            ++numVertices;
+        }
+    }
+    vertices.resize( size_t( numVertices ));
+
+    parallelFor( 0, numTasks( quads.size(), QUADS_PER_TASK ), [ & ]( const int32_t task )
+    {
+        size_t const begin = size_t( task ) * QUADS_PER_TASK;
+        size_t const end = std::min( begin + QUADS_PER_TASK, quads.size());
+        for( size_t q = begin; q < end; ++q )
+        {
+            Quad & quad = quads[q];
+            quad.i0 = remap[ quad.i0 ];
+            quad.i1 = remap[ quad.i1 ];
+            quad.i2 = remap[ quad.i2 ];
+            quad.i3 = remap[ quad.i3 ];
+        }
+    }, numThreads );
+
+    return removed;
+}
+
+}
+
+/**
+ * @brief labelComponents
+ * @param quads
+ * @param numVertices
+ * @param labels
+ * @param numThreads
+ * @return
+ */
+int32_t labelComponents( const std::vector< Quad > & quads,
+                         const size_t numVertices,
+                         std::vector< int32_t > & labels,
+                         const unsigned int numThreads )
+{
+    std::vector< std::atomic< int32_t > > parents( numVertices );
+    int32_t const vertexTasks = numTasks( numVertices, VERTICES_PER_TASK );
+    parallelFor( 0, vertexTasks, [ & ]( const int32_t task )
+    {
+        size_t const begin = size_t( task ) * VERTICES_PER_TASK;
+        size_t const end = std::min( begin + VERTICES_PER_TASK, numVertices );
+        for( size_t v = begin; v < end; ++v )
+        {
+            parents[v].store( int32_t( v ), std::memory_order_relaxed );
+        }
+    }, numThreads );
+
+    // Join the vertices of each quad
+    parallelFor( 0, numTasks( quads.size(), QUADS_PER_TASK ), [ & ]( const int32_t task )
+    {
+        size_t const begin = size_t( task ) * QUADS_PER_TASK;
+        size_t const end = std::min( begin + QUADS_PER_TASK, quads.size());
+        for( size_t q = begin; q < end; ++q )
+        {
+            const Quad & quad = quads[q];
+            uniteRoots( parents, quad.i0, quad.i1 );
+            uniteRoots( parents, quad.i0, quad.i2 );
+            uniteRoots( parents, quad.i0, quad.i3 );
+        }
+    }, numThreads );
+
+    labels.resize( numVertices );
+    parallelFor( 0, vertexTasks, [ & ]( const int32_t task )
+    {
+        size_t const begin = size_t( task ) * VERTICES_PER_TASK;
+        size_t const end = std::min( begin + VERTICES_PER_TASK, numVertices );
+        for( size_t v = begin; v < end; ++v )
+        {
+            labels[v] = findRoot( parents, int32_t( v ));
+        }
+    }, numThreads );
+
+    return numberRoots( labels );
+}
+
+/**
+ * @brief filterComponents
+ * @param vertices
+ * @param quads
+ * @param filter
+ * @param numThreads
+ * @return
+ */
+size_t filterComponents( std::vector< Vertex > & vertices,
+                         std::vector< Quad > & quads,
+                         const ComponentFilter & filter,
+                         const unsigned int numThreads )
+{
+    std::vector< int32_t > labels;
+    int32_t const numComponents = labelComponents( quads, vertices.size(), labels, numThreads );
+    return removeComponents( vertices, quads, labels, numComponents, filter, numThreads );
+}
+
+/**
+ * @brief ComponentLabeler::ComponentLabeler
+ * @param filter
+ * @param vertices
+ * @param quads
+ */
+ComponentLabeler::ComponentLabeler( const ComponentFilter & filter,
+                                    std::vector< Vertex > & vertices,
+                                    std::vector< Quad > & quads )
+    : _filter( filter ),
+      _vertices( vertices ),
+      _quads( quads ),
+      _layer( 0 ),
+      _numJoined( 0 ),
+      _numFinished( 0 ),
+      _numRemoved( 0 )
+{
+    _vertices.clear();
+    _quads.clear();
+}
+
+/**
+ * @brief ComponentLabeler::addLayer
+ * @param sweepVertices
+ * @param pendingQuads
+ */
+void ComponentLabeler::addLayer( const std::vector< Vertex > & sweepVertices,
+                                 std::vector< Quad > & pendingQuads )
+{
+    for( size_t v = _parents.size(); v < sweepVertices.size(); ++v )
+    {
+        _parents.push_back( int32_t( v ));
+        _lastLayers.push_back( -1 );
+        _numQuads.push_back( 0 );
+        _areas.push_back( 0.0 );
+        _remap.push_back( -1 );
+    }
+
+    // Join the quads of the layer and mark their components as touched
+    _previousRoots.swap( _layerRoots );
+    _layerRoots.clear();
+    for( ; _numJoined < pendingQuads.size(); ++_numJoined )
+    {
+        const Quad & quad = pendingQuads[ _numJoined ];
+        int32_t a = _find( quad[0] );
+        for( int k = 1; k < 4; ++k )
+        {
+            int32_t b = _find( quad[k] );
+            if( a == b )
+            {
+                continue;
+            }
+            if( b < a )
+            {
+                std::swap( a, b );
+            }
+            _parents[b] = a;
+            _numQuads[a] += _numQuads[b];
+            _areas[a] += _areas[b];
+        }
+        ++_numQuads[a];
+        if( _filter.minArea > 0.0f )
+        {
+            _areas[a] += quadArea( sweepVertices, quad );
+        }
+        if( _lastLayers[a] != _layer )
+        {
+            _lastLayers[a] = _layer;
+            _layerRoots.push_back( a );
+        }
+    }
+
+    _finishComponents();
+
+    // Compact the pending quads, once half of them are finished
+    if( _numFinished > 0 && 2 * _numFinished >= pendingQuads.size())
+    {
+        _emitFinished( sweepVertices, pendingQuads );
+    }
+    ++_layer;
+}
+
+/**
+ * @brief ComponentLabeler::finish
+ * @param sweepVertices
+ * @param pendingQuads
+ * @return
+ */
+size_t ComponentLabeler::finish( const std::vector< Vertex > & sweepVertices,
+                                 std::vector< Quad > & pendingQuads )
+{
+    // Quads appended after the last layer notification form a last layer,
+    // which is followed by an empty one finishing all components
+    addLayer( sweepVertices, pendingQuads );
+    addLayer( sweepVertices, pendingQuads );
+    _emitFinished( sweepVertices, pendingQuads );
+    return _numRemoved;
+}
+
+/**
+ * @brief ComponentLabeler::_finishComponents
+ */
+void ComponentLabeler::_finishComponents()
+{
+    // Components of the previous layer without a quad in this layer are
+    // finished. Merged roots were touched by the merging quad.
+    for( int32_t const root : _previousRoots )
+    {
+        if( _parents[ root ] != root || _lastLayers[ root ] == _layer )
+        {
+            continue;
+        }
+        _numFinished += _numQuads[ root ];
+        if( isDropped( _filter, _numQuads[ root ], _areas[ root ]))
+        {
+            ++_numRemoved;
+        }
+    }
+}
+
+/**
+ * @brief ComponentLabeler::_emitFinished
+ * @param sweepVertices
+ * @param pendingQuads
+ */
+void ComponentLabeler::_emitFinished( const std::vector< Vertex > & sweepVertices,
+                                      std::vector< Quad > & pendingQuads )
+{
+    size_t numPending = 0;
+    for( const Quad & quad : pendingQuads )
+    {
+        int32_t const root = _find( quad.i0 );
+        if( _lastLayers[ root ] == _layer )
+        {
+            pendingQuads[ numPending++ ] = quad;
+            continue;
+        }
+        if( isDropped( _filter, _numQuads[ root ], _areas[ root ]))
+        {
+            continue;
+        }
+
+        // Append the quad with its vertices in the order of first use
+        Quad kept;
+        for( int k = 0; k < 4; ++k )
+        {
+            int32_t & index = _remap[ quad[k] ];
+            if( index < 0 )
+            {
+                index = int32_t( _vertices.size());
+                _vertices.push_back( sweepVertices[ quad[k] ]);
+            }
+            kept[k] = index;
+        }
+        _quads.push_back( kept );
+    }
+    pendingQuads.resize( numPending );
+    _numJoined = numPending;
+    _numFinished = 0;
+}
+
+/**
+ * @brief ComponentLabeler::_find
+ * @param vertex
+ * @return
+ */
+int32_t ComponentLabeler::_find( int32_t vertex )
+{
+    while( _parents[ vertex ] != vertex )
+    {
+        _parents[ vertex ] = _parents[ _parents[ vertex ]];
+        vertex = _parents[ vertex ];
+    }
+    return vertex;
+}
+
+}
@@ -0,0 +1,212 @@
+#ifndef MESHCOMPONENTS_H
+#define MESHCOMPONENTS_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+#include "quad.h"
+#include "vertex.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief The ComponentFilter struct
+ * Limits below which connected components of a mesh are dropped, for
+ * example the small floating islands extracted from noisy scans. A
+ * component is kept, if it reaches both limits.
+ */
+struct ComponentFilter
+{
+    /// Initializing constructor
+    ComponentFilter( const size_t minQuads = 0, const float minArea = 0.0f )
+        : minQuads( minQuads ),
+          minArea( minArea )
+    {
+        /// EMPTY
+    }
+
+    /// Minimum number of quads of a kept component
+    size_t minQuads;
+
+    /// Minimum surface area of a kept component
+    float minArea;
+};
+
+/**
+ * @brief labelComponents
+ * Label the connected components of a quad mesh, where quads sharing a
+ * vertex are connected. The vertices of the quads are joined in a lock-free
+ * union find, which processes chunks of quads in parallel. Components are
+ * numbered in the order of their smallest vertex index, so the labels do not
+ * depend on the number of threads. Unreferenced vertices form components
+ * without quads.
+ * @param quads
+ * @param numVertices
+ * @param labels
+ * Output component label of each vertex.
+ * @param numThreads
+ * Number of threads, zero uses all hardware threads.
+ * @return Number of components.
+ */
+int32_t labelComponents( const std::vector< Quad > & quads,
+                         const size_t numVertices,
+                         std::vector< int32_t > & labels,
+                         const unsigned int numThreads = 0 );
+
+/**
+ * @brief filterComponents
+ * Remove the connected components below the filter limits from a mesh.
+ * The remaining quads and vertices keep their order, and vertices no longer
+ * referenced are removed.
+ * @param vertices
+ * @param quads
+ * @param filter
+ * @param numThreads
+ * Number of threads, zero uses all hardware threads.
+ * @return Number of removed components.
+ */
+size_t filterComponents( std::vector< Vertex > & vertices,
+                         std::vector< Quad > & quads,
+                         const ComponentFilter & filter,
+                         const unsigned int numThreads = 0 );
+
+/**
+ * @brief The ComponentLabeler class
+ * Union find over the vertices of a mesh, which grows while it is swept
+ * along z. The quads of each finished voxel layer are joined, and each
+ * component remembers the last layer that added a quad. The quads of a
+ * voxel layer only share dual points with the previous layer, so a
+ * component without quads in the last layer is finished. Finished
+ * components below the filter limits are dropped, the others are appended
+ * to the output mesh. Quads of unfinished components wait in a pending
+ * buffer, which is compacted as components finish. The vertices of the
+ * sweep stay in place until it is done, because later quads refer to them
+ * by index.
+ */
+class ComponentLabeler
+{
+public:
+
+    /**
+     * @brief ComponentLabeler
+     * @param filter
+     * @param vertices
+     * Output vertices of the kept components, which are cleared.
+     * @param quads
+     * Output quads of the kept components, which are cleared.
+     */
+    ComponentLabeler( const ComponentFilter & filter,
+                      std::vector< Vertex > & vertices,
+                      std::vector< Quad > & quads );
+
+    /**
+     * @brief addLayer
+     * Join the quads appended to the pending quads since the last call as
+     * the next voxel layer, and hand out the components finished by it.
+     * @param sweepVertices
+     * Vertices of the sweep so far.
+     * @param pendingQuads
+     * Quads of the sweep, which are not handed out yet.
+     */
+    void addLayer( const std::vector< Vertex > & sweepVertices,
+                   std::vector< Quad > & pendingQuads );
+
+    /**
+     * @brief finish
+     * Hand out all remaining components after the last layer.
+     * @param sweepVertices
+     * @param pendingQuads
+     * @return Number of removed components.
+     */
+    size_t finish( const std::vector< Vertex > & sweepVertices,
+                   std::vector< Quad > & pendingQuads );
+
+private:
+
+    /// Root of the set of a vertex with path halving
+    int32_t _find( int32_t vertex );
+
+    /// Count the components, which were last touched in the previous layer
+    void _finishComponents();
+
+    /// Append the quads of finished components to the output
+    void _emitFinished( const std::vector< Vertex > & sweepVertices,
+                        std::vector< Quad > & pendingQuads );
+
+private:
+
+    /**
+     * @brief _filter
+     * Limits of the kept components.
+     */
+    ComponentFilter _filter;
+
+    /**
+     * @brief _vertices, _quads
+     * The output mesh.
+     */
+    std::vector< Vertex > & _vertices;
+    std::vector< Quad > & _quads;
+
+    /**
+     * @brief _parents
+     * Parent of each vertex in the union find forest. Sets are linked below
+     * their smaller root, so each root is the smallest vertex of its set.
+     */
+    std::vector< int32_t > _parents;
+
+    /**
+     * @brief _lastLayers, _numQuads, _areas
+     * Last layer with a quad, number of quads and surface area of the
+     * component of each root.
+     */
+    std::vector< int32_t > _lastLayers;
+    std::vector< uint32_t > _numQuads;
+    std::vector< double > _areas;
+
+    /**
+     * @brief _remap
+     * Output index of each sweep vertex, or -1 before its first kept quad.
+     */
+    std::vector< int32_t > _remap;
+
+    /**
+     * @brief _previousRoots, _layerRoots
+     * Roots touched in the previous and in the current layer.
+     */
+    std::vector< int32_t > _previousRoots;
+    std::vector< int32_t > _layerRoots;
+
+    /**
+     * @brief _layer
+     * Index of the current layer.
+     */
+    int32_t _layer;
+
+    /**
+     * @brief _numJoined
+     * Number of pending quads joined so far.
+     */
+    size_t _numJoined;
+
+    /**
+     * @brief _numFinished
+     * Number of pending quads of finished components.
+     */
+    size_t _numFinished;
+
+    /**
+     * @brief _numRemoved
+     * Number of removed components.
+     */
+    size_t _numRemoved;
+};
+
+}
+
+#endif // MESHCOMPONENTS_H
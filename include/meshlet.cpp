@@ -0,0 +1,198 @@
+#include "meshlet.h"
+
+// C includes
+#include <cmath>
+
+// STL includes
+#include <algorithm>
+
+namespace dualmc
+{
+
+/**
+ * @brief MeshletAssembler::MeshletAssembler
+ * @param mesh
+ * @param numTiles
+ */
+MeshletAssembler::MeshletAssembler( MeshletMesh & mesh, const int32_t numTiles )
+    : _mesh( mesh ),
+      _maxVertices( std::min( std::max( mesh.maxVertices, 4u ), uint32_t( MeshletMesh::MAX_VERTICES ))),
+      _maxTriangles( std::max( mesh.maxTriangles, 2u ))
+{
+    _mesh.clear();
+    _tiles.resize( size_t( std::max( numTiles, 1 )));
+}
+
+/**
+ * @brief MeshletAssembler::addQuad
+ * @param tile
+ * @param quad
+ * @param vertices
+ */
+void MeshletAssembler::addQuad( const int32_t tile, const Quad & quad,
+                                const std::vector< Vertex > & vertices )
+{
+    OpenMeshlet & open = _tiles[ tile ];
+    uint32_t const quadIndices[] =
+    {
+        uint32_t( quad.i0 ), uint32_t( quad.i1 ), uint32_t( quad.i2 ), uint32_t( quad.i3 )
+    };
+
+    // Find the quad vertices already in the meshlet
+    int local[4];
+    uint32_t newVertices = 0;
+    for( int k = 0; k < 4; ++k )
+    {
+        auto const found = std::find( open.vertexIndices.begin(), open.vertexIndices.end(),
+                                      quadIndices[k] );
+        local[k] = found == open.vertexIndices.end() ? -1 :
+                                                       int( found - open.vertexIndices.begin());
+        newVertices += local[k] < 0 ? 1 : 0;
+    }
+
+    // Start a new meshlet if the quad does not fit
+    if( open.vertexIndices.size() + newVertices > _maxVertices ||
+            open.triangles.size() / 3 + 2 > _maxTriangles )
+    {
+        _close( open, vertices );
+        std::fill( local, local + 4, -1 );
+    }
+
+    for( int k = 0; k < 4; ++k )
+    {
+        if( local[k] < 0 )
+        {
+            local[k] = int( open.vertexIndices.size());
+            open.vertexIndices.push_back( quadIndices[k] );
+        }
+    }
+
+    // Split the quad along the diagonal from its first vertex
+    uint8_t const triangles[] =
+    {
+        uint8_t( local[0] ), uint8_t( local[1] ), uint8_t( local[2] ),
+        uint8_t( local[0] ), uint8_t( local[2] ), uint8_t( local[3] )
+    };
+    open.triangles.insert( open.triangles.end(), triangles, triangles + 6 );
+}
+
+/**
+ * @brief MeshletAssembler::flush
+ * @param vertices
+ */
+void MeshletAssembler::flush( const std::vector< Vertex > & vertices )
+{
+    for( auto & open : _tiles )
+    {
+        _close( open, vertices );
+    }
+}
+
+/**
+ * @brief MeshletAssembler::_close
+ * @param open
+ * @param vertices
+ */
+void MeshletAssembler::_close( OpenMeshlet & open, const std::vector< Vertex > & vertices )
+{
+    if( open.triangles.empty())
+    {
+        return;
+    }
+
+    Meshlet meshlet;
+    meshlet.vertexOffset = uint32_t( _mesh.vertexIndices.size());
+    meshlet.triangleOffset = uint32_t( _mesh.triangles.size() / 3 );
+    meshlet.vertexCount = uint32_t( open.vertexIndices.size());
+    meshlet.triangleCount = uint32_t( open.triangles.size() / 3 );
+
+    // Bounding sphere around the center of the bounding box
+    float lower[] = { vertices[ open.vertexIndices[0] ].x,
+                      vertices[ open.vertexIndices[0] ].y,
+                      vertices[ open.vertexIndices[0] ].z };
+    float upper[] = { lower[0], lower[1], lower[2] };
+    for( uint32_t const index : open.vertexIndices )
+    {
+        Vertex const & v = vertices[ index ];
+        lower[0] = std::min( lower[0], v.x );
+        lower[1] = std::min( lower[1], v.y );
+        lower[2] = std::min( lower[2], v.z );
+        upper[0] = std::max( upper[0], v.x );
+        upper[1] = std::max( upper[1], v.y );
+        upper[2] = std::max( upper[2], v.z );
+    }
+    float radius2 = 0.0f;
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        meshlet.center[ axis ] = 0.5f * ( lower[ axis ] + upper[ axis ]);
+    }
+    for( uint32_t const index : open.vertexIndices )
+    {
+        Vertex const & v = vertices[ index ];
+        float const dx = v.x - meshlet.center[0];
+        float const dy = v.y - meshlet.center[1];
+        float const dz = v.z - meshlet.center[2];
+        radius2 = std::max( radius2, dx * dx + dy * dy + dz * dz );
+    }
+    meshlet.radius = std::sqrt( radius2 );
+
+    // Normal cone around the mean of the unit triangle normals
+    std::vector< float > & normals = _normals;
+    normals.resize( open.triangles.size());
+    float axis[] = { 0.0f, 0.0f, 0.0f };
+    for( size_t t = 0; t < open.triangles.size(); t += 3 )
+    {
+        Vertex const & a = vertices[ open.vertexIndices[ open.triangles[t] ]];
+        Vertex const & b = vertices[ open.vertexIndices[ open.triangles[ t + 1 ]]];
+        Vertex const & c = vertices[ open.vertexIndices[ open.triangles[ t + 2 ]]];
+        float const e0[] = { b.x - a.x, b.y - a.y, b.z - a.z };
+        float const e1[] = { c.x - a.x, c.y - a.y, c.z - a.z };
+        float n[] = { e0[1] * e1[2] - e0[2] * e1[1],
+                      e0[2] * e1[0] - e0[0] * e1[2],
+                      e0[0] * e1[1] - e0[1] * e1[0] };
+        float const length = std::sqrt( n[0] * n[0] + n[1] * n[1] + n[2] * n[2] );
+        float const scale = length > 0.0f ? 1.0f / length : 0.0f;
+        for( int i = 0; i < 3; ++i )
+        {
+            normals[ t + i ] = n[i] * scale;
+            axis[i] += normals[ t + i ];
+        }
+    }
+    float const axisLength = std::sqrt( axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] );
+    if( axisLength > 0.0f )
+    {
+        float cutoff = 1.0f;
+        for( int i = 0; i < 3; ++i )
+        {
+            meshlet.coneAxis[i] = axis[i] / axisLength;
+        }
+        for( size_t t = 0; t < normals.size(); t += 3 )
+        {
+            // Degenerate triangles are invisible
+            if( normals[t] == 0.0f && normals[ t + 1 ] == 0.0f && normals[ t + 2 ] == 0.0f )
+            {
+                continue;
+            }
+            cutoff = std::min( cutoff, normals[t] * meshlet.coneAxis[0] +
+                                       normals[ t + 1 ] * meshlet.coneAxis[1] +
+                                       normals[ t + 2 ] * meshlet.coneAxis[2] );
+        }
+        meshlet.coneCutoff = cutoff;
+    }
+    else
+    {
+        meshlet.coneAxis[0] = 0.0f;
+        meshlet.coneAxis[1] = 0.0f;
+        meshlet.coneAxis[2] = 1.0f;
+        meshlet.coneCutoff = -1.0f;
+    }
+
+    _mesh.meshlets.push_back( meshlet );
+    _mesh.vertexIndices.insert( _mesh.vertexIndices.end(),
+                                open.vertexIndices.begin(), open.vertexIndices.end());
+    _mesh.triangles.insert( _mesh.triangles.end(), open.triangles.begin(), open.triangles.end());
+    open.vertexIndices.clear();
+    open.triangles.clear();
+}
+
+}
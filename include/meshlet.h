@@ -0,0 +1,166 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+#include "quad.h"
+#include "vertex.h"
+
+namespace dualmc
+{
+
+/// A cluster of triangles with local vertex indices
+struct Meshlet
+{
+    /// First entry in MeshletMesh::vertexIndices
+    uint32_t vertexOffset;
+
+    /// First triangle in MeshletMesh::triangles
+    uint32_t triangleOffset;
+
+    /// Number of vertices and triangles
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+
+    /// Bounding sphere
+    float center[3];
+    float radius;
+
+    /// Normal cone. All triangle normals n satisfy dot( n, coneAxis ) >=
+    /// coneCutoff, the cone is unusable for culling if the cutoff is not
+    /// positive.
+    float coneAxis[3];
+    float coneCutoff;
+};
+
+/**
+ * @brief The MeshletMesh struct
+ * Mesh split into meshlets. Each meshlet references up to maxVertices
+ * vertices of the shared vertex list and up to maxTriangles triangles with
+ * 8-bit local vertex indices. Each quad is split into two triangles, which
+ * end up in the same meshlet.
+ */
+struct MeshletMesh
+{
+    /// Largest supported number of vertices per meshlet
+    static constexpr uint32_t MAX_VERTICES = 256;
+
+    /// Empty mesh with the meshlet limits
+    explicit MeshletMesh( const uint32_t maxVertices = 64, const uint32_t maxTriangles = 124 )
+        : maxVertices( maxVertices ),
+          maxTriangles( maxTriangles )
+    {
+        /// EMPTY
+    }
+
+    /// Remove all meshlets
+    void clear()
+    {
+        meshlets.clear();
+        vertexIndices.clear();
+        triangles.clear();
+    }
+
+    /// Limits of a meshlet, at least 4 vertices and 2 triangles
+    uint32_t maxVertices;
+    uint32_t maxTriangles;
+
+    /// The meshlets
+    std::vector< Meshlet > meshlets;
+
+    /// Shared vertex indices of the meshlet vertices
+    std::vector< uint32_t > vertexIndices;
+
+    /// Local vertex indices, three per triangle
+    std::vector< uint8_t > triangles;
+};
+
+/**
+ * @brief The MeshletAssembler class
+ * Collects quads into meshlets while they are extracted. Quads are added to
+ * the open meshlet of a tile, so meshlets stay spatially coherent. A meshlet
+ * is closed when the next quad does not fit or its tile is flushed.
+ */
+class MeshletAssembler
+{
+public:
+
+    /**
+     * @brief MeshletAssembler
+     * @param mesh
+     * The output mesh, which is cleared.
+     * @param numTiles
+     * Number of tiles with an open meshlet.
+     */
+    MeshletAssembler( MeshletMesh & mesh, const int32_t numTiles );
+
+    /**
+     * @brief addQuad
+     * Add a quad to the open meshlet of a tile.
+     * @param tile
+     * @param quad
+     * @param vertices
+     */
+    void addQuad( const int32_t tile, const Quad & quad,
+                  const std::vector< Vertex > & vertices );
+
+    /**
+     * @brief flush
+     * Close the open meshlets of all tiles in tile order.
+     * @param vertices
+     */
+    void flush( const std::vector< Vertex > & vertices );
+
+private:
+
+    /// Open meshlet of a tile
+    struct OpenMeshlet
+    {
+        std::vector< uint32_t > vertexIndices;
+        std::vector< uint8_t > triangles;
+    };
+
+    /**
+     * @brief _close
+     * Append an open meshlet with its bounds and normal cone to the mesh.
+     * @param open
+     * @param vertices
+     */
+    void _close( OpenMeshlet & open, const std::vector< Vertex > & vertices );
+
+private:
+
+    /**
+     * @brief _mesh
+     * The output mesh.
+     */
+    MeshletMesh & _mesh;
+
+    /**
+     * @brief _maxVertices, _maxTriangles
+     * Clamped meshlet limits.
+     */
+    uint32_t _maxVertices;
+    uint32_t _maxTriangles;
+
+    /**
+     * @brief _tiles
+     * Open meshlet of each tile.
+     */
+    std::vector< OpenMeshlet > _tiles;
+
+    /**
+     * @brief _normals
+     * Triangle normals of the meshlet being closed, reused across meshlets.
+     */
+    std::vector< float > _normals;
+};
+
+}
+
+#endif // MESHLET_H
@@ -0,0 +1,286 @@
+#include "meshreorder.h"
+
+// STL includes
+#include <algorithm>
+
+#include "parallel.h"
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Number of quads reordered per parallel task
+const int32_t QUADS_PER_TASK = 1 << 15;
+
+/// Number of vertices remapped per parallel task
+const int32_t VERTICES_PER_TASK = 1 << 16;
+
+/**
+ * @brief reorderChunk
+ * Reorder the quads [begin, end) by fanning around cached vertices.
+ * @param quads
+ * @param begin
+ * @param end
+ * @param cacheSize
+ * @param reordered
+ * Output with the reordered quads at the same positions.
+ */
+void reorderChunk( const std::vector< Quad > & quads,
+                   const size_t begin, const size_t end,
+                   const int32_t cacheSize,
+                   std::vector< Quad > & reordered )
+{
+    int32_t const numQuads = int32_t( end - begin );
+
+    // Number the vertices of the chunk locally
+    std::vector< int32_t > chunkVertices;
+    chunkVertices.reserve( 4 * size_t( numQuads ));
+    for( size_t q = begin; q < end; ++q )
+    {
+        for( int k = 0; k < 4; ++k )
+        {
+            chunkVertices.push_back( quads[q][k] );
+        }
+    }
+    std::sort( chunkVertices.begin(), chunkVertices.end());
+    chunkVertices.erase( std::unique( chunkVertices.begin(), chunkVertices.end()), chunkVertices.end());
+    int32_t const numVertices = int32_t( chunkVertices.size());
+
+    std::vector< int32_t > localQuads( 4 * size_t( numQuads ));
+    for( int32_t q = 0; q < numQuads; ++q )
+    {
+        for( int k = 0; k < 4; ++k )
+        {
+            localQuads[ 4 * q + k ] = int32_t( std::lower_bound( chunkVertices.begin(), chunkVertices.end(),
+                                                                 quads[ begin + q ][k] ) -
+                                               chunkVertices.begin());
+        }
+    }
+
+    // Quads around each vertex
+    std::vector< int32_t > live( numVertices, 0 );
+    for( int32_t const v : localQuads )
+    {
+        ++live[v];
+    }
+    std::vector< int32_t > adjacencyOffsets( numVertices + 1, 0 );
+    for( int32_t v = 0; v < numVertices; ++v )
+    {
+        adjacencyOffsets[ v + 1 ] = adjacencyOffsets[v] + live[v];
+    }
+    std::vector< int32_t > adjacency( localQuads.size());
+    {
+        std::vector< int32_t > fill( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+        for( int32_t q = 0; q < numQuads; ++q )
+        {
+            for( int k = 0; k < 4; ++k )
+            {
+                adjacency[ fill[ localQuads[ 4 * q + k ]]++ ] = q;
+            }
+        }
+    }
+
+    // Fan around the vertex, which stays longest in the cache
+    std::vector< int32_t > cacheTime( numVertices, 0 );
+    std::vector< uint8_t > emitted( numQuads, 0 );
+    std::vector< int32_t > deadEnd;
+    std::vector< int32_t > candidates;
+    int32_t time = cacheSize + 1;
+    int32_t cursor = 0;
+    size_t output = begin;
+    int32_t fanning = 0;
+    while( fanning >= 0 )
+    {
+        candidates.clear();
+        for( int32_t a = adjacencyOffsets[ fanning ]; a < adjacencyOffsets[ fanning + 1 ]; ++a )
+        {
+            int32_t const q = adjacency[a];
+            if( emitted[q] )
+            {
+                continue;
+            }
+            emitted[q] = 1;
+            reordered[ output++ ] = quads[ begin + q ];
+            for( int k = 0; k < 4; ++k )
+            {
+                int32_t const v = localQuads[ 4 * q + k ];
+                deadEnd.push_back( v );
+                candidates.push_back( v );
+                --live[v];
+                if( time - cacheTime[v] > cacheSize )
+                {
+                    cacheTime[v] = time++;
+                }
+            }
+        }
+
+        // Prefer candidates, which are still cached after fanning around them
+        fanning = -1;
+        int32_t bestPriority = -1;
+        for( int32_t const v : candidates )
+        {
+            if( live[v] > 0 )
+            {
+                int32_t priority = 0;
+                if( time - cacheTime[v] + 2 * live[v] <= cacheSize )
+                {
+                    priority = time - cacheTime[v];
+                }
+                if( priority > bestPriority )
+                {
+                    bestPriority = priority;
+                    fanning = v;
+                }
+            }
+        }
+
+        // Otherwise continue at a recently used vertex or the next unfinished one
+        while( fanning < 0 && !deadEnd.empty())
+        {
+            int32_t const v = deadEnd.back();
+            deadEnd.pop_back();
+            if( live[v] > 0 )
+            {
+                fanning = v;
+            }
+        }
+        while( fanning < 0 && cursor < numVertices )
+        {
+            if( live[ cursor ] > 0 )
+            {
+                fanning = cursor;
+            }
+            ++cursor;
+        }
+    }
+}
+
+}
+
+/**
+ * @brief averageCacheMissRatio
+ * @param quads
+ * @param cacheSize
+ * @return
+ */
+double averageCacheMissRatio( const std::vector< Quad > & quads,
+                              const uint32_t cacheSize )
+{
+    if( quads.empty())
+    {
+        return 0.0;
+    }
+
+    int32_t maxIndex = 0;
+    for( const Quad & quad : quads )
+    {
+        maxIndex = std::max( maxIndex, std::max( std::max( quad.i0, quad.i1 ),
+                                                 std::max( quad.i2, quad.i3 )));
+    }
+
+    // A vertex is cached, if it was among the last cacheSize insertions
+    std::vector< uint64_t > inserted( size_t( maxIndex ) + 1, 0 );
+    uint64_t insertions = 0;
+    uint64_t misses = 0;
+    auto access = [ & ]( const int32_t v )
+    {
+        if( inserted[v] == 0 || inserted[v] + cacheSize <= insertions )
+        {
+            inserted[v] = ++insertions;
+            ++misses;
+        }
+    };
+    for( const Quad & quad : quads )
+    {
+        access( quad.i0 );
+        access( quad.i1 );
+        access( quad.i2 );
+        access( quad.i0 );
+        access( quad.i2 );
+        access( quad.i3 );
+    }
+    return double( misses ) / double( 2 * quads.size());
+}
+
+/**
+ * @brief reorderMesh
+ * @param vertices
+ * @param quads
+ * @param cacheSize
+ * @param numThreads
+ */
+void reorderMesh( std::vector< Vertex > & vertices,
+                  std::vector< Quad > & quads,
+                  const uint32_t cacheSize,
+                  const unsigned int numThreads )
+{
+    size_t const numQuads = quads.size();
+    int32_t const numVertices = int32_t( vertices.size());
+
+    // Reorder the quads of each chunk
+    std::vector< Quad > reordered( numQuads );
+    int32_t const numQuadTasks = int32_t(( numQuads + QUADS_PER_TASK - 1 ) / QUADS_PER_TASK );
+    parallelFor( 0, numQuadTasks, [ & ]( const int32_t task )
+    {
+        size_t const begin = size_t( task ) * QUADS_PER_TASK;
+        size_t const end = std::min( begin + QUADS_PER_TASK, numQuads );
+        reorderChunk( quads, begin, end, int32_t( std::max( cacheSize, 4u )), reordered );
+    }, numThreads );
+
+    // Number the vertices by their first use
+    std::vector< int32_t > newIndices( numVertices, -1 );
+    std::vector< int32_t > oldIndices;
+    oldIndices.reserve( numVertices );
+    for( const Quad & quad : reordered )
+    {
+        for( int k = 0; k < 4; ++k )
+        {
+            int32_t const v = quad[k];
+            if( newIndices[v] < 0 )
+            {
+                newIndices[v] = int32_t( oldIndices.size());
+                oldIndices.push_back( v );
+            }
+        }
+    }
+    for( int32_t v = 0; v < numVertices; ++v )
+    {
+        if( newIndices[v] < 0 )
+        {
+            newIndices[v] = int32_t( oldIndices.size());
+            oldIndices.push_back( v );
+        }
+    }
+
+    // Apply the new numbering
+    std::vector< Vertex > renumbered( vertices.size());
+    int32_t const numVertexTasks = ( numVertices + VERTICES_PER_TASK - 1 ) / VERTICES_PER_TASK;
+    parallelFor( 0, numVertexTasks, [ & ]( const int32_t task )
+    {
+        int32_t const begin = task * VERTICES_PER_TASK;
+        int32_t const end = std::min( begin + VERTICES_PER_TASK, numVertices );
+        for( int32_t v = begin; v < end; ++v )
+        {
+            Vertex const & vertex = vertices[ oldIndices[v] ];
+            renumbered[v].x = vertex.x;
+            renumbered[v].y = vertex.y;
+            renumbered[v].z = vertex.z;
+        }
+    }, numThreads );
+    parallelFor( 0, numQuadTasks, [ & ]( const int32_t task )
+    {
+        size_t const begin = size_t( task ) * QUADS_PER_TASK;
+        size_t const end = std::min( begin + QUADS_PER_TASK, numQuads );
+        for( size_t q = begin; q < end; ++q )
+        {
+            Quad const & quad = reordered[q];
+            quads[q] = Quad( newIndices[ quad.i0 ], newIndices[ quad.i1 ],
+                             newIndices[ quad.i2 ], newIndices[ quad.i3 ]);
+        }
+    }, numThreads );
+    vertices.swap( renumbered );
+}
+
+}
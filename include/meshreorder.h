@@ -0,0 +1,51 @@
+#ifndef MESHREORDER_H
+#define MESHREORDER_H
+
+// C includes
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+#include "quad.h"
+#include "vertex.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief averageCacheMissRatio
+ * Simulate a FIFO post-transform vertex cache on the quads, each split into
+ * the triangles ( i0, i1, i2 ) and ( i0, i2, i3 ).
+ * @param quads
+ * @param cacheSize
+ * Number of vertices held by the cache.
+ * @return Average number of cache misses per triangle, between 0.5 for
+ * ideal meshes and 3.
+ */
+double averageCacheMissRatio( const std::vector< Quad > & quads,
+                              const uint32_t cacheSize = 16 );
+
+/**
+ * @brief reorderMesh
+ * Reorder the quads for vertex cache reuse and renumber the vertices in order
+ * of their first use. The quads are split into consecutive chunks, which are
+ * reordered in parallel by fanning around vertices likely to be in the cache
+ * (Sander et al., Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw, 2007). The extraction emits the quads in sweep order, so the
+ * chunks are spatially coherent. Unreferenced vertices are moved to the end.
+ * @param vertices
+ * @param quads
+ * @param cacheSize
+ * Number of vertices of the targeted cache.
+ * @param numThreads
+ * Number of threads, zero uses all hardware threads.
+ */
+void reorderMesh( std::vector< Vertex > & vertices,
+                  std::vector< Quad > & quads,
+                  const uint32_t cacheSize = 16,
+                  const unsigned int numThreads = 0 );
+
+}
+
+#endif // MESHREORDER_H
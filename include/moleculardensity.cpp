@@ -0,0 +1,459 @@
+#include "moleculardensity.h"
+
+// C includes
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// STL includes
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "parallel.h"
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Gaussians are cut off at this multiple of the atom radius. Beyond this
+/// distance exp( -ln( 2 ) * d^2 / r^2 ) is less than 1/512 and vanishes in the
+/// 8-bit quantization.
+float constexpr CUTOFF_SCALE = 3.0f;
+
+/**
+ * @brief expInPlace
+ * Replace each value by its exponential. The values have to be non-positive.
+ * The exponential is computed as 2^t with t = x * log2( e ), where the integer
+ * part of t is written directly into the float exponent bits and the
+ * fractional part is approximated with a polynomial. The loop has no branches
+ * and no calls, so the compiler can vectorize it. The relative error is below
+ * 3e-6, which is sufficient for 8-bit density volumes.
+ * @param values
+ * @param count
+ */
+void expInPlace( float * values, const int32_t count )
+{
+    for( int32_t i = 0; i < count; ++i )
+    {
+        // Convert to base 2 and clamp to the range of normalized floats
+        float t = values[ i ] * 1.44269504f;
+        t = t < -126.0f ? -126.0f : t;
+
+        // Split into the biased integer exponent and a fraction in [-0.5,0.5]
+        float const biased = t + 127.0f;
+        int32_t const exponent = int32_t( biased + 0.5f );
+        float const f = biased - float( exponent );
+
+        // 2^f with a Taylor polynomial of degree 5
+        float const p = 1.0f + f * ( 0.693147181f + f * ( 0.240226507f +
+                        f * ( 0.0555041087f + f * ( 0.00961812911f +
+                        f * 0.00133335581f ))));
+
+        // 2^exponent by shifting it into the exponent bits
+        int32_t const bits = exponent << 23;
+        float scale;
+        std::memcpy( &scale, &bits, sizeof( scale ));
+
+        values[ i ] = p * scale;
+    }
+}
+
+/**
+ * @brief trim
+ * @param s
+ * @return Copy of the string without surrounding white space.
+ */
+std::string trim( const std::string & s )
+{
+    size_t const first = s.find_first_not_of( " \t\r\n" );
+    if( first == std::string::npos )
+    {
+        return std::string();
+    }
+    size_t const last = s.find_last_not_of( " \t\r\n" );
+    return s.substr( first, last - first + 1 );
+}
+
+/**
+ * @brief hasExtension
+ * Case insensitive check of the file name extension.
+ * @param fileName
+ * @param extension
+ * @return
+ */
+bool hasExtension( const std::string & fileName, const char * extension )
+{
+    size_t const length = std::strlen( extension );
+    if( fileName.size() < length )
+    {
+        return false;
+    }
+    for( size_t i = 0; i < length; ++i )
+    {
+        if( std::tolower( fileName[ fileName.size() - length + i ]) !=
+            std::tolower( extension[ i ]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+/**
+ * @brief MolecularDensity::loadFile
+ * @param fileName
+ * @return
+ */
+bool MolecularDensity::loadFile( const std::string & fileName )
+{
+    if( hasExtension( fileName, ".pdb" ) || hasExtension( fileName, ".ent" ))
+    {
+        return _loadPDB( fileName );
+    }
+    return _loadXYZ( fileName );
+}
+
+/**
+ * @brief MolecularDensity::loadPDB
+ * @param fileName
+ * @return
+ */
+bool MolecularDensity::_loadPDB( const std::string & fileName )
+{
+    std::ifstream file( fileName );
+    if( !file )
+    {
+        return false;
+    }
+
+    std::string line;
+    while( std::getline( file, line ))
+    {
+        // Only atom records carry coordinates
+        if( line.compare( 0, 6, "ATOM  " ) != 0 &&
+            line.compare( 0, 6, "HETATM" ) != 0 )
+        {
+            continue;
+        }
+        if( line.size() < 54 )
+        {
+            return false;
+        }
+
+        // Fixed column coordinates
+        float const x = float( std::atof( line.substr( 30, 8 ).c_str()));
+        float const y = float( std::atof( line.substr( 38, 8 ).c_str()));
+        float const z = float( std::atof( line.substr( 46, 8 ).c_str()));
+
+        // Prefer the element column and fall back to the atom name
+        std::string element;
+        if( line.size() >= 78 )
+        {
+            element = trim( line.substr( 76, 2 ));
+        }
+        if( element.empty())
+        {
+            std::string const name = trim( line.substr( 12, 4 ));
+            for( char const c : name )
+            {
+                if( std::isalpha( c ))
+                {
+                    element.assign( 1, c );
+                    break;
+                }
+            }
+        }
+
+        addAtom( element, x, y, z );
+    }
+    return true;
+}
+
+/**
+ * @brief MolecularDensity::loadXYZ
+ * @param fileName
+ * @return
+ */
+bool MolecularDensity::_loadXYZ( const std::string & fileName )
+{
+    std::ifstream file( fileName );
+    if( !file )
+    {
+        return false;
+    }
+
+    // Atom count and comment line
+    std::string line;
+    size_t numAtoms = 0;
+    if( !std::getline( file, line ))
+    {
+        return false;
+    }
+    numAtoms = size_t( std::atol( line.c_str()));
+    std::getline( file, line );
+
+    _atoms.reserve( _atoms.size() + numAtoms );
+    for( size_t i = 0; i < numAtoms; ++i )
+    {
+        if( !std::getline( file, line ))
+        {
+            return false;
+        }
+        std::istringstream record( line );
+        std::string element;
+        float x, y, z;
+        if( !( record >> element >> x >> y >> z ))
+        {
+            return false;
+        }
+        addAtom( element, x, y, z );
+    }
+    return true;
+}
+
+/**
+ * @brief MolecularDensity::addAtom
+ * @param element
+ * @param x
+ * @param y
+ * @param z
+ */
+void MolecularDensity::addAtom( const std::string & element,
+                                const float x, const float y, const float z )
+{
+    Atom atom;
+    atom.x = x;
+    atom.y = y;
+    atom.z = z;
+    atom.radius = elementRadius( element );
+    _atoms.push_back( atom );
+}
+
+/**
+ * @brief MolecularDensity::atoms
+ * @return
+ */
+const std::vector< MolecularDensity::Atom > & MolecularDensity::atoms() const
+{
+    return _atoms;
+}
+
+/**
+ * @brief MolecularDensity::elementRadius
+ * @param element
+ * @return
+ */
+float MolecularDensity::elementRadius( const std::string & element )
+{
+    // Bondi van der Waals radii
+    static const struct
+    {
+        const char * symbol;
+        float radius;
+    } radii[] =
+    {
+        { "H", 1.20f }, { "C", 1.70f }, { "N", 1.55f }, { "O", 1.52f },
+        { "F", 1.47f }, { "P", 1.80f }, { "S", 1.80f }, { "CL", 1.75f },
+        { "BR", 1.85f }, { "I", 1.98f }, { "SE", 1.90f }, { "NA", 2.27f },
+        { "MG", 1.73f }, { "K", 2.75f }, { "ZN", 1.39f }, { "FE", 1.94f }
+    };
+
+    std::string symbol = element;
+    for( auto & c : symbol )
+    {
+        c = char( std::toupper( c ));
+    }
+
+    for( auto const & entry : radii )
+    {
+        if( symbol == entry.symbol )
+        {
+            return entry.radius;
+        }
+    }
+
+    // Unknown elements are treated like carbon
+    return 1.70f;
+}
+
+/**
+ * @brief MolecularDensity::generate
+ * @param x
+ * @param y
+ * @param z
+ * @param volume
+ * @param numThreads
+ */
+void MolecularDensity::generate( const int32_t x, const int32_t y, const int32_t z,
+                                 std::vector< uint8_t > & volume,
+                                 const unsigned int numThreads ) const
+{
+    int32_t const dims[] = { x, y, z };
+    volume.assign( size_t( x ) * size_t( y ) * size_t( z ), 0 );
+    if( _atoms.empty() || x < 2 || y < 2 || z < 2 )
+    {
+        return;
+    }
+
+    // Bounding box of the molecule including the Gaussian cutoff
+    float boxMin[] = { _atoms[ 0 ].x, _atoms[ 0 ].y, _atoms[ 0 ].z };
+    float boxMax[] = { boxMin[ 0 ], boxMin[ 1 ], boxMin[ 2 ] };
+    for( auto const & atom : _atoms )
+    {
+        float const center[] = { atom.x, atom.y, atom.z };
+        float const cutoff = CUTOFF_SCALE * atom.radius;
+        for( int a = 0; a < 3; ++a )
+        {
+            boxMin[ a ] = std::min( boxMin[ a ], center[ a ] - cutoff );
+            boxMax[ a ] = std::max( boxMax[ a ], center[ a ] + cutoff );
+        }
+    }
+
+    // Uniform voxel spacing that fits the box into the volume and the
+    // position of the first voxel, which centers the box
+    float spacing = 0.0f;
+    for( int a = 0; a < 3; ++a )
+    {
+        spacing = std::max( spacing, ( boxMax[ a ] - boxMin[ a ]) / float( dims[ a ] - 1 ));
+    }
+    float origin[ 3 ];
+    for( int a = 0; a < 3; ++a )
+    {
+        origin[ a ] = 0.5f * ( boxMin[ a ] + boxMax[ a ]) -
+                      0.5f * spacing * float( dims[ a ] - 1 );
+    }
+
+    // Atoms in voxel coordinates with their falloff and squared cutoff
+    struct GridAtom
+    {
+        float x, y, z;
+        float falloff;
+        float cutoffSquared;
+    };
+
+    float cellSize = 0.0f;
+    std::vector< GridAtom > gridAtoms( _atoms.size());
+    for( size_t i = 0; i < _atoms.size(); ++i )
+    {
+        float const radius = _atoms[ i ].radius / spacing;
+        GridAtom & g = gridAtoms[ i ];
+        g.x = ( _atoms[ i ].x - origin[ 0 ]) / spacing;
+        g.y = ( _atoms[ i ].y - origin[ 1 ]) / spacing;
+        g.z = ( _atoms[ i ].z - origin[ 2 ]) / spacing;
+        g.falloff = -0.693147181f / ( radius * radius );
+        g.cutoffSquared = CUTOFF_SCALE * CUTOFF_SCALE * radius * radius;
+        cellSize = std::max( cellSize, CUTOFF_SCALE * radius );
+    }
+
+    // Bin the atoms into a cell list with the largest cutoff as cell size,
+    // so all atoms influencing a voxel lie in its 3x3x3 cell neighborhood
+    int32_t numCells[ 3 ];
+    for( int a = 0; a < 3; ++a )
+    {
+        numCells[ a ] = std::max( 1, int32_t( std::ceil( float( dims[ a ]) / cellSize )));
+    }
+    auto cellCoord = [ & ]( const float v, const int a )
+    {
+        int32_t const c = int32_t( std::floor( v / cellSize ));
+        return std::min( std::max( c, 0 ), numCells[ a ] - 1 );
+    };
+    size_t const totalCells = size_t( numCells[ 0 ]) * numCells[ 1 ] * numCells[ 2 ];
+
+    std::vector< uint32_t > atomCell( gridAtoms.size());
+    std::vector< uint32_t > cellStart( totalCells + 1, 0 );
+    for( size_t i = 0; i < gridAtoms.size(); ++i )
+    {
+        atomCell[ i ] = uint32_t( cellCoord( gridAtoms[ i ].x, 0 ) + numCells[ 0 ] *
+                        ( cellCoord( gridAtoms[ i ].y, 1 ) + numCells[ 1 ] *
+                          cellCoord( gridAtoms[ i ].z, 2 )));
+        ++cellStart[ atomCell[ i ] + 1 ];
+    }
+    for( size_t c = 0; c < totalCells; ++c )
+    {
+        cellStart[ c + 1 ] += cellStart[ c ];
+    }
+    std::vector< GridAtom > cellAtoms( gridAtoms.size());
+    {
+        std::vector< uint32_t > fill( cellStart.begin(), cellStart.end() - 1 );
+        for( size_t i = 0; i < gridAtoms.size(); ++i )
+        {
+            cellAtoms[ fill[ atomCell[ i ]]++ ] = gridAtoms[ i ];
+        }
+    }
+
+    // Evaluate the z-slices in parallel. Each voxel row accumulates the
+    // Gaussians of the atoms in the neighboring cell rows, where every atom
+    // only touches the x-range within its cutoff.
+    uint8_t * const data = volume.data();
+    parallelFor( 0, z, [ & ]( const int32_t vz )
+    {
+        std::vector< float > density( x );
+        std::vector< float > exponents( x );
+
+        int32_t const cz = cellCoord( float( vz ), 2 );
+        for( int32_t vy = 0; vy < y; ++vy )
+        {
+            std::fill( density.begin(), density.end(), 0.0f );
+            int32_t const cy = cellCoord( float( vy ), 1 );
+
+            for( int32_t nz = std::max( cz - 1, 0 ); nz <= std::min( cz + 1, numCells[ 2 ] - 1 ); ++nz )
+            {
+                for( int32_t ny = std::max( cy - 1, 0 ); ny <= std::min( cy + 1, numCells[ 1 ] - 1 ); ++ny )
+                {
+                    size_t const rowBegin = size_t( numCells[ 0 ]) * ( ny + size_t( numCells[ 1 ]) * nz );
+                    uint32_t const first = cellStart[ rowBegin ];
+                    uint32_t const last = cellStart[ rowBegin + numCells[ 0 ]];
+
+                    for( uint32_t a = first; a < last; ++a )
+                    {
+                        GridAtom const & atom = cellAtoms[ a ];
+                        float const dy = float( vy ) - atom.y;
+                        float const dz = float( vz ) - atom.z;
+                        float const distanceYZ = dy * dy + dz * dz;
+                        if( distanceYZ >= atom.cutoffSquared )
+                        {
+                            continue;
+                        }
+
+                        // Voxel range of the row inside the cutoff sphere
+                        float const halfWidth = std::sqrt( atom.cutoffSquared - distanceYZ );
+                        int32_t const x0 = std::max( 0, int32_t( std::ceil( atom.x - halfWidth )));
+                        int32_t const x1 = std::min( x - 1, int32_t( std::floor( atom.x + halfWidth )));
+                        int32_t const count = x1 - x0 + 1;
+                        if( count <= 0 )
+                        {
+                            continue;
+                        }
+
+                        for( int32_t i = 0; i < count; ++i )
+                        {
+                            float const dx = float( x0 + i ) - atom.x;
+                            exponents[ i ] = atom.falloff * ( dx * dx + distanceYZ );
+                        }
+                        expInPlace( exponents.data(), count );
+                        for( int32_t i = 0; i < count; ++i )
+                        {
+                            density[ x0 + i ] += exponents[ i ];
+                        }
+                    }
+                }
+            }
+
+            // Quantize the clamped density
+            uint8_t * const row = data + size_t( x ) * ( vy + size_t( y ) * vz );
+            for( int32_t vx = 0; vx < x; ++vx )
+            {
+                float const rho = std::min( density[ vx ], 1.0f );
+                row[ vx ] = uint8_t( rho * 255.0f + 0.5f );
+            }
+        }
+    }, numThreads );
+}
+
+}
@@ -0,0 +1,113 @@
+#ifndef MOLECULARDENSITY_H
+#define MOLECULARDENSITY_H
+
+// C includes
+#include <cstdint>
+
+// STL includes
+#include <string>
+#include <vector>
+
+namespace dualmc
+{
+
+/**
+ * @brief The MolecularDensity class
+ * Generates an electron density like volume for a molecule, where each atom
+ * contributes a radial Gaussian. The Gaussian of an atom drops to one half at
+ * its van der Waals radius, so an iso value of 0.5 approximates the van der
+ * Waals surface.
+ * Gaussians are cut off at three times the atom radius, where they fall below
+ * the 8-bit quantization. Atoms are binned into a uniform cell list with the
+ * cutoff as cell size. For each voxel row only the atoms of the neighboring
+ * cells are evaluated, using a vectorizable exponential. The z-slices of the
+ * volume are generated in parallel.
+ */
+class MolecularDensity
+{
+public:
+
+    /// Atom with center coordinates and van der Waals radius in Angstrom
+    struct Atom
+    {
+        float x, y, z;
+        float radius;
+    };
+
+    /**
+     * @brief loadFile
+     * Load atoms from a PDB file (ATOM and HETATM records) or an XYZ file.
+     * The format is determined from the file name extension.
+     * @param fileName
+     * @return False, if the file could not be read.
+     */
+    bool loadFile( const std::string & fileName );
+
+    /**
+     * @brief addAtom
+     * Add an atom with the van der Waals radius of the given element symbol.
+     * @param element
+     * @param x
+     * @param y
+     * @param z
+     */
+    void addAtom( const std::string & element,
+                  const float x, const float y, const float z );
+
+    /**
+     * @brief atoms
+     * @return The atoms of the molecule.
+     */
+    const std::vector< Atom > & atoms() const;
+
+    /**
+     * @brief generate
+     * Sample the density into an 8-bit volume with the given dimensions.
+     * The bounding box of the molecule including the Gaussian cutoff is
+     * uniformly scaled and centered in the volume.
+     * @param x
+     * @param y
+     * @param z
+     * @param volume
+     * @param numThreads
+     * Zero uses all hardware threads.
+     */
+    void generate( const int32_t x, const int32_t y, const int32_t z,
+                   std::vector< uint8_t > & volume,
+                   const unsigned int numThreads = 0 ) const;
+
+    /**
+     * @brief elementRadius
+     * @param element
+     * @return The van der Waals radius of an element in Angstrom.
+     */
+    static float elementRadius( const std::string & element );
+
+private:
+
+    /**
+     * @brief _loadPDB
+     * @param fileName
+     * @return
+     */
+    bool _loadPDB( const std::string & fileName );
+
+    /**
+     * @brief _loadXYZ
+     * @param fileName
+     * @return
+     */
+    bool _loadXYZ( const std::string & fileName );
+
+private:
+
+    /**
+     * @brief _atoms
+     * The atoms of the molecule.
+     */
+    std::vector< Atom > _atoms;
+};
+
+}
+
+#endif // MOLECULARDENSITY_H
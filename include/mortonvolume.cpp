@@ -0,0 +1,141 @@
+#include "mortonvolume.h"
+
+#include "parallel.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief MortonVolume::MortonVolume
+ */
+MortonVolume::MortonVolume()
+{
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        _volumeDimensions[axis] = 0;
+        _bits[axis] = 0;
+    }
+}
+
+/**
+ * @brief MortonVolume::fromLinear
+ * @param volumeGrid
+ * @param x
+ * @param y
+ * @param z
+ * @param numThreads
+ */
+void MortonVolume::fromLinear( const uint8_t * volumeGrid,
+                               const int32_t x, const int32_t y, const int32_t z,
+                               const unsigned int numThreads )
+{
+    _volumeDimensions[0] = x;
+    _volumeDimensions[1] = y;
+    _volumeDimensions[2] = z;
+
+    // Bits needed for the coordinates of each axis
+    int maxBits = 0;
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        _bits[axis] = 0;
+        while(( int64_t( 1 ) << _bits[axis] ) < _volumeDimensions[axis] )
+        {
+            ++_bits[axis];
+        }
+        if( _bits[axis] > maxBits )
+        {
+            maxBits = _bits[axis];
+        }
+        _offsets[axis].assign( size_t( _volumeDimensions[axis] ), 0 );
+    }
+
+    // Assign address bits from low to high, interleaving x, y and z while
+    // the axes have coordinate bits left
+    int addressBit = 0;
+    for( int bit = 0; bit < maxBits; ++bit )
+    {
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            if( bit >= _bits[axis] )
+            {
+                continue;
+            }
+
+            for( int32_t c = 0; c < _volumeDimensions[axis]; ++c )
+            {
+                if(( c >> bit ) & 1 )
+                {
+                    _offsets[axis][c] |= size_t( 1 ) << addressBit;
+                }
+            }
+            ++addressBit;
+        }
+    }
+
+    // Scatter the voxels, padding voxels are never read
+    _data.assign( size_t( 1 ) << addressBit, 0 );
+    size_t const sliceSize = size_t( x ) * size_t( y );
+    parallelFor( 0, z, [ & ]( const int32_t vz )
+    {
+        size_t const offsetZ = _offsets[2][vz];
+        for( int32_t vy = 0; vy < y; ++vy )
+        {
+            size_t const offsetYZ = _offsets[1][vy] | offsetZ;
+            const uint8_t * const row = volumeGrid + size_t( vy ) * x + sliceSize * vz;
+            for( int32_t vx = 0; vx < x; ++vx )
+            {
+                _data[ _offsets[0][vx] | offsetYZ ] = row[vx];
+            }
+        }
+    }, numThreads );
+}
+
+/**
+ * @brief MortonVolume::dimension
+ * @param axis
+ * @return
+ */
+int32_t MortonVolume::dimension( const int axis ) const
+{
+    return _volumeDimensions[ axis ];
+}
+
+/**
+ * @brief MortonVolume::bits
+ * @param axis
+ * @return
+ */
+int MortonVolume::bits( const int axis ) const
+{
+    return _bits[ axis ];
+}
+
+/**
+ * @brief MortonVolume::offsets
+ * @param axis
+ * @return
+ */
+const size_t * MortonVolume::offsets( const int axis ) const
+{
+    return _offsets[ axis ].data();
+}
+
+/**
+ * @brief MortonVolume::data
+ * @return
+ */
+const uint8_t * MortonVolume::data() const
+{
+    return _data.data();
+}
+
+/**
+ * @brief MortonVolume::memorySize
+ * @return
+ */
+size_t MortonVolume::memorySize() const
+{
+    return _data.size();
+}
+
+}
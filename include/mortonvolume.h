@@ -0,0 +1,159 @@
+#ifndef MORTONVOLUME_H
+#define MORTONVOLUME_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+namespace dualmc
+{
+
+/**
+ * @brief The MortonVolume class
+ * Volume stored along a Z-order (Morton) curve. The address of a voxel
+ * interleaves the bits of its coordinates, so voxels close in all three
+ * directions are close in memory on every scale, from cache lines up to
+ * pages.
+ * Each axis is padded to the next power of two. Once the coordinate bits of
+ * a shorter axis are exhausted, the remaining bits of the longer axes are
+ * interleaved among themselves, so flat volumes are not padded to a cube.
+ * The address is the bitwise or of three per-axis offset tables.
+ */
+class MortonVolume
+{
+public:
+
+    /**
+     * @brief MortonVolume
+     * Empty volume.
+     */
+    MortonVolume();
+
+    /**
+     * @brief fromLinear
+     * Convert a volume in linear x-fastest layout into Morton order.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param numThreads
+     * Number of threads converting slices in parallel. Zero uses all
+     * hardware threads.
+     */
+    void fromLinear( const uint8_t * volumeGrid,
+                     const int32_t x, const int32_t y, const int32_t z,
+                     const unsigned int numThreads = 0 );
+
+    /**
+     * @brief dimension
+     * @param axis
+     * @return Volume dimension along the given axis.
+     */
+    int32_t dimension( const int axis ) const;
+
+    /**
+     * @brief bits
+     * @param axis
+     * @return Number of coordinate bits of the given axis.
+     */
+    int bits( const int axis ) const;
+
+    /**
+     * @brief offsets
+     * @param axis
+     * @return Address offset of each coordinate along the given axis.
+     */
+    const size_t * offsets( const int axis ) const;
+
+    /**
+     * @brief data
+     * @return The voxels in Morton order.
+     */
+    const uint8_t * data() const;
+
+    /**
+     * @brief memorySize
+     * @return Size of the voxel storage in bytes including padding.
+     */
+    size_t memorySize() const;
+
+private:
+
+    /**
+     * @brief _volumeDimensions
+     * Dimensions of the stored volume.
+     */
+    int32_t _volumeDimensions[3];
+
+    /**
+     * @brief _bits
+     * Number of coordinate bits of each axis.
+     */
+    int _bits[3];
+
+    /**
+     * @brief _offsets
+     * Per-axis address offsets with the interleaved coordinate bits.
+     */
+    std::vector< size_t > _offsets[3];
+
+    /**
+     * @brief _data
+     * Voxels in Morton order.
+     */
+    std::vector< uint8_t > _data;
+};
+
+/**
+ * @brief The MortonVolumeAccessor class
+ * Volume accessor for a volume in Morton order.
+ */
+class MortonVolumeAccessor
+{
+public:
+
+    /// Initializing constructor
+    explicit MortonVolumeAccessor( const MortonVolume & volume )
+        : _volume( volume ),
+          _data( volume.data() ),
+          _offsetsX( volume.offsets( 0 )),
+          _offsetsY( volume.offsets( 1 )),
+          _offsetsZ( volume.offsets( 2 ))
+    {
+        /// EMPTY
+    }
+
+    /// The Morton volume
+    const MortonVolume & volume() const
+    {
+        return _volume;
+    }
+
+    /// The voxel value at ( x, y, z )
+    uint8_t operator()( const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        return _data[ _offsetsX[x] | _offsetsY[y] | _offsetsZ[z] ];
+    }
+
+    /// All voxels are always available
+    void prepareLayer( const int32_t )
+    {
+        /// EMPTY
+    }
+
+private:
+
+    // Morton volume, its voxels and offset tables
+    const MortonVolume & _volume;
+    const uint8_t * _data;
+    const size_t * _offsetsX;
+    const size_t * _offsetsY;
+    const size_t * _offsetsZ;
+};
+
+}
+
+#endif // MORTONVOLUME_H
@@ -0,0 +1,242 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+// C includes
+#include <cstdint>
+
+// STL includes
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dualmc
+{
+
+/**
+ * @brief hardwareThreads
+ * Number of concurrent threads supported by the hardware, at least one.
+ * @return
+ */
+inline unsigned int hardwareThreads()
+{
+    unsigned int const threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+/**
+ * @brief parallelFor
+ * Calls function( i ) for each i in [begin, end). The iterations are
+ * distributed dynamically over numThreads threads, where the calling thread
+ * is one of them. A thread count of zero uses all hardware threads.
+ * @param begin
+ * @param end
+ * @param function
+ * @param numThreads
+ */
+template< class Function >
+void parallelFor( const int32_t begin, const int32_t end,
+                  Function const & function,
+                  unsigned int numThreads = 0 )
+{
+    if( numThreads == 0 )
+    {
+        numThreads = hardwareThreads();
+    }
+
+    // Do not spawn more threads than there are iterations
+    if( end - begin < int32_t( numThreads ))
+    {
+        numThreads = end > begin ? unsigned( end - begin ) : 1;
+    }
+
+    // Run serially without any thread overhead
+    if( numThreads == 1 )
+    {
+        for( int32_t i = begin; i < end; ++i )
+        {
+            function( i );
+        }
+        return;
+    }
+
+    // Each thread fetches the next iteration until all are processed
+    std::atomic< int32_t > next( begin );
+    auto worker = [ & ]()
+    {
+        for( int32_t i = next++; i < end; i = next++ )
+        {
+            function( i );
+        }
+    };
+
+    std::vector< std::thread > threads;
+    threads.reserve( numThreads - 1 );
+    for( unsigned int t = 1; t < numThreads; ++t )
+    {
+        threads.emplace_back( worker );
+    }
+    worker();
+
+    for( auto & thread : threads )
+    {
+        thread.join();
+    }
+}
+
+/**
+ * @brief The ThreadPool class
+ * Persistent worker threads for repeated parallel loops. Unlike parallelFor,
+ * which starts and joins its threads for every loop, the workers of the pool
+ * wait for the next loop, so frequent small loops avoid the thread start-up.
+ * The calling thread takes part in each loop. Loops of one pool must not be
+ * run concurrently or nested.
+ */
+class ThreadPool
+{
+public:
+
+    /**
+     * @brief ThreadPool
+     * @param numThreads
+     * Number of threads including the calling thread, zero uses all
+     * hardware threads.
+     */
+    explicit ThreadPool( unsigned int numThreads = 0 )
+        : _task( nullptr ),
+          _next( 0 ),
+          _end( 0 ),
+          _generation( 0 ),
+          _activeWorkers( 0 ),
+          _stop( false )
+    {
+        if( numThreads == 0 )
+        {
+            numThreads = hardwareThreads();
+        }
+        _workers.reserve( numThreads - 1 );
+        for( unsigned int t = 1; t < numThreads; ++t )
+        {
+            _workers.emplace_back( [ this ]() { _work(); } );
+        }
+    }
+
+    /// Stop and join the workers
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard< std::mutex > lock( _mutex );
+            _stop = true;
+        }
+        _wake.notify_all();
+        for( auto & worker : _workers )
+        {
+            worker.join();
+        }
+    }
+
+    ThreadPool( const ThreadPool & ) = delete;
+    ThreadPool & operator=( const ThreadPool & ) = delete;
+
+    /// Number of threads including the calling thread
+    unsigned int numThreads() const
+    {
+        return unsigned( _workers.size()) + 1;
+    }
+
+    /**
+     * @brief parallelFor
+     * Calls function( i ) for each i in [begin, end), distributed dynamically
+     * over the threads of the pool.
+     * @param begin
+     * @param end
+     * @param function
+     */
+    template< class Function >
+    void parallelFor( const int32_t begin, const int32_t end, Function const & function )
+    {
+        // Run serially without waking the workers
+        if( _workers.empty() || end - begin < 2 )
+        {
+            for( int32_t i = begin; i < end; ++i )
+            {
+                function( i );
+            }
+            return;
+        }
+
+        std::function< void( int32_t ) > const task( std::cref( function ));
+        {
+            std::lock_guard< std::mutex > lock( _mutex );
+            _task = &task;
+            _next = begin;
+            _end = end;
+            _activeWorkers = unsigned( _workers.size());
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        for( int32_t i = _next++; i < end; i = _next++ )
+        {
+            function( i );
+        }
+
+        // The task has to stay alive until all workers are done with it
+        std::unique_lock< std::mutex > lock( _mutex );
+        _done.wait( lock, [ this ]() { return _activeWorkers == 0; } );
+        _task = nullptr;
+    }
+
+private:
+
+    /// Worker loop, which runs each loop of the pool once
+    void _work()
+    {
+        uint64_t generation = 0;
+        for( ;; )
+        {
+            const std::function< void( int32_t ) > * task;
+            int32_t end;
+            {
+                std::unique_lock< std::mutex > lock( _mutex );
+                _wake.wait( lock, [ & ]() { return _stop || _generation != generation; } );
+                if( _stop )
+                {
+                    return;
+                }
+                generation = _generation;
+                task = _task;
+                end = _end;
+            }
+
+            for( int32_t i = _next++; i < end; i = _next++ )
+            {
+                ( *task )( i );
+            }
+
+            std::lock_guard< std::mutex > lock( _mutex );
+            if( --_activeWorkers == 0 )
+            {
+                _done.notify_one();
+            }
+        }
+    }
+
+    // Worker threads and the current loop
+    std::vector< std::thread > _workers;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    const std::function< void( int32_t ) > * _task;
+    std::atomic< int32_t > _next;
+    int32_t _end;
+    uint64_t _generation;
+    unsigned int _activeWorkers;
+    bool _stop;
+};
+
+}
+
+#endif // PARALLEL_H
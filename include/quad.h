@@ -26,6 +26,30 @@ struct Quad
         /// EMPTY
     }
 
+    /// The k-th index of the quad
+    int32_t operator[]( int const k ) const
+    {
+        switch( k )
+        {
+        case 0: return i0;
+        case 1: return i1;
+        case 2: return i2;
+        default: return i3;
+        }
+    }
+
+    /// The k-th index of the quad
+    int32_t & operator[]( int const k )
+    {
+        switch( k )
+        {
+        case 0: return i0;
+        case 1: return i1;
+        case 2: return i2;
+        default: return i3;
+        }
+    }
+
     // quad indices
     int32_t i0,i1,i2,i3;
 
@@ -0,0 +1,849 @@
+#include "quaddecimator.h"
+
+// C includes
+#include <cmath>
+
+// STL includes
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+#include "parallel.h"
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Maximum number of simplification rounds
+const int MAX_ROUNDS = 8;
+
+/// Minimum edge length of the blocks in mesh units
+const float MIN_BLOCK_SIZE = 16.0f;
+
+/// Edge length of the blocks in average quad edge lengths
+const float BLOCK_SIZE_IN_QUADS = 64.0f;
+
+/// Number of vertices processed per parallel task
+const int32_t VERTICES_PER_TASK = 4096;
+
+/// Collapsed quads are marked by a negative first index
+inline bool isCollapsed( const Quad & quad )
+{
+    return quad.i0 < 0;
+}
+
+inline bool isDegenerate( const Quad & quad )
+{
+    return quad.i0 == quad.i1 || quad.i0 == quad.i2 || quad.i0 == quad.i3 ||
+            quad.i1 == quad.i2 || quad.i1 == quad.i3 || quad.i2 == quad.i3;
+}
+
+struct Vector
+{
+    double x, y, z;
+};
+
+inline Vector operator-( const Vector & a, const Vector & b )
+{
+    return { a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+inline Vector cross( const Vector & a, const Vector & b )
+{
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+inline double dot( const Vector & a, const Vector & b )
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vector toVector( const Vertex & v )
+{
+    return { v.x, v.y, v.z };
+}
+
+/// Normal of a quad as the cross product of its diagonals
+inline Vector quadNormal( const Vector p[4] )
+{
+    return cross( p[2] - p[0], p[3] - p[1]);
+}
+
+/// A pending diagonal collapse
+struct Collapse
+{
+    double cost;
+    int32_t quad;
+    int diagonal;
+    uint32_t stamp;
+    Vertex position;
+
+    /// Orders the priority queue by increasing cost
+    bool operator<( const Collapse & other ) const
+    {
+        if( cost != other.cost )
+        {
+            return cost > other.cost;
+        }
+        return quad > other.quad;
+    }
+};
+
+}
+
+/**
+ * @brief QuadDecimator::decimate
+ * @param vertices
+ * @param quads
+ * @param targetQuads
+ * @param maxError
+ * @param numThreads
+ */
+void QuadDecimator::decimate( std::vector< Vertex > & vertices,
+                              std::vector< Quad > & quads,
+                              const size_t targetQuads,
+                              const float maxError,
+                              const unsigned int numThreads )
+{
+    _maxCost = maxError > 0.0f ? double( maxError ) * double( maxError ) :
+                                 std::numeric_limits< double >::infinity();
+    _quadStamps.assign( quads.size(), 0 );
+
+    _linkQuads( vertices.size(), quads );
+    _buildQuadrics( vertices, quads, numThreads );
+
+    size_t numQuads = quads.size();
+    int idleRounds = 0;
+    for( int round = 0; round < MAX_ROUNDS && idleRounds < 2; ++round )
+    {
+        size_t removeQuads = 0;
+        if( targetQuads > 0 )
+        {
+            if( numQuads <= targetQuads )
+            {
+                break;
+            }
+            removeQuads = numQuads - targetQuads;
+        }
+
+        if( round > 0 )
+        {
+            _linkQuads( vertices.size(), quads );
+        }
+        size_t const removed = _simplifyRound( vertices, quads, ( round & 1 ) != 0,
+                                               removeQuads, numThreads );
+        numQuads -= removed;
+        idleRounds = removed == 0 ? idleRounds + 1 : 0;
+    }
+
+    _compact( vertices, quads );
+}
+
+/**
+ * @brief QuadDecimator::_linkQuads
+ * @param numVertices
+ * @param quads
+ */
+void QuadDecimator::_linkQuads( const size_t numVertices, const std::vector< Quad > & quads )
+{
+    _vertexQuads.resize( numVertices );
+    for( auto & vertexQuads : _vertexQuads )
+    {
+        vertexQuads.clear();
+    }
+
+    for( size_t q = 0; q < quads.size(); ++q )
+    {
+        if( isCollapsed( quads[q] ))
+        {
+            continue;
+        }
+        const Quad & quad = quads[q];
+        for( int k = 0; k < 4; ++k )
+        {
+            // Degenerate quads are linked once per distinct vertex
+            int j = 0;
+            while( j < k && quad[j] != quad[k] )
+            {
+                ++j;
+            }
+            if( j == k )
+            {
+                _vertexQuads[ quad[k] ].push_back( int32_t( q ));
+            }
+        }
+    }
+}
+
+/**
+ * @brief QuadDecimator::_buildQuadrics
+ * @param vertices
+ * @param quads
+ * @param numThreads
+ */
+void QuadDecimator::_buildQuadrics( const std::vector< Vertex > & vertices,
+                                    const std::vector< Quad > & quads,
+                                    const unsigned int numThreads )
+{
+    _quadrics.resize( vertices.size());
+    _locked.assign( vertices.size(), 0 );
+
+    int32_t const numVertices = int32_t( vertices.size());
+    int32_t const numTasks = ( numVertices + VERTICES_PER_TASK - 1 ) / VERTICES_PER_TASK;
+    parallelFor( 0, numTasks, [ & ]( const int32_t task )
+    {
+        std::vector< int32_t > next;
+        std::vector< int32_t > previous;
+        int32_t const end = std::min( numVertices, ( task + 1 ) * VERTICES_PER_TASK );
+        for( int32_t v = task * VERTICES_PER_TASK; v < end; ++v )
+        {
+            Quadric & quadric = _quadrics[v];
+            std::fill( quadric.a, quadric.a + 10, 0.0 );
+            next.clear();
+            previous.clear();
+
+            bool locked = _vertexQuads[v].empty();
+            for( int32_t const q : _vertexQuads[v] )
+            {
+                const Quad & quad = quads[q];
+                if( isDegenerate( quads[q] ))
+                {
+                    locked = true;
+                    continue;
+                }
+
+                int k = 0;
+                while( quad[k] != v )
+                {
+                    ++k;
+                }
+                next.push_back( quad[( k + 1 ) & 3 ]);
+                previous.push_back( quad[( k + 3 ) & 3 ]);
+
+                // Unweighted quadric of the plane through the quad center
+                Vector p[4];
+                for( int i = 0; i < 4; ++i )
+                {
+                    p[i] = toVector( vertices[ quad[i] ]);
+                }
+                Vector n = quadNormal( p );
+                double const length = std::sqrt( dot( n, n ));
+                if( length == 0.0 )
+                {
+                    continue;
+                }
+                n = { n.x / length, n.y / length, n.z / length };
+                Vector const center = { ( p[0].x + p[1].x + p[2].x + p[3].x ) * 0.25,
+                                        ( p[0].y + p[1].y + p[2].y + p[3].y ) * 0.25,
+                                        ( p[0].z + p[1].z + p[2].z + p[3].z ) * 0.25 };
+                double const d = -dot( n, center );
+                double const plane[] = { n.x, n.y, n.z, d };
+                int entry = 0;
+                for( int i = 0; i < 4; ++i )
+                {
+                    for( int j = i; j < 4; ++j )
+                    {
+                        quadric.a[ entry++ ] += plane[i] * plane[j];
+                    }
+                }
+            }
+
+            // Around an interior manifold vertex, each neighbor follows and
+            // precedes the vertex exactly once
+            std::sort( next.begin(), next.end());
+            std::sort( previous.begin(), previous.end());
+            if( next != previous ||
+                    std::adjacent_find( next.begin(), next.end()) != next.end())
+            {
+                locked = true;
+            }
+            _locked[v] = locked ? 1 : 0;
+        }
+    }, numThreads );
+}
+
+/**
+ * @brief QuadDecimator::_simplifyRound
+ * @param vertices
+ * @param quads
+ * @param shifted
+ * @param removeQuads
+ * @param numThreads
+ * @return
+ */
+size_t QuadDecimator::_simplifyRound( std::vector< Vertex > & vertices,
+                                      std::vector< Quad > & quads,
+                                      const bool shifted,
+                                      const size_t removeQuads,
+                                      const unsigned int numThreads )
+{
+    // Bounding box and average edge length of the remaining mesh
+    float lower[] = { std::numeric_limits< float >::max(),
+                      std::numeric_limits< float >::max(),
+                      std::numeric_limits< float >::max() };
+    float upper[] = { std::numeric_limits< float >::lowest(),
+                      std::numeric_limits< float >::lowest(),
+                      std::numeric_limits< float >::lowest() };
+    double edgeLength = 0.0;
+    size_t numQuads = 0;
+    for( auto const & quad : quads )
+    {
+        if( isCollapsed( quad ))
+        {
+            continue;
+        }
+        Vertex const & v0 = vertices[ quad.i0 ];
+        Vertex const & v1 = vertices[ quad.i1 ];
+        edgeLength += std::sqrt( double(( v1.x - v0.x ) * ( v1.x - v0.x ) +
+                                        ( v1.y - v0.y ) * ( v1.y - v0.y ) +
+                                        ( v1.z - v0.z ) * ( v1.z - v0.z )));
+        ++numQuads;
+
+        for( int k = 0; k < 4; ++k )
+        {
+            Vertex const & v = vertices[ quad[k] ];
+            lower[0] = std::min( lower[0], v.x );
+            lower[1] = std::min( lower[1], v.y );
+            lower[2] = std::min( lower[2], v.z );
+            upper[0] = std::max( upper[0], v.x );
+            upper[1] = std::max( upper[1], v.y );
+            upper[2] = std::max( upper[2], v.z );
+        }
+    }
+    if( numQuads == 0 )
+    {
+        return 0;
+    }
+
+    float const blockSize = std::max( MIN_BLOCK_SIZE,
+                                      BLOCK_SIZE_IN_QUADS * float( edgeLength / double( numQuads )));
+    float const shift = shifted ? 0.5f * blockSize : 0.0f;
+    int32_t numBlocks[3];
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        numBlocks[ axis ] = int32_t(( upper[ axis ] - lower[ axis ]) / blockSize ) + 2;
+    }
+
+    // Assign the vertices and the quads inside a single block
+    _vertexBlocks.resize( vertices.size());
+    for( size_t v = 0; v < vertices.size(); ++v )
+    {
+        if( _vertexQuads[v].empty())
+        {
+            _vertexBlocks[v] = -1;
+            continue;
+        }
+        int32_t const bx = int32_t(( vertices[v].x - lower[0] + shift ) / blockSize );
+        int32_t const by = int32_t(( vertices[v].y - lower[1] + shift ) / blockSize );
+        int32_t const bz = int32_t(( vertices[v].z - lower[2] + shift ) / blockSize );
+        _vertexBlocks[v] = bx + numBlocks[0] * ( by + numBlocks[1] * bz );
+    }
+
+    _blockQuads.resize( size_t( numBlocks[0] ) * size_t( numBlocks[1] ) * size_t( numBlocks[2] ));
+    for( auto & blockQuads : _blockQuads )
+    {
+        blockQuads.clear();
+    }
+    size_t numBlockQuads = 0;
+    for( size_t q = 0; q < quads.size(); ++q )
+    {
+        Quad const & quad = quads[q];
+        if( isCollapsed( quad ) || isDegenerate( quad ))
+        {
+            continue;
+        }
+        int32_t const block = _vertexBlocks[ quad.i0 ];
+        if( _vertexBlocks[ quad.i1 ] == block && _vertexBlocks[ quad.i2 ] == block &&
+                _vertexBlocks[ quad.i3 ] == block )
+        {
+            _blockQuads[ block ].push_back( int32_t( q ));
+            ++numBlockQuads;
+        }
+    }
+
+    // Distribute the quads to remove proportionally to the blocks
+    std::vector< size_t > removed( _blockQuads.size(), 0 );
+    parallelFor( 0, int32_t( _blockQuads.size()), [ & ]( const int32_t block )
+    {
+        size_t const blockQuads = _blockQuads[ block ].size();
+        if( blockQuads == 0 )
+        {
+            return;
+        }
+        size_t blockRemove = 0;
+        if( removeQuads > 0 )
+        {
+            blockRemove = size_t(( double( removeQuads ) * double( blockQuads ) +
+                                   double( numBlockQuads ) - 1.0 ) / double( numBlockQuads ));
+            if( blockRemove == 0 )
+            {
+                return;
+            }
+        }
+        removed[ block ] = _simplifyBlock( block, vertices, quads, blockRemove );
+    }, numThreads );
+
+    size_t total = 0;
+    for( size_t const count : removed )
+    {
+        total += count;
+    }
+    return total;
+}
+
+/**
+ * @brief QuadDecimator::_simplifyBlock
+ * @param block
+ * @param vertices
+ * @param quads
+ * @param removeQuads
+ * @return
+ */
+size_t QuadDecimator::_simplifyBlock( const int32_t block,
+                                      std::vector< Vertex > & vertices,
+                                      std::vector< Quad > & quads,
+                                      const size_t removeQuads )
+{
+    std::priority_queue< Collapse > collapses;
+
+    // Queue the cheaper diagonal of a quad
+    auto enqueue = [ & ]( const int32_t q )
+    {
+        Collapse best;
+        best.cost = std::numeric_limits< double >::infinity();
+        best.diagonal = -1;
+        for( int diagonal = 0; diagonal < 2; ++diagonal )
+        {
+            const Quad & quad = quads[q];
+            if( _locked[ quad[ diagonal ]] || _locked[ quad[ diagonal + 2 ]])
+            {
+                continue;
+            }
+            Vertex position;
+            double const cost = _collapseCost( vertices, quads[q], diagonal, position );
+            if( best.diagonal < 0 || cost < best.cost )
+            {
+                best.cost = cost;
+                best.diagonal = diagonal;
+                best.position = position;
+            }
+        }
+        if( best.diagonal >= 0 && best.cost <= _maxCost )
+        {
+            best.quad = q;
+            best.stamp = _quadStamps[q];
+            collapses.push( best );
+        }
+    };
+
+    for( int32_t const q : _blockQuads[ block ])
+    {
+        enqueue( q );
+    }
+
+    size_t removed = 0;
+    while( !collapses.empty() && ( removeQuads == 0 || removed < removeQuads ))
+    {
+        Collapse const collapse = collapses.top();
+        collapses.pop();
+        if( isCollapsed( quads[ collapse.quad ]) ||
+                _quadStamps[ collapse.quad ] != collapse.stamp ||
+                !_canCollapse( vertices, quads, block, collapse.quad, collapse.diagonal,
+                               collapse.position ))
+        {
+            continue;
+        }
+
+        // Merge the diagonal end c into a
+        const Quad & quad = quads[ collapse.quad ];
+        int32_t const a = quad[ collapse.diagonal ];
+        int32_t const b = quad[ collapse.diagonal + 1 ];
+        int32_t const c = quad[ collapse.diagonal + 2 ];
+        int32_t const d = quad[( collapse.diagonal + 3 ) & 3 ];
+
+        vertices[a] = collapse.position;
+        for( int i = 0; i < 10; ++i )
+        {
+            _quadrics[a].a[i] += _quadrics[c].a[i];
+        }
+
+        auto unlink = [ & ]( const int32_t v, const int32_t q )
+        {
+            auto & vertexQuads = _vertexQuads[v];
+            vertexQuads.erase( std::find( vertexQuads.begin(), vertexQuads.end(), q ));
+        };
+        unlink( a, collapse.quad );
+        unlink( b, collapse.quad );
+        unlink( d, collapse.quad );
+        for( int32_t const q : _vertexQuads[c] )
+        {
+            if( q == collapse.quad )
+            {
+                continue;
+            }
+            Quad & renamed = quads[q];
+            for( int k = 0; k < 4; ++k )
+            {
+                if( renamed[k] == c )
+                {
+                    renamed[k] = a;
+                }
+            }
+            _vertexQuads[a].push_back( q );
+        }
+        _vertexQuads[c].clear();
+        quads[ collapse.quad ].i0 = -1;
+        ++removed;
+
+        // Merge the doublet ( s, x, p, y ), ( s, y, r, x ) left around a side
+        // vertex into ( x, p, y, r )
+        for( int32_t const side : { b, d } )
+        {
+            if( _vertexQuads[ side ].size() != 2 )
+            {
+                continue;
+            }
+            int32_t const first = _vertexQuads[ side ][0];
+            int32_t const second = _vertexQuads[ side ][1];
+            const Quad & firstIndices = quads[ first ];
+            const Quad & secondIndices = quads[ second ];
+            int k = 0;
+            while( firstIndices[k] != side )
+            {
+                ++k;
+            }
+            int m = 0;
+            while( secondIndices[m] != side )
+            {
+                ++m;
+            }
+            int32_t const x = firstIndices[( k + 1 ) & 3 ];
+            int32_t const p = firstIndices[( k + 2 ) & 3 ];
+            int32_t const y = firstIndices[( k + 3 ) & 3 ];
+            int32_t const r = secondIndices[( m + 2 ) & 3 ];
+
+            quads[ first ] = Quad( x, p, y, r );
+            quads[ second ].i0 = -1;
+            unlink( x, second );
+            unlink( y, second );
+            *std::find( _vertexQuads[r].begin(), _vertexQuads[r].end(), second ) = first;
+            _vertexQuads[ side ].clear();
+            ++removed;
+
+            ++_quadStamps[ first ];
+            enqueue( first );
+        }
+
+        // The quads around the moved vertex change their cost
+        for( int32_t const q : _vertexQuads[a] )
+        {
+            ++_quadStamps[q];
+            enqueue( q );
+        }
+    }
+    return removed;
+}
+
+/**
+ * @brief QuadDecimator::_collapseCost
+ * @param vertices
+ * @param quad
+ * @param diagonal
+ * @param position
+ * @return
+ */
+double QuadDecimator::_collapseCost( const std::vector< Vertex > & vertices,
+                                     const Quad & quad, const int diagonal,
+                                     Vertex & position ) const
+{
+    int32_t const a = quad[ diagonal ];
+    int32_t const c = quad[ diagonal + 2 ];
+
+    double q[10];
+    for( int i = 0; i < 10; ++i )
+    {
+        q[i] = _quadrics[a].a[i] + _quadrics[c].a[i];
+    }
+
+    auto error = [ & ]( const Vector & v )
+    {
+        return q[0] * v.x * v.x + 2.0 * q[1] * v.x * v.y + 2.0 * q[2] * v.x * v.z +
+                2.0 * q[3] * v.x + q[4] * v.y * v.y + 2.0 * q[5] * v.y * v.z +
+                2.0 * q[6] * v.y + q[7] * v.z * v.z + 2.0 * q[8] * v.z + q[9];
+    };
+
+    Vector const pa = toVector( vertices[a] );
+    Vector const pc = toVector( vertices[c] );
+    Vector const middle = { ( pa.x + pc.x ) * 0.5, ( pa.y + pc.y ) * 0.5, ( pa.z + pc.z ) * 0.5 };
+    Vector const diagonalVector = pc - pa;
+    double const diagonalLength2 = dot( diagonalVector, diagonalVector );
+
+    // Minimize the quadric if it is well conditioned and the minimum stays
+    // close to the quad, otherwise use the best of the ends and the middle
+    double const m00 = q[4] * q[7] - q[5] * q[5];
+    double const m01 = q[2] * q[5] - q[1] * q[7];
+    double const m02 = q[1] * q[5] - q[2] * q[4];
+    double const det = q[0] * m00 + q[1] * m01 + q[2] * m02;
+    double const trace = q[0] + q[4] + q[7];
+    if( std::abs( det ) > 1e-6 * trace * trace * trace )
+    {
+        double const m11 = q[0] * q[7] - q[2] * q[2];
+        double const m12 = q[1] * q[2] - q[0] * q[5];
+        double const m22 = q[0] * q[4] - q[1] * q[1];
+        Vector const optimum = { -( m00 * q[3] + m01 * q[6] + m02 * q[8] ) / det,
+                                 -( m01 * q[3] + m11 * q[6] + m12 * q[8] ) / det,
+                                 -( m02 * q[3] + m12 * q[6] + m22 * q[8] ) / det };
+        Vector const offset = optimum - middle;
+        if( dot( offset, offset ) <= 0.25 * diagonalLength2 )
+        {
+            position = Vertex( float( optimum.x ), float( optimum.y ), float( optimum.z ));
+            return std::max( error( optimum ), 0.0 );
+        }
+    }
+
+    Vector const candidates[] = { middle, pa, pc };
+    double best = std::numeric_limits< double >::infinity();
+    for( auto const & candidate : candidates )
+    {
+        double const cost = error( candidate );
+        if( cost < best )
+        {
+            best = cost;
+            position = Vertex( float( candidate.x ), float( candidate.y ), float( candidate.z ));
+        }
+    }
+    return std::max( best, 0.0 );
+}
+
+/**
+ * @brief QuadDecimator::_canCollapse
+ * @param vertices
+ * @param quads
+ * @param block
+ * @param quad
+ * @param diagonal
+ * @param position
+ * @return
+ */
+bool QuadDecimator::_canCollapse( const std::vector< Vertex > & vertices,
+                                  const std::vector< Quad > & quads,
+                                  const int32_t block, const int32_t quad, const int diagonal,
+                                  const Vertex & position ) const
+{
+    const Quad & quadIndices = quads[ quad ];
+    int32_t const a = quadIndices[ diagonal ];
+    int32_t const b = quadIndices[ diagonal + 1 ];
+    int32_t const c = quadIndices[ diagonal + 2 ];
+    int32_t const d = quadIndices[( diagonal + 3 ) & 3 ];
+
+    // A side vertex with three quads keeps two of them, which form a doublet
+    // and are merged
+    if( _locked[a] || _locked[c] ||
+            _vertexQuads[b].size() < 3 || _vertexQuads[d].size() < 3 )
+    {
+        return false;
+    }
+
+    Vector const moved = toVector( position );
+    std::vector< int32_t > neighbors[2];
+    int32_t const ends[] = { a, c };
+    for( int end = 0; end < 2; ++end )
+    {
+        for( int32_t const q : _vertexQuads[ ends[ end ]])
+        {
+            if( q == quad )
+            {
+                continue;
+            }
+            const Quad & other = quads[q];
+
+            // All changed quads have to be inside the block and must not
+            // contain both ends
+            int k = -1;
+            for( int i = 0; i < 4; ++i )
+            {
+                if( _vertexBlocks[ other[i] ] != block || other[i] == ends[ 1 - end ])
+                {
+                    return false;
+                }
+                if( other[i] == ends[ end ])
+                {
+                    k = i;
+                }
+            }
+            neighbors[ end ].push_back( other[( k + 1 ) & 3 ]);
+            neighbors[ end ].push_back( other[( k + 3 ) & 3 ]);
+
+            // The quad must not fold over
+            Vector before[4];
+            Vector after[4];
+            for( int i = 0; i < 4; ++i )
+            {
+                before[i] = toVector( vertices[ other[i] ]);
+                after[i] = i == k ? moved : before[i];
+            }
+            if( dot( quadNormal( before ), quadNormal( after )) <= 0.0 )
+            {
+                return false;
+            }
+        }
+    }
+
+    // Only the side vertices may be shared neighbors of both ends, others
+    // would end up on non-manifold edges
+    for( int32_t const v : neighbors[0] )
+    {
+        if( v != b && v != d &&
+                std::find( neighbors[1].begin(), neighbors[1].end(), v ) != neighbors[1].end())
+        {
+            return false;
+        }
+    }
+
+    // Corners of the doublet quads after the collapse, starting at the side
+    // vertex. The quads ( s, x, p, y ) and ( s, y, r, x ) merge into
+    // ( x, p, y, r ).
+    int32_t const sides[] = { b, d };
+    int32_t doubletQuads[2][2] = { { -1, -1 }, { -1, -1 } };
+    int32_t corners[2][2][4];
+    for( int i = 0; i < 2; ++i )
+    {
+        int32_t const side = sides[i];
+        if( _vertexQuads[ side ].size() != 3 )
+        {
+            continue;
+        }
+        if( _locked[ side ])
+        {
+            return false;
+        }
+
+        int numQuads = 0;
+        for( int32_t const q : _vertexQuads[ side ])
+        {
+            if( q == quad )
+            {
+                continue;
+            }
+            if( q == doubletQuads[0][0] || q == doubletQuads[0][1] )
+            {
+                return false;
+            }
+            const Quad & other = quads[q];
+            int k = 0;
+            while( other[k] != side )
+            {
+                ++k;
+            }
+            for( int j = 0; j < 4; ++j )
+            {
+                int32_t const v = other[( k + j ) & 3 ];
+                if( _vertexBlocks[v] != block )
+                {
+                    return false;
+                }
+                corners[i][ numQuads ][j] = v == c ? a : v;
+            }
+            doubletQuads[i][ numQuads++ ] = q;
+        }
+        if( corners[i][1][1] != corners[i][0][3] || corners[i][1][3] != corners[i][0][1] ||
+                corners[i][0][2] == corners[i][1][2] )
+        {
+            return false;
+        }
+    }
+
+    // The merged quads must not leave doublets at x and y
+    auto valenceAfter = [ & ]( const int32_t v )
+    {
+        size_t valence = v == a ? _vertexQuads[a].size() + _vertexQuads[c].size() - 2 :
+                                  _vertexQuads[v].size() - ( v == b || v == d ? 1 : 0 );
+        for( int i = 0; i < 2; ++i )
+        {
+            if( doubletQuads[i][0] >= 0 &&
+                    ( corners[i][0][1] == v || corners[i][0][3] == v ))
+            {
+                --valence;
+            }
+        }
+        return valence;
+    };
+
+    auto corner = [ & ]( const int32_t v )
+    {
+        return v == a ? moved : toVector( vertices[v] );
+    };
+    for( int i = 0; i < 2; ++i )
+    {
+        if( doubletQuads[i][0] < 0 )
+        {
+            continue;
+        }
+        int32_t const x = corners[i][0][1];
+        int32_t const p = corners[i][0][2];
+        int32_t const y = corners[i][0][3];
+        int32_t const r = corners[i][1][2];
+        if( valenceAfter( x ) < 3 || valenceAfter( y ) < 3 )
+        {
+            return false;
+        }
+
+        // The merged quad keeps the orientation of the doublet, and the
+        // removed side vertex stays within the error bound of its plane
+        Vector const merged[] = { corner( x ), corner( p ), corner( y ), corner( r ) };
+        Vector const first[] = { corner( sides[i] ), corner( x ), corner( p ), corner( y ) };
+        Vector const second[] = { corner( sides[i] ), corner( y ), corner( r ), corner( x ) };
+        Vector const normal = quadNormal( merged );
+        if( dot( normal, quadNormal( first )) <= 0.0 || dot( normal, quadNormal( second )) <= 0.0 )
+        {
+            return false;
+        }
+        Vector const center = { ( merged[0].x + merged[1].x + merged[2].x + merged[3].x ) * 0.25,
+                                ( merged[0].y + merged[1].y + merged[2].y + merged[3].y ) * 0.25,
+                                ( merged[0].z + merged[1].z + merged[2].z + merged[3].z ) * 0.25 };
+        double const distance = dot( normal, corner( sides[i] ) - center );
+        if( distance * distance > _maxCost * dot( normal, normal ))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief QuadDecimator::_compact
+ * @param vertices
+ * @param quads
+ */
+void QuadDecimator::_compact( std::vector< Vertex > & vertices,
+                              std::vector< Quad > & quads ) const
+{
+    std::vector< int32_t > remap( vertices.size(), -1 );
+    std::vector< Vertex > kept;
+    size_t numQuads = 0;
+    for( auto const & quad : quads )
+    {
+        if( isCollapsed( quad ))
+        {
+            continue;
+        }
+        Quad & keptQuad = quads[ numQuads++ ];
+        keptQuad = quad;
+        for( int k = 0; k < 4; ++k )
+        {
+            int32_t & index = remap[ keptQuad[k] ];
+            if( index < 0 )
+            {
+                index = int32_t( kept.size());
+                kept.push_back( vertices[ keptQuad[k] ]);
+            }
+            keptQuad[k] = index;
+        }
+    }
+    quads.resize( numQuads );
+    vertices.swap( kept );
+}
+
+}
@@ -0,0 +1,201 @@
+#ifndef QUADDECIMATOR_H
+#define QUADDECIMATOR_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+#include "quad.h"
+#include "vertex.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief The QuadDecimator class
+ * Simplifies quad meshes with shared vertices by diagonal collapses. A
+ * collapse merges two opposite vertices of a quad and removes the quad, so
+ * the mesh stays a pure quad mesh. Collapses are ordered by the quadric error
+ * of the merged vertex, which is small in nearly flat regions.
+ * The mesh is partitioned into spatial blocks, which are simplified in
+ * parallel. Only quads with all vertices inside one block are collapsed, so
+ * the blocks are shifted by half a block in every other round.
+ * Vertices on the mesh boundary or on non-manifold edges are kept, so open
+ * borders, for example between bricks, stay unchanged. Collapses that would
+ * fold quads over or create non-manifold edges are rejected. A side vertex of
+ * the collapsed quad left with two quads is removed by merging them.
+ */
+class QuadDecimator
+{
+public:
+
+    /**
+     * @brief decimate
+     * Simplify the mesh in place. Unreferenced vertices are removed.
+     * @param vertices
+     * @param quads
+     * @param targetQuads
+     * Stop after reaching this number of quads, zero disables the target.
+     * @param maxError
+     * Maximum quadric error of a collapse as a distance in mesh units, zero
+     * disables the bound.
+     * @param numThreads
+     * Number of threads, zero uses all hardware threads.
+     */
+    void decimate( std::vector< Vertex > & vertices,
+                   std::vector< Quad > & quads,
+                   const size_t targetQuads,
+                   const float maxError,
+                   const unsigned int numThreads = 0 );
+
+private:
+
+    /// Symmetric 4x4 error quadric
+    struct Quadric
+    {
+        double a[10];
+    };
+
+    /**
+     * @brief _linkQuads
+     * Collect the remaining quads around each vertex.
+     * @param numVertices
+     * @param quads
+     */
+    void _linkQuads( const size_t numVertices, const std::vector< Quad > & quads );
+
+    /**
+     * @brief _buildQuadrics
+     * Sum the plane quadrics of the quads around each vertex and lock
+     * boundary, non-manifold and degenerate vertices.
+     * @param vertices
+     * @param quads
+     * @param numThreads
+     */
+    void _buildQuadrics( const std::vector< Vertex > & vertices,
+                         const std::vector< Quad > & quads,
+                         const unsigned int numThreads );
+
+    /**
+     * @brief _simplifyRound
+     * Assign the vertices to blocks and simplify all blocks in parallel.
+     * @param vertices
+     * @param quads
+     * @param shifted
+     * Shift the blocks by half a block.
+     * @param removeQuads
+     * Number of quads to remove, zero for no limit.
+     * @param numThreads
+     * @return Number of removed quads.
+     */
+    size_t _simplifyRound( std::vector< Vertex > & vertices,
+                           std::vector< Quad > & quads,
+                           const bool shifted,
+                           const size_t removeQuads,
+                           const unsigned int numThreads );
+
+    /**
+     * @brief _simplifyBlock
+     * Greedily collapse the quads of a block by increasing error.
+     * @param block
+     * @param vertices
+     * @param quads
+     * @param removeQuads
+     * Maximum number of quads to remove, zero for no limit.
+     * @return Number of removed quads.
+     */
+    size_t _simplifyBlock( const int32_t block,
+                           std::vector< Vertex > & vertices,
+                           std::vector< Quad > & quads,
+                           const size_t removeQuads );
+
+    /**
+     * @brief _collapseCost
+     * Find the position and error of collapsing a quad diagonal.
+     * @param vertices
+     * @param quad
+     * @param diagonal
+     * Zero merges the first and third vertex, one the second and fourth.
+     * @param position
+     * @return Quadric error of the merged vertex.
+     */
+    double _collapseCost( const std::vector< Vertex > & vertices,
+                          const Quad & quad, const int diagonal,
+                          Vertex & position ) const;
+
+    /**
+     * @brief _canCollapse
+     * Check the topology and orientation of the quads around a collapse.
+     * @param vertices
+     * @param quads
+     * @param block
+     * @param quad
+     * @param diagonal
+     * @param position
+     * @return True, if the collapse keeps the mesh manifold and unfolded.
+     */
+    bool _canCollapse( const std::vector< Vertex > & vertices,
+                       const std::vector< Quad > & quads,
+                       const int32_t block, const int32_t quad, const int diagonal,
+                       const Vertex & position ) const;
+
+    /**
+     * @brief _compact
+     * Remove collapsed quads and unreferenced vertices.
+     * @param vertices
+     * @param quads
+     */
+    void _compact( std::vector< Vertex > & vertices,
+                   std::vector< Quad > & quads ) const;
+
+private:
+
+    /**
+     * @brief _maxCost
+     * Maximum quadric error of a collapse.
+     */
+    double _maxCost;
+
+    /**
+     * @brief _quadrics
+     * Error quadric of each vertex.
+     */
+    std::vector< Quadric > _quadrics;
+
+    /**
+     * @brief _locked
+     * Vertices, which are never moved.
+     */
+    std::vector< uint8_t > _locked;
+
+    /**
+     * @brief _vertexQuads
+     * Quads around each vertex.
+     */
+    std::vector< std::vector< int32_t > > _vertexQuads;
+
+    /**
+     * @brief _vertexBlocks
+     * Block of each vertex in the current round.
+     */
+    std::vector< int32_t > _vertexBlocks;
+
+    /**
+     * @brief _blockQuads
+     * Quads with all vertices inside each block.
+     */
+    std::vector< std::vector< int32_t > > _blockQuads;
+
+    /**
+     * @brief _quadStamps
+     * Modification stamp of each quad for detecting outdated collapses.
+     */
+    std::vector< uint32_t > _quadStamps;
+};
+
+}
+
+#endif // QUADDECIMATOR_H
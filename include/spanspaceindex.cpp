@@ -0,0 +1,166 @@
+#include "spanspaceindex.h"
+
+// STL includes
+#include <algorithm>
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Number of ( min, max ) buckets
+uint32_t constexpr NUM_BUCKETS = 256 * 256;
+
+}
+
+/**
+ * @brief SpanSpaceIndex::SpanSpaceIndex
+ */
+SpanSpaceIndex::SpanSpaceIndex()
+{
+    _volumeDimensions[0] = _volumeDimensions[1] = _volumeDimensions[2] = 0;
+}
+
+/**
+ * @brief SpanSpaceIndex::bucket
+ * @param minValue
+ * @param maxValue
+ * @return
+ */
+uint32_t SpanSpaceIndex::_bucket( const uint8_t minValue, const uint8_t maxValue )
+{
+    // Ascending min, descending max
+    return uint32_t( minValue ) * 256u + uint32_t( 255u - maxValue );
+}
+
+/**
+ * @brief SpanSpaceIndex::build
+ * @param volumeGrid
+ * @param x
+ * @param y
+ * @param z
+ */
+void SpanSpaceIndex::build( const uint8_t * volumeGrid,
+                            const int32_t x, const int32_t y, const int32_t z )
+{
+    _volumeDimensions[0] = x;
+    _volumeDimensions[1] = y;
+    _volumeDimensions[2] = z;
+    _bucketStart.assign( NUM_BUCKETS + 1, 0 );
+    _cells.clear();
+
+    // Same cell range as traversed by the builder
+    int32_t const reducedX = x - 2;
+    int32_t const reducedY = y - 2;
+    int32_t const reducedZ = z - 2;
+    if( reducedX <= 0 || reducedY <= 0 || reducedZ <= 0 )
+    {
+        return;
+    }
+
+    size_t const sliceSize = size_t( x ) * size_t( y );
+    std::vector< uint16_t > cellBuckets( size_t( reducedX ) * reducedY * reducedZ );
+
+    // Compute the ( min, max ) bucket of each cell and count the buckets
+    size_t c = 0;
+    for( int32_t cz = 0; cz < reducedZ; ++cz )
+    {
+        for( int32_t cy = 0; cy < reducedY; ++cy )
+        {
+            const uint8_t * const row = volumeGrid + cy * size_t( x ) + cz * sliceSize;
+            for( int32_t cx = 0; cx < reducedX; ++cx, ++c )
+            {
+                const uint8_t * const corner = row + cx;
+                uint8_t const corners[] =
+                {
+                    corner[0], corner[1], corner[x], corner[x + 1],
+                    corner[sliceSize], corner[sliceSize + 1],
+                    corner[sliceSize + x], corner[sliceSize + x + 1]
+                };
+                uint8_t const minValue = *std::min_element( corners, corners + 8 );
+                uint8_t const maxValue = *std::max_element( corners, corners + 8 );
+                cellBuckets[c] = uint16_t( _bucket( minValue, maxValue ));
+
+                // Constant cells are never active
+                if( minValue != maxValue )
+                {
+                    ++_bucketStart[ cellBuckets[c] + 1 ];
+                }
+            }
+        }
+    }
+
+    // Prefix sums give the bucket offsets
+    for( uint32_t b = 0; b < NUM_BUCKETS; ++b )
+    {
+        _bucketStart[ b + 1 ] += _bucketStart[ b ];
+    }
+
+    // Scatter the cell indices into their buckets. Within a bucket the
+    // cells stay in ascending order.
+    _cells.resize( _bucketStart[ NUM_BUCKETS ]);
+    std::vector< uint32_t > fill( _bucketStart.begin(), _bucketStart.end() - 1 );
+    c = 0;
+    for( int32_t cz = 0; cz < reducedZ; ++cz )
+    {
+        for( int32_t cy = 0; cy < reducedY; ++cy )
+        {
+            for( int32_t cx = 0; cx < reducedX; ++cx, ++c )
+            {
+                uint32_t const bucket = cellBuckets[c];
+                if( bucket / 256u != 255u - bucket % 256u )
+                {
+                    _cells[ fill[ bucket ]++ ] = uint32_t( cx + size_t( x ) * cy + sliceSize * cz );
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief SpanSpaceIndex::activeCells
+ * @param isoValue
+ * @param cells
+ */
+void SpanSpaceIndex::activeCells( const uint8_t isoValue, std::vector< uint32_t > & cells ) const
+{
+    cells.clear();
+    if( _cells.empty() || isoValue == 0 )
+    {
+        return;
+    }
+
+    // For each min < iso the cells with max >= iso are the first
+    // 256 - iso buckets
+    for( uint32_t minValue = 0; minValue < isoValue; ++minValue )
+    {
+        uint32_t const begin = _bucketStart[ minValue * 256u ];
+        uint32_t const end = _bucketStart[ minValue * 256u + 256u - isoValue ];
+        cells.insert( cells.end(), _cells.begin() + begin, _cells.begin() + end );
+    }
+
+    // The builder expects ascending voxel layers
+    std::sort( cells.begin(), cells.end());
+}
+
+/**
+ * @brief SpanSpaceIndex::dimension
+ * @param axis
+ * @return
+ */
+int32_t SpanSpaceIndex::dimension( const int axis ) const
+{
+    return _volumeDimensions[ axis ];
+}
+
+/**
+ * @brief SpanSpaceIndex::numCells
+ * @return
+ */
+size_t SpanSpaceIndex::numCells() const
+{
+    return _cells.size();
+}
+
+}
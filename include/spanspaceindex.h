@@ -0,0 +1,102 @@
+#ifndef SPANSPACEINDEX_H
+#define SPANSPACEINDEX_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+namespace dualmc
+{
+
+/**
+ * @brief The SpanSpaceIndex class
+ * Span space index of the cells of a volume for fast iso value changes.
+ * Each cell is a point ( min, max ) in span space, where min and max are
+ * the extreme values of its eight corner voxels. A cell intersects the iso
+ * surface of the iso value v exactly if min < v <= max.
+ * The cells are bucketed by their ( min, max ) pair with a counting sort,
+ * where buckets are ordered by ascending min and descending max. For a given
+ * iso value, all active cells with the same min value then form a single
+ * contiguous range. A query costs O( 256 + k log k ) for k active cells.
+ * Cells with constant values are never active and are not stored.
+ */
+class SpanSpaceIndex
+{
+public:
+
+    /**
+     * @brief SpanSpaceIndex
+     * Empty index.
+     */
+    SpanSpaceIndex();
+
+    /**
+     * @brief build
+     * Build the index for all cells, which the builder visits.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     */
+    void build( const uint8_t * volumeGrid,
+                const int32_t x, const int32_t y, const int32_t z );
+
+    /**
+     * @brief activeCells
+     * Get the linearized voxel indices of all cells intersecting the iso
+     * surface of the given iso value, sorted in ascending order.
+     * @param isoValue
+     * @param cells
+     */
+    void activeCells( const uint8_t isoValue, std::vector< uint32_t > & cells ) const;
+
+    /**
+     * @brief dimension
+     * @param axis
+     * @return Volume dimension the index was built for.
+     */
+    int32_t dimension( const int axis ) const;
+
+    /**
+     * @brief numCells
+     * @return Number of stored non-constant cells.
+     */
+    size_t numCells() const;
+
+private:
+
+    /**
+     * @brief _bucket
+     * @param minValue
+     * @param maxValue
+     * @return Bucket of a ( min, max ) pair.
+     */
+    static uint32_t _bucket( const uint8_t minValue, const uint8_t maxValue );
+
+private:
+
+    /**
+     * @brief _volumeDimensions
+     * Dimensions of the indexed volume.
+     */
+    int32_t _volumeDimensions[3];
+
+    /**
+     * @brief _bucketStart
+     * Start offset of each of the 256 * 256 buckets in _cells.
+     */
+    std::vector< uint32_t > _bucketStart;
+
+    /**
+     * @brief _cells
+     * Linearized voxel indices of the cells ordered by their buckets.
+     */
+    std::vector< uint32_t > _cells;
+};
+
+}
+
+#endif // SPANSPACEINDEX_H
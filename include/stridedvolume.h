@@ -0,0 +1,73 @@
+#ifndef STRIDEDVOLUME_H
+#define STRIDEDVOLUME_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+namespace dualmc
+{
+
+/**
+ * @brief The StridedVolume class
+ * View of a volume in foreign memory with explicit strides in bytes. The
+ * element stride steps between neighboring voxels of a row, so one channel
+ * of interleaved multi-channel voxels can be viewed by offsetting the data
+ * pointer to the channel. The row pitch and the slice pitch step between
+ * rows and slices, which may be padded. A dense x-fastest volume has the
+ * strides 1, x and x * y.
+ * The view does not own the memory. It is also a volume accessor, so the
+ * builder reads the voxels in place.
+ */
+class StridedVolume
+{
+public:
+
+    /// Initializing constructor
+    StridedVolume( const uint8_t * data,
+                   const int32_t x, const int32_t y, const int32_t z,
+                   const size_t elementStride,
+                   const size_t rowPitch,
+                   const size_t slicePitch )
+        : _data( data ),
+          _elementStride( elementStride ),
+          _rowPitch( rowPitch ),
+          _slicePitch( slicePitch )
+    {
+        _dimensions[0] = x;
+        _dimensions[1] = y;
+        _dimensions[2] = z;
+    }
+
+    /// Number of voxels along an axis
+    int32_t dimension( const int axis ) const
+    {
+        return _dimensions[ axis ];
+    }
+
+    /// The voxel value at ( x, y, z )
+    uint8_t operator()( const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        return _data[ _elementStride * size_t( x ) + _rowPitch * size_t( y ) +
+                _slicePitch * size_t( z )];
+    }
+
+    /// All voxels are always available
+    void prepareLayer( const int32_t )
+    {
+        /// EMPTY
+    }
+
+private:
+
+    // Volume data, dimensions and strides in bytes
+    const uint8_t * _data;
+    int32_t _dimensions[3];
+    size_t _elementStride;
+    size_t _rowPitch;
+    size_t _slicePitch;
+};
+
+}
+
+#endif // STRIDEDVOLUME_H
@@ -58,308 +58,271 @@ namespace dualmc
 //   o--------2----------o
 //
 
-// Encodes the edge vertices for the 256 marching cubes cases.
-// A marching cube case produces up to four faces and ,thus, up to four
-// dual points.
-static int32_t const dualPointsList[256][4] =
+// The tables are generated at compile time with the same approach as the
+// gentables application.
+
+/**
+ * @brief The DualPointsTable struct
+ * Encodes the edge vertices for the 256 marching cubes cases.
+ * A marching cube case produces up to four faces and ,thus, up to four
+ * dual points.
+ */
+struct DualPointsTable
 {
-    {0, 0, 0, 0},                                                           // 0
-    {EDGE0|EDGE3|EDGE8, 0, 0, 0},                                           // 1
-    {EDGE0|EDGE1|EDGE9, 0, 0, 0},                                           // 2
-    {EDGE1|EDGE3|EDGE8|EDGE9, 0, 0, 0},                                     // 3
-    {EDGE4|EDGE7|EDGE8, 0, 0, 0},                                           // 4
-    {EDGE0|EDGE3|EDGE4|EDGE7, 0, 0, 0},                                     // 5
-    {EDGE0|EDGE1|EDGE9, EDGE4|EDGE7|EDGE8, 0, 0},                           // 6
-    {EDGE1|EDGE3|EDGE4|EDGE7|EDGE9, 0, 0, 0},                               // 7
-    {EDGE4|EDGE5|EDGE9, 0, 0, 0},                                           // 8
-    {EDGE0|EDGE3|EDGE8, EDGE4|EDGE5|EDGE9, 0, 0},                           // 9
-    {EDGE0|EDGE1|EDGE4|EDGE5, 0, 0, 0},                                     // 10
-    {EDGE1|EDGE3|EDGE4|EDGE5|EDGE8, 0, 0, 0},                               // 11
-    {EDGE5|EDGE7|EDGE8|EDGE9, 0, 0, 0},                                     // 12
-    {EDGE0|EDGE3|EDGE5|EDGE7|EDGE9, 0, 0, 0},                               // 13
-    {EDGE0|EDGE1|EDGE5|EDGE7|EDGE8, 0, 0, 0},                               // 14
-    {EDGE1|EDGE3|EDGE5|EDGE7, 0, 0, 0},                                     // 15
-    {EDGE2|EDGE3|EDGE11, 0, 0, 0},                                          // 16
-    {EDGE0|EDGE2|EDGE8|EDGE11, 0, 0, 0},                                    // 17
-    {EDGE0|EDGE1|EDGE9, EDGE2|EDGE3|EDGE11, 0, 0},                          // 18
-    {EDGE1|EDGE2|EDGE8|EDGE9|EDGE11, 0, 0, 0},                              // 19
-    {EDGE4|EDGE7|EDGE8, EDGE2|EDGE3|EDGE11, 0, 0},                          // 20
-    {EDGE0|EDGE2|EDGE4|EDGE7|EDGE11, 0, 0, 0},                              // 21
-    {EDGE0|EDGE1|EDGE9, EDGE4|EDGE7|EDGE8, EDGE2|EDGE3|EDGE11, 0},          // 22
-    {EDGE1|EDGE2|EDGE4|EDGE7|EDGE9|EDGE11, 0, 0, 0},                        // 23
-    {EDGE4|EDGE5|EDGE9, EDGE2|EDGE3|EDGE11, 0, 0},                          // 24
-    {EDGE0|EDGE2|EDGE8|EDGE11, EDGE4|EDGE5|EDGE9, 0, 0},                    // 25
-    {EDGE0|EDGE1|EDGE4|EDGE5, EDGE2|EDGE3|EDGE11, 0, 0},                    // 26
-    {EDGE1|EDGE2|EDGE4|EDGE5|EDGE8|EDGE11, 0, 0, 0},                        // 27
-    {EDGE5|EDGE7|EDGE8|EDGE9, EDGE2|EDGE3|EDGE11, 0, 0},                    // 28
-    {EDGE0|EDGE2|EDGE5|EDGE7|EDGE9|EDGE11, 0, 0, 0},                        // 29
-    {EDGE0|EDGE1|EDGE5|EDGE7|EDGE8, EDGE2|EDGE3|EDGE11, 0, 0},              // 30
-    {EDGE1|EDGE2|EDGE5|EDGE7|EDGE11, 0, 0, 0},                              // 31
-    {EDGE1|EDGE2|EDGE10, 0, 0, 0},                                          // 32
-    {EDGE0|EDGE3|EDGE8, EDGE1|EDGE2|EDGE10, 0, 0},                          // 33
-    {EDGE0|EDGE2|EDGE9|EDGE10, 0, 0, 0},                                    // 34
-    {EDGE2|EDGE3|EDGE8|EDGE9|EDGE10, 0, 0, 0},                              // 35
-    {EDGE4|EDGE7|EDGE8, EDGE1|EDGE2|EDGE10, 0, 0},                          // 36
-    {EDGE0|EDGE3|EDGE4|EDGE7, EDGE1|EDGE2|EDGE10, 0, 0},                    // 37
-    {EDGE0|EDGE2|EDGE9|EDGE10, EDGE4|EDGE7|EDGE8, 0, 0},                    // 38
-    {EDGE2|EDGE3|EDGE4|EDGE7|EDGE9|EDGE10, 0, 0, 0},                        // 39
-    {EDGE4|EDGE5|EDGE9, EDGE1|EDGE2|EDGE10, 0, 0},                          // 40
-    {EDGE0|EDGE3|EDGE8, EDGE4|EDGE5|EDGE9, EDGE1|EDGE2|EDGE10, 0},          // 41
-    {EDGE0|EDGE2|EDGE4|EDGE5|EDGE10, 0, 0, 0},                              // 42
-    {EDGE2|EDGE3|EDGE4|EDGE5|EDGE8|EDGE10, 0, 0, 0},                        // 43
-    {EDGE5|EDGE7|EDGE8|EDGE9, EDGE1|EDGE2|EDGE10, 0, 0},                    // 44
-    {EDGE0|EDGE3|EDGE5|EDGE7|EDGE9, EDGE1|EDGE2|EDGE10, 0, 0},              // 45
-    {EDGE0|EDGE2|EDGE5|EDGE7|EDGE8|EDGE10, 0, 0, 0},                        // 46
-    {EDGE2|EDGE3|EDGE5|EDGE7|EDGE10, 0, 0, 0},                              // 47
-    {EDGE1|EDGE3|EDGE10|EDGE11, 0, 0, 0},                                   // 48
-    {EDGE0|EDGE1|EDGE8|EDGE10|EDGE11, 0, 0, 0},                             // 49
-    {EDGE0|EDGE3|EDGE9|EDGE10|EDGE11, 0, 0, 0},                             // 50
-    {EDGE8|EDGE9|EDGE10|EDGE11, 0, 0, 0},                                   // 51
-    {EDGE4|EDGE7|EDGE8, EDGE1|EDGE3|EDGE10|EDGE11, 0, 0},                   // 52
-    {EDGE0|EDGE1|EDGE4|EDGE7|EDGE10|EDGE11, 0, 0, 0},                       // 53
-    {EDGE0|EDGE3|EDGE9|EDGE10|EDGE11, EDGE4|EDGE7|EDGE8, 0, 0},             // 54
-    {EDGE4|EDGE7|EDGE9|EDGE10|EDGE11, 0, 0, 0},                             // 55
-    {EDGE4|EDGE5|EDGE9, EDGE1|EDGE3|EDGE10|EDGE11, 0, 0},                   // 56
-    {EDGE0|EDGE1|EDGE8|EDGE10|EDGE11, EDGE4|EDGE5|EDGE9, 0, 0},             // 57
-    {EDGE0|EDGE3|EDGE4|EDGE5|EDGE10|EDGE11, 0, 0, 0},                       // 58
-    {EDGE4|EDGE5|EDGE8|EDGE10|EDGE11, 0, 0, 0},                             // 59
-    {EDGE5|EDGE7|EDGE8|EDGE9, EDGE1|EDGE3|EDGE10|EDGE11, 0, 0},             // 60
-    {EDGE0|EDGE1|EDGE5|EDGE7|EDGE9|EDGE10|EDGE11, 0, 0, 0},                 // 61
-    {EDGE0|EDGE3|EDGE5|EDGE7|EDGE8|EDGE10|EDGE11, 0, 0, 0},                 // 62
-    {EDGE5|EDGE7|EDGE10|EDGE11, 0, 0, 0},                                   // 63
-    {EDGE6|EDGE7|EDGE11, 0, 0, 0},                                          // 64
-    {EDGE0|EDGE3|EDGE8, EDGE6|EDGE7|EDGE11, 0, 0},                          // 65
-    {EDGE0|EDGE1|EDGE9, EDGE6|EDGE7|EDGE11, 0, 0},                          // 66
-    {EDGE1|EDGE3|EDGE8|EDGE9, EDGE6|EDGE7|EDGE11, 0, 0},                    // 67
-    {EDGE4|EDGE6|EDGE8|EDGE11, 0, 0, 0},                                    // 68
-    {EDGE0|EDGE3|EDGE4|EDGE6|EDGE11, 0, 0, 0},                              // 69
-    {EDGE0|EDGE1|EDGE9, EDGE4|EDGE6|EDGE8|EDGE11, 0, 0},                    // 70
-    {EDGE1|EDGE3|EDGE4|EDGE6|EDGE9|EDGE11, 0, 0, 0},                        // 71
-    {EDGE4|EDGE5|EDGE9, EDGE6|EDGE7|EDGE11, 0, 0},                          // 72
-    {EDGE0|EDGE3|EDGE8, EDGE4|EDGE5|EDGE9, EDGE6|EDGE7|EDGE11, 0},          // 73
-    {EDGE0|EDGE1|EDGE4|EDGE5, EDGE6|EDGE7|EDGE11, 0, 0},                    // 74
-    {EDGE1|EDGE3|EDGE4|EDGE5|EDGE8, EDGE6|EDGE7|EDGE11, 0, 0},              // 75
-    {EDGE5|EDGE6|EDGE8|EDGE9|EDGE11, 0, 0, 0},                              // 76
-    {EDGE0|EDGE3|EDGE5|EDGE6|EDGE9|EDGE11, 0, 0, 0},                        // 77
-    {EDGE0|EDGE1|EDGE5|EDGE6|EDGE8|EDGE11, 0, 0, 0},                        // 78
-    {EDGE1|EDGE3|EDGE5|EDGE6|EDGE11, 0, 0, 0},                              // 79
-    {EDGE2|EDGE3|EDGE6|EDGE7, 0, 0, 0},                                     // 80
-    {EDGE0|EDGE2|EDGE6|EDGE7|EDGE8, 0, 0, 0},                               // 81
-    {EDGE0|EDGE1|EDGE9, EDGE2|EDGE3|EDGE6|EDGE7, 0, 0},                     // 82
-    {EDGE1|EDGE2|EDGE6|EDGE7|EDGE8|EDGE9, 0, 0, 0},                         // 83
-    {EDGE2|EDGE3|EDGE4|EDGE6|EDGE8, 0, 0, 0},                               // 84
-    {EDGE0|EDGE2|EDGE4|EDGE6, 0, 0, 0},                                     // 85
-    {EDGE0|EDGE1|EDGE9, EDGE2|EDGE3|EDGE4|EDGE6|EDGE8, 0, 0},               // 86
-    {EDGE1|EDGE2|EDGE4|EDGE6|EDGE9, 0, 0, 0},                               // 87
-    {EDGE4|EDGE5|EDGE9, EDGE2|EDGE3|EDGE6|EDGE7, 0, 0},                     // 88
-    {EDGE0|EDGE2|EDGE6|EDGE7|EDGE8, EDGE4|EDGE5|EDGE9, 0, 0},               // 89
-    {EDGE0|EDGE1|EDGE4|EDGE5, EDGE2|EDGE3|EDGE6|EDGE7, 0, 0},               // 90
-    {EDGE1|EDGE2|EDGE4|EDGE5|EDGE6|EDGE7|EDGE8, 0, 0, 0},                   // 91
-    {EDGE2|EDGE3|EDGE5|EDGE6|EDGE8|EDGE9, 0, 0, 0},                         // 92
-    {EDGE0|EDGE2|EDGE5|EDGE6|EDGE9, 0, 0, 0},                               // 93
-    {EDGE0|EDGE1|EDGE2|EDGE3|EDGE5|EDGE6|EDGE8, 0, 0, 0},                   // 94
-    {EDGE1|EDGE2|EDGE5|EDGE6, 0, 0, 0},                                     // 95
-    {EDGE1|EDGE2|EDGE10, EDGE6|EDGE7|EDGE11, 0, 0},                         // 96
-    {EDGE0|EDGE3|EDGE8, EDGE1|EDGE2|EDGE10, EDGE6|EDGE7|EDGE11, 0},         // 97
-    {EDGE0|EDGE2|EDGE9|EDGE10, EDGE6|EDGE7|EDGE11, 0, 0},                   // 98
-    {EDGE2|EDGE3|EDGE8|EDGE9|EDGE10, EDGE6|EDGE7|EDGE11, 0, 0},             // 99
-    {EDGE4|EDGE6|EDGE8|EDGE11, EDGE1|EDGE2|EDGE10, 0, 0},                   // 100
-    {EDGE0|EDGE3|EDGE4|EDGE6|EDGE11, EDGE1|EDGE2|EDGE10, 0, 0},             // 101
-    {EDGE0|EDGE2|EDGE9|EDGE10, EDGE4|EDGE6|EDGE8|EDGE11, 0, 0},             // 102
-    {EDGE2|EDGE3|EDGE4|EDGE6|EDGE9|EDGE10|EDGE11, 0, 0, 0},                 // 103
-    {EDGE4|EDGE5|EDGE9, EDGE1|EDGE2|EDGE10, EDGE6|EDGE7|EDGE11, 0},         // 104
-    {EDGE0|EDGE3|EDGE8, EDGE4|EDGE5|EDGE9,
-     EDGE1|EDGE2|EDGE10, EDGE6|EDGE7|EDGE11},                               // 105
-    {EDGE0|EDGE2|EDGE4|EDGE5|EDGE10, EDGE6|EDGE7|EDGE11, 0, 0},             // 106
-    {EDGE2|EDGE3|EDGE4|EDGE5|EDGE8|EDGE10, EDGE6|EDGE7|EDGE11, 0, 0},       // 107
-    {EDGE5|EDGE6|EDGE8|EDGE9|EDGE11, EDGE1|EDGE2|EDGE10, 0, 0},             // 108
-    {EDGE0|EDGE3|EDGE5|EDGE6|EDGE9|EDGE11, EDGE1|EDGE2|EDGE10, 0, 0},       // 109
-    {EDGE0|EDGE2|EDGE5|EDGE6|EDGE8|EDGE10|EDGE11, 0, 0, 0},                 // 110
-    {EDGE2|EDGE3|EDGE5|EDGE6|EDGE10|EDGE11, 0, 0, 0},                       // 111
-    {EDGE1|EDGE3|EDGE6|EDGE7|EDGE10, 0, 0, 0},                              // 112
-    {EDGE0|EDGE1|EDGE6|EDGE7|EDGE8|EDGE10, 0, 0, 0},                        // 113
-    {EDGE0|EDGE3|EDGE6|EDGE7|EDGE9|EDGE10, 0, 0, 0},                        // 114
-    {EDGE6|EDGE7|EDGE8|EDGE9|EDGE10, 0, 0, 0},                              // 115
-    {EDGE1|EDGE3|EDGE4|EDGE6|EDGE8|EDGE10, 0, 0, 0},                        // 116
-    {EDGE0|EDGE1|EDGE4|EDGE6|EDGE10, 0, 0, 0},                              // 117
-    {EDGE0|EDGE3|EDGE4|EDGE6|EDGE8|EDGE9|EDGE10, 0, 0, 0},                  // 118
-    {EDGE4|EDGE6|EDGE9|EDGE10, 0, 0, 0},                                    // 119
-    {EDGE4|EDGE5|EDGE9, EDGE1|EDGE3|EDGE6|EDGE7|EDGE10, 0, 0},              // 120
-    {EDGE0|EDGE1|EDGE6|EDGE7|EDGE8|EDGE10, EDGE4|EDGE5|EDGE9, 0, 0},        // 121
-    {EDGE0|EDGE3|EDGE4|EDGE5|EDGE6|EDGE7|EDGE10, 0, 0, 0},                  // 122
-    {EDGE4|EDGE5|EDGE6|EDGE7|EDGE8|EDGE10, 0, 0, 0},                        // 123
-    {EDGE1|EDGE3|EDGE5|EDGE6|EDGE8|EDGE9|EDGE10, 0, 0, 0},                  // 124
-    {EDGE0|EDGE1|EDGE5|EDGE6|EDGE9|EDGE10, 0, 0, 0},                        // 125
-    {EDGE0|EDGE3|EDGE8, EDGE5|EDGE6|EDGE10, 0, 0},                          // 126
-    {EDGE5|EDGE6|EDGE10, 0, 0, 0},                                          // 127
-    {EDGE5|EDGE6|EDGE10, 0, 0, 0},                                          // 128
-    {EDGE0|EDGE3|EDGE8, EDGE5|EDGE6|EDGE10, 0, 0},                          // 129
-    {EDGE0|EDGE1|EDGE9, EDGE5|EDGE6|EDGE10, 0, 0},                          // 130
-    {EDGE1|EDGE3|EDGE8|EDGE9, EDGE5|EDGE6|EDGE10, 0, 0},                    // 131
-    {EDGE4|EDGE7|EDGE8, EDGE5|EDGE6|EDGE10, 0, 0},                          // 132
-    {EDGE0|EDGE3|EDGE4|EDGE7, EDGE5|EDGE6|EDGE10, 0, 0},                    // 133
-    {EDGE0|EDGE1|EDGE9, EDGE4|EDGE7|EDGE8, EDGE5|EDGE6|EDGE10, 0},          // 134
-    {EDGE1|EDGE3|EDGE4|EDGE7|EDGE9, EDGE5|EDGE6|EDGE10, 0, 0},              // 135
-    {EDGE4|EDGE6|EDGE9|EDGE10, 0, 0, 0},                                    // 136
-    {EDGE0|EDGE3|EDGE8, EDGE4|EDGE6|EDGE9|EDGE10, 0, 0},                    // 137
-    {EDGE0|EDGE1|EDGE4|EDGE6|EDGE10, 0, 0, 0},                              // 138
-    {EDGE1|EDGE3|EDGE4|EDGE6|EDGE8|EDGE10, 0, 0, 0},                        // 139
-    {EDGE6|EDGE7|EDGE8|EDGE9|EDGE10, 0, 0, 0},                              // 140
-    {EDGE0|EDGE3|EDGE6|EDGE7|EDGE9|EDGE10, 0, 0, 0},                        // 141
-    {EDGE0|EDGE1|EDGE6|EDGE7|EDGE8|EDGE10, 0, 0, 0},                        // 142
-    {EDGE1|EDGE3|EDGE6|EDGE7|EDGE10, 0, 0, 0},                              // 143
-    {EDGE2|EDGE3|EDGE11, EDGE5|EDGE6|EDGE10, 0, 0},                         // 144
-    {EDGE0|EDGE2|EDGE8|EDGE11, EDGE5|EDGE6|EDGE10, 0, 0},                   // 145
-    {EDGE0|EDGE1|EDGE9, EDGE2|EDGE3|EDGE11, EDGE5|EDGE6|EDGE10, 0},         // 146
-    {EDGE1|EDGE2|EDGE8|EDGE9|EDGE11, EDGE5|EDGE6|EDGE10, 0, 0},             // 147
-    {EDGE4|EDGE7|EDGE8, EDGE2|EDGE3|EDGE11, EDGE5|EDGE6|EDGE10, 0},         // 148
-    {EDGE0|EDGE2|EDGE4|EDGE7|EDGE11, EDGE5|EDGE6|EDGE10, 0, 0},             // 149
-    {EDGE0|EDGE1|EDGE9, EDGE4|EDGE7|EDGE8,
-     EDGE2|EDGE3|EDGE11, EDGE5|EDGE6|EDGE10},                               // 150
-    {EDGE1|EDGE2|EDGE4|EDGE7|EDGE9|EDGE11, EDGE5|EDGE6|EDGE10, 0, 0},       // 151
-    {EDGE4|EDGE6|EDGE9|EDGE10, EDGE2|EDGE3|EDGE11, 0, 0},                   // 152
-    {EDGE0|EDGE2|EDGE8|EDGE11, EDGE4|EDGE6|EDGE9|EDGE10, 0, 0},             // 153
-    {EDGE0|EDGE1|EDGE4|EDGE6|EDGE10, EDGE2|EDGE3|EDGE11, 0, 0},             // 154
-    {EDGE1|EDGE2|EDGE4|EDGE6|EDGE8|EDGE10|EDGE11, 0, 0, 0},                 // 155
-    {EDGE6|EDGE7|EDGE8|EDGE9|EDGE10, EDGE2|EDGE3|EDGE11, 0, 0},             // 156
-    {EDGE0|EDGE2|EDGE6|EDGE7|EDGE9|EDGE10|EDGE11, 0, 0, 0},                 // 157
-    {EDGE0|EDGE1|EDGE6|EDGE7|EDGE8|EDGE10, EDGE2|EDGE3|EDGE11, 0, 0},       // 158
-    {EDGE1|EDGE2|EDGE6|EDGE7|EDGE10|EDGE11, 0, 0, 0},                       // 159
-    {EDGE1|EDGE2|EDGE5|EDGE6, 0, 0, 0},                                     // 160
-    {EDGE0|EDGE3|EDGE8, EDGE1|EDGE2|EDGE5|EDGE6, 0, 0},                     // 161
-    {EDGE0|EDGE2|EDGE5|EDGE6|EDGE9, 0, 0, 0},                               // 162
-    {EDGE2|EDGE3|EDGE5|EDGE6|EDGE8|EDGE9, 0, 0, 0},                         // 163
-    {EDGE4|EDGE7|EDGE8, EDGE1|EDGE2|EDGE5|EDGE6, 0, 0},                     // 164
-    {EDGE0|EDGE3|EDGE4|EDGE7, EDGE1|EDGE2|EDGE5|EDGE6, 0, 0},               // 165
-    {EDGE0|EDGE2|EDGE5|EDGE6|EDGE9, EDGE4|EDGE7|EDGE8, 0, 0},               // 166
-    {EDGE2|EDGE3|EDGE4|EDGE5|EDGE6|EDGE7|EDGE9, 0, 0, 0},                   // 167
-    {EDGE1|EDGE2|EDGE4|EDGE6|EDGE9, 0, 0, 0},                               // 168
-    {EDGE0|EDGE3|EDGE8, EDGE1|EDGE2|EDGE4|EDGE6|EDGE9, 0, 0},               // 169
-    {EDGE0|EDGE2|EDGE4|EDGE6, 0, 0, 0},                                     // 170
-    {EDGE2|EDGE3|EDGE4|EDGE6|EDGE8, 0, 0, 0},                               // 171
-    {EDGE1|EDGE2|EDGE6|EDGE7|EDGE8|EDGE9, 0, 0, 0},                         // 172
-    {EDGE0|EDGE1|EDGE2|EDGE3|EDGE6|EDGE7|EDGE9, 0, 0, 0},                   // 173
-    {EDGE0|EDGE2|EDGE6|EDGE7|EDGE8, 0, 0, 0},                               // 174
-    {EDGE2|EDGE3|EDGE6|EDGE7, 0, 0, 0},                                     // 175
-    {EDGE1|EDGE3|EDGE5|EDGE6|EDGE11, 0, 0, 0},                              // 176
-    {EDGE0|EDGE1|EDGE5|EDGE6|EDGE8|EDGE11, 0, 0, 0},                        // 177
-    {EDGE0|EDGE3|EDGE5|EDGE6|EDGE9|EDGE11, 0, 0, 0},                        // 178
-    {EDGE5|EDGE6|EDGE8|EDGE9|EDGE11, 0, 0, 0},                              // 179
-    {EDGE4|EDGE7|EDGE8, EDGE1|EDGE3|EDGE5|EDGE6|EDGE11, 0, 0},              // 180
-    {EDGE0|EDGE1|EDGE4|EDGE5|EDGE6|EDGE7|EDGE11, 0, 0, 0},                  // 181
-    {EDGE0|EDGE3|EDGE5|EDGE6|EDGE9|EDGE11, EDGE4|EDGE7|EDGE8, 0, 0},        // 182
-    {EDGE4|EDGE5|EDGE6|EDGE7|EDGE9|EDGE11, 0, 0, 0},                        // 183
-    {EDGE1|EDGE3|EDGE4|EDGE6|EDGE9|EDGE11, 0, 0, 0},                        // 184
-    {EDGE0|EDGE1|EDGE4|EDGE6|EDGE8|EDGE9|EDGE11, 0, 0, 0},                  // 185
-    {EDGE0|EDGE3|EDGE4|EDGE6|EDGE11, 0, 0, 0},                              // 186
-    {EDGE4|EDGE6|EDGE8|EDGE11, 0, 0, 0},                                    // 187
-    {EDGE1|EDGE3|EDGE6|EDGE7|EDGE8|EDGE9|EDGE11, 0, 0, 0},                  // 188
-    {EDGE0|EDGE1|EDGE9, EDGE6|EDGE7|EDGE11, 0, 0},                          // 189
-    {EDGE0|EDGE3|EDGE6|EDGE7|EDGE8|EDGE11, 0, 0, 0},                        // 190
-    {EDGE6|EDGE7|EDGE11, 0, 0, 0},                                          // 191
-    {EDGE5|EDGE7|EDGE10|EDGE11, 0, 0, 0},                                   // 192
-    {EDGE0|EDGE3|EDGE8, EDGE5|EDGE7|EDGE10|EDGE11, 0, 0},                   // 193
-    {EDGE0|EDGE1|EDGE9, EDGE5|EDGE7|EDGE10|EDGE11, 0, 0},                   // 194
-    {EDGE1|EDGE3|EDGE8|EDGE9, EDGE5|EDGE7|EDGE10|EDGE11, 0, 0},             // 195
-    {EDGE4|EDGE5|EDGE8|EDGE10|EDGE11, 0, 0, 0},                             // 196
-    {EDGE0|EDGE3|EDGE4|EDGE5|EDGE10|EDGE11, 0, 0, 0},                       // 197
-    {EDGE0|EDGE1|EDGE9, EDGE4|EDGE5|EDGE8|EDGE10|EDGE11, 0, 0},             // 198
-    {EDGE1|EDGE3|EDGE4|EDGE5|EDGE9|EDGE10|EDGE11, 0, 0, 0},                 // 199
-    {EDGE4|EDGE7|EDGE9|EDGE10|EDGE11, 0, 0, 0},                             // 200
-    {EDGE0|EDGE3|EDGE8, EDGE4|EDGE7|EDGE9|EDGE10|EDGE11, 0, 0},             // 201
-    {EDGE0|EDGE1|EDGE4|EDGE7|EDGE10|EDGE11, 0, 0, 0},                       // 202
-    {EDGE1|EDGE3|EDGE4|EDGE7|EDGE8|EDGE10|EDGE11, 0, 0, 0},                 // 203
-    {EDGE8|EDGE9|EDGE10|EDGE11, 0, 0, 0},                                   // 204
-    {EDGE0|EDGE3|EDGE9|EDGE10|EDGE11, 0, 0, 0},                             // 205
-    {EDGE0|EDGE1|EDGE8|EDGE10|EDGE11, 0, 0, 0},                             // 206
-    {EDGE1|EDGE3|EDGE10|EDGE11, 0, 0, 0},                                   // 207
-    {EDGE2|EDGE3|EDGE5|EDGE7|EDGE10, 0, 0, 0},                              // 208
-    {EDGE0|EDGE2|EDGE5|EDGE7|EDGE8|EDGE10, 0, 0, 0},                        // 209
-    {EDGE0|EDGE1|EDGE9, EDGE2|EDGE3|EDGE5|EDGE7|EDGE10, 0, 0},              // 210
-    {EDGE1|EDGE2|EDGE5|EDGE7|EDGE8|EDGE9|EDGE10, 0, 0, 0},                  // 211
-    {EDGE2|EDGE3|EDGE4|EDGE5|EDGE8|EDGE10, 0, 0, 0},                        // 212
-    {EDGE0|EDGE2|EDGE4|EDGE5|EDGE10, 0, 0, 0},                              // 213
-    {EDGE0|EDGE1|EDGE9, EDGE2|EDGE3|EDGE4|EDGE5|EDGE8|EDGE10, 0, 0},        // 214
-    {EDGE1|EDGE2|EDGE4|EDGE5|EDGE9|EDGE10, 0, 0, 0},                        // 215
-    {EDGE2|EDGE3|EDGE4|EDGE7|EDGE9|EDGE10, 0, 0, 0},                        // 216
-    {EDGE0|EDGE2|EDGE4|EDGE7|EDGE8|EDGE9|EDGE10, 0, 0, 0},                  // 217
-    {EDGE0|EDGE1|EDGE2|EDGE3|EDGE4|EDGE7|EDGE10, 0, 0, 0},                  // 218
-    {EDGE4|EDGE7|EDGE8, EDGE1|EDGE2|EDGE10, 0, 0},                          // 219
-    {EDGE2|EDGE3|EDGE8|EDGE9|EDGE10, 0, 0, 0},                              // 220
-    {EDGE0|EDGE2|EDGE9|EDGE10, 0, 0, 0},                                    // 221
-    {EDGE0|EDGE1|EDGE2|EDGE3|EDGE8|EDGE10, 0, 0, 0},                        // 222
-    {EDGE1|EDGE2|EDGE10, 0, 0, 0},                                          // 223
-    {EDGE1|EDGE2|EDGE5|EDGE7|EDGE11, 0, 0, 0},                              // 224
-    {EDGE0|EDGE3|EDGE8, EDGE1|EDGE2|EDGE5|EDGE7|EDGE11, 0, 0},              // 225
-    {EDGE0|EDGE2|EDGE5|EDGE7|EDGE9|EDGE11, 0, 0, 0},                        // 226
-    {EDGE2|EDGE3|EDGE5|EDGE7|EDGE8|EDGE9|EDGE11, 0, 0, 0},                  // 227
-    {EDGE1|EDGE2|EDGE4|EDGE5|EDGE8|EDGE11, 0, 0, 0},                        // 228
-    {EDGE0|EDGE1|EDGE2|EDGE3|EDGE4|EDGE5|EDGE11, 0, 0, 0},                  // 229
-    {EDGE0|EDGE2|EDGE4|EDGE5|EDGE8|EDGE9|EDGE11, 0, 0, 0},                  // 230
-    {EDGE4|EDGE5|EDGE9, EDGE2|EDGE3|EDGE11, 0, 0},                          // 231
-    {EDGE1|EDGE2|EDGE4|EDGE7|EDGE9|EDGE11, 0, 0, 0},                        // 232
-    {EDGE0|EDGE3|EDGE8, EDGE1|EDGE2|EDGE4|EDGE7|EDGE9|EDGE11, 0, 0},        // 233
-    {EDGE0|EDGE2|EDGE4|EDGE7|EDGE11, 0, 0, 0},                              // 234
-    {EDGE2|EDGE3|EDGE4|EDGE7|EDGE8|EDGE11, 0, 0, 0},                        // 235
-    {EDGE1|EDGE2|EDGE8|EDGE9|EDGE11, 0, 0, 0},                              // 236
-    {EDGE0|EDGE1|EDGE2|EDGE3|EDGE9|EDGE11, 0, 0, 0},                        // 237
-    {EDGE0|EDGE2|EDGE8|EDGE11, 0, 0, 0},                                    // 238
-    {EDGE2|EDGE3|EDGE11, 0, 0, 0},                                          // 239
-    {EDGE1|EDGE3|EDGE5|EDGE7, 0, 0, 0},                                     // 240
-    {EDGE0|EDGE1|EDGE5|EDGE7|EDGE8, 0, 0, 0},                               // 241
-    {EDGE0|EDGE3|EDGE5|EDGE7|EDGE9, 0, 0, 0},                               // 242
-    {EDGE5|EDGE7|EDGE8|EDGE9, 0, 0, 0},                                     // 243
-    {EDGE1|EDGE3|EDGE4|EDGE5|EDGE8, 0, 0, 0},                               // 244
-    {EDGE0|EDGE1|EDGE4|EDGE5, 0, 0, 0},                                     // 245
-    {EDGE0|EDGE3|EDGE4|EDGE5|EDGE8|EDGE9, 0, 0, 0},                         // 246
-    {EDGE4|EDGE5|EDGE9, 0, 0, 0},                                           // 247
-    {EDGE1|EDGE3|EDGE4|EDGE7|EDGE9, 0, 0, 0},                               // 248
-    {EDGE0|EDGE1|EDGE4|EDGE7|EDGE8|EDGE9, 0, 0, 0},                         // 249
-    {EDGE0|EDGE3|EDGE4|EDGE7, 0, 0, 0},                                     // 250
-    {EDGE4|EDGE7|EDGE8, 0, 0, 0},                                           // 251
-    {EDGE1|EDGE3|EDGE8|EDGE9, 0, 0, 0},                                     // 252
-    {EDGE0|EDGE1|EDGE9, 0, 0, 0},                                           // 253
-    {EDGE0|EDGE3|EDGE8, 0, 0, 0},                                           // 254
-    {0, 0, 0, 0}                                                            // 255
+    int32_t codes[256][4];
 };
 
-static const uint8_t problematicConfigs[256] =
+/**
+ * @brief The EdgeDualPointsTable struct
+ * Dual point code of the face containing a given edge for each of the 256
+ * marching cubes cases, zero for edges without intersection.
+ */
+struct EdgeDualPointsTable
 {
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255,   1,   0, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255,   3, 255, 255, 2  , 255,
-    255, 255, 255, 255, 255, 255, 255,   5,
-    255, 255, 255, 255, 255, 255,   5,   5,
-    255, 255, 255, 255, 255, 255,   4, 255,
-    255, 255,   3,   3,   1,   1, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255,   5, 255,   5, 255,   5,
-    255, 255, 255, 255, 255, 255, 255,   3,
-    255, 255, 255, 255, 255,   2, 255, 255,
-    255, 255, 255, 255, 255,   3, 255,   3,
-    255,   4, 255, 255,   0, 255,   0, 255,
-    255, 255, 255, 255, 255, 255, 255,   1,
-    255, 255, 255,   0, 255, 255, 255, 255,
-    255, 255, 255,   1, 255, 255, 255,   1,
-    255,   4,   2, 255, 255, 255,   2, 255,
-    255, 255, 255,   0, 255,   2,   4, 255,
-    255, 255, 255,   0, 255,   2, 255, 255,
-    255, 255, 255, 255, 255, 255,   4, 255,
-    255,   4, 255, 255, 255, 255, 255, 255
+    int32_t codes[256][12];
 };
 
+/**
+ * @brief The ProblematicConfigsTable struct
+ * Direction of the ambiguous face of the C16 and C19 configurations, which
+ * may produce non-manifold meshes. Other configurations have a direction
+ * value of 255. Directions are encoded as -x, +x, -y, +y, -z, +z.
+ */
+struct ProblematicConfigsTable
+{
+    uint8_t directions[256];
+};
+
+/**
+ * @brief edgeIndex
+ * @param edge
+ * @return Index of the edge in [0, 12).
+ */
+constexpr int edgeIndex( const DMC_EDGE_CODE edge )
+{
+    // Count the bits below the single edge bit
+    uint32_t bits = uint32_t( edge ) - 1u;
+    bits = bits - (( bits >> 1 ) & 0x55555555u );
+    bits = ( bits & 0x33333333u ) + (( bits >> 2 ) & 0x33333333u );
+    return int(((( bits + ( bits >> 4 )) & 0x0f0f0f0fu ) * 0x01010101u ) >> 24 );
 }
 
-#endif // TABLES_H
+/**
+ * @brief generateDualPointsTable
+ * For each cube configuration each inside corner is used as the starting
+ * corner for finding connected inside corners, that can be reached by
+ * traversing the cube edges. For each corner in such a connected subgraph
+ * all edges connecting to an outside corner are collected.
+ * For the configurations 126, 189, 219, and 231 this approach merges two
+ * original marching cubes patches into one patch. The patches of their
+ * inverted configurations are correct, so those are used instead.
+ * @return
+ */
+constexpr DualPointsTable generateDualPointsTable()
+{
+    // Edges adjacent to each corner in x, y, and z direction
+    constexpr int32_t cornerEdges[8][3] =
+    {
+        { EDGE0, EDGE8, EDGE3 },
+        { EDGE0, EDGE9, EDGE1 },
+        { EDGE4, EDGE8, EDGE7 },
+        { EDGE4, EDGE9, EDGE5 },
+        { EDGE2, EDGE11, EDGE3 },
+        { EDGE2, EDGE10, EDGE1 },
+        { EDGE6, EDGE11, EDGE7 },
+        { EDGE6, EDGE10, EDGE5 }
+    };
+
+    DualPointsTable table = {};
+    for( uint32_t i = 1; i < 255; ++i )
+    {
+        uint32_t cubeMask = i;
+        if( i == 126 || i == 189 || i == 219 || i == 231 )
+        {
+            cubeMask ^= 0xffu;
+        }
+
+        uint32_t processedCornersMask = 0;
+        int numDualPoints = 0;
+        for( uint32_t c = 0; c < 8; ++c )
+        {
+            // Skip visited and outside corners
+            if(( processedCornersMask & ( 1u << c )) != 0 || ( cubeMask & ( 1u << c )) == 0 )
+            {
+                processedCornersMask |= 1u << c;
+                continue;
+            }
+
+            // Expand the connected inside corners and collect the edges to
+            // outside corners
+            uint32_t cornerStack[8] = {};
+            int stackSize = 0;
+            cornerStack[stackSize++] = c;
+            uint32_t connectedCornersMask = 1u << c;
+            int32_t dualPointCode = 0;
+            while( stackSize > 0 )
+            {
+                uint32_t const corner = cornerStack[--stackSize];
+                for( uint32_t n = 0; n < 3; ++n )
+                {
+                    // Neighbors in x, y, and z direction by Morton code
+                    uint32_t const neighbor = corner ^ ( 1u << n );
+                    if(( cubeMask & ( 1u << neighbor )) == 0 )
+                    {
+                        dualPointCode |= cornerEdges[corner][n];
+                    }
+                    else if(( connectedCornersMask & ( 1u << neighbor )) == 0 )
+                    {
+                        connectedCornersMask |= 1u << neighbor;
+                        cornerStack[stackSize++] = neighbor;
+                    }
+                }
+            }
+            processedCornersMask |= connectedCornersMask;
+            table.codes[i][numDualPoints++] = dualPointCode;
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief generateEdgeDualPointsTable
+ * Derive the per-edge dual point codes from the dual points table.
+ * @param dualPoints
+ * @return
+ */
+constexpr EdgeDualPointsTable generateEdgeDualPointsTable( const DualPointsTable & dualPoints )
+{
+    EdgeDualPointsTable table = {};
+    for( int cube = 0; cube < 256; ++cube )
+    {
+        for( int i = 0; i < 4; ++i )
+        {
+            int32_t const code = dualPoints.codes[cube][i];
+            for( int edge = 0; edge < 12; ++edge )
+            {
+                if( code & ( 1 << edge ))
+                {
+                    table.codes[cube][edge] = code;
+                }
+            }
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief rotateConfig
+ * Rotate a cube configuration by 90 degrees around a coordinate axis.
+ * @param config
+ * @param axis
+ * @return
+ */
+constexpr uint8_t rotateConfig( const uint8_t config, const int axis )
+{
+    // Move the corner bits to their rotated positions
+    return axis == 0 ? uint8_t((( config & 0x03 ) << 2 ) | (( config & 0x0c ) << 4 ) |
+                               (( config & 0x30 ) >> 4 ) | (( config & 0xc0 ) >> 2 )) :
+           axis == 1 ? uint8_t((( config & 0x05 ) << 4 ) | (( config & 0x0a ) >> 1 ) |
+                               (( config & 0x50 ) << 1 ) | (( config & 0xa0 ) >> 4 )) :
+                       uint8_t((( config & 0x11 ) << 1 ) | (( config & 0x22 ) << 2 ) |
+                               (( config & 0x44 ) >> 2 ) | (( config & 0x88 ) >> 1 ));
+}
 
+/**
+ * @brief rotateDirection
+ * Rotate an ambiguous face direction by 90 degrees around a coordinate axis.
+ * @param direction
+ * @param axis
+ * @return
+ */
+constexpr uint8_t rotateDirection( const uint8_t direction, const int axis )
+{
+    constexpr uint8_t rotations[3][6] =
+    {
+        { 0, 1, 4, 5, 3, 2 },
+        { 5, 4, 2, 3, 0, 1 },
+        { 2, 3, 1, 0, 4, 5 }
+    };
+    return rotations[axis][direction];
+}
+
+/**
+ * @brief generateProblematicConfigsTable
+ * Explore all rotations of the C16 and C19 representatives from the
+ * original Nielson paper, which have their ambiguous face in +x direction.
+ * The ambiguous face is brought into all six directions, where the
+ * configuration is rotated around the direction axis each time.
+ * @return
+ */
+constexpr ProblematicConfigsTable generateProblematicConfigsTable()
+{
+    ProblematicConfigsTable table = {};
+    for( int i = 0; i < 256; ++i )
+    {
+        table.directions[i] = 255;
+    }
+
+    // C16 and C19 representatives
+    constexpr uint8_t representatives[2] =
+    {
+        1 | 2 | 4 | 64 | 128,
+        1 | 2 | 4 | 16 | 64 | 128
+    };
+
+    // Axis for bringing the ambiguous face into the next direction and axis
+    // of the rotations around the new direction, ordered +x, +y, -x, -y,
+    // -z, +z
+    constexpr int steps[6][3] =
+    {
+        { -1, 0, 0 },
+        { 2, 1, 1 },
+        { 2, 1, 0 },
+        { 2, 1, 1 },
+        { 0, 1, 2 },
+        { 0, 2, 2 }
+    };
+
+    for( int r = 0; r < 2; ++r )
+    {
+        uint8_t config = representatives[r];
+        uint8_t direction = 1;
+        for( int s = 0; s < 6; ++s )
+        {
+            int const stepAxis = steps[s][0];
+            for( int k = 0; stepAxis >= 0 && k < steps[s][1]; ++k )
+            {
+                config = rotateConfig( config, stepAxis );
+                direction = rotateDirection( direction, stepAxis );
+            }
+
+            // Rotations around the ambiguous face direction keep it
+            uint8_t rotated = config;
+            for( int k = 0; k < 4; ++k )
+            {
+                rotated = rotateConfig( rotated, steps[s][2] );
+                table.directions[rotated] = direction;
+            }
+        }
+    }
+    return table;
+}
+
+/// Dual point codes of the 256 marching cubes cases
+static constexpr DualPointsTable dualPointsTable = generateDualPointsTable();
+
+/// Dual point code for each cube case and edge
+static constexpr EdgeDualPointsTable edgeDualPointsTable =
+        generateEdgeDualPointsTable( dualPointsTable );
+
+/// Ambiguous face directions of the manifold dual marching cubes approach
+static constexpr ProblematicConfigsTable problematicConfigsTable =
+        generateProblematicConfigsTable();
+
+static constexpr const int32_t ( &dualPointsList )[256][4] = dualPointsTable.codes;
+static constexpr const int32_t ( &edgeDualPoints )[256][12] = edgeDualPointsTable.codes;
+static constexpr const uint8_t ( &problematicConfigs )[256] = problematicConfigsTable.directions;
+
+}
+
+#endif // TABLES_H
@@ -0,0 +1,232 @@
+#include "timeseriesdualmc.h"
+
+// C includes
+#include <cstring>
+
+// STL includes
+#include <algorithm>
+
+#include "cpudispatch.h"
+
+namespace dualmc
+{
+
+namespace
+{
+
+/// Mix eight bytes into a hash as in the body of MurmurHash3
+inline uint64_t mixWord( uint64_t hash, uint64_t word )
+{
+    word *= 0x87c37b91114253d5ull;
+    word = ( word << 31 ) | ( word >> 33 );
+    word *= 0x4cf5ad432745937full;
+    hash ^= word;
+    hash = ( hash << 27 ) | ( hash >> 37 );
+    return hash * 5 + 0x52dce729;
+}
+
+}
+
+/**
+ * @brief TimeSeriesDualMC::TimeSeriesDualMC
+ * @param brickSize
+ * @param numThreads
+ */
+TimeSeriesDualMC::TimeSeriesDualMC( const int32_t brickSize, const unsigned int numThreads )
+    : _brickSize( std::max( brickSize, 1 )),
+      _pool( numThreads ),
+      _isoValue( 0 ),
+      _generateManifold( false ),
+      _workers( _pool.numThreads())
+{
+    for( auto & worker : _workers )
+    {
+        _idleWorkers.push_back( &worker );
+    }
+}
+
+/**
+ * @brief TimeSeriesDualMC::extractFrame
+ * @param volumeGrid
+ * @param x
+ * @param y
+ * @param z
+ * @param isoValue
+ * @param generateManifold
+ * @param vertices
+ * @param quads
+ */
+void TimeSeriesDualMC::extractFrame( const uint8_t * volumeGrid,
+                                     const int32_t x, const int32_t y, const int32_t z,
+                                     const uint8_t isoValue,
+                                     const bool generateManifold,
+                                     std::vector< Vertex > & vertices,
+                                     std::vector< Quad > & quads )
+{
+    // Start a new series for new volume dimensions
+    if( x != _partition.dimension( 0 ) || y != _partition.dimension( 1 ) ||
+            z != _partition.dimension( 2 ) || _bricks.empty())
+    {
+        int32_t numBricks[3];
+        int32_t const dimensions[] = { x, y, z };
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            numBricks[ axis ] = std::max(( dimensions[ axis ] - 2 + _brickSize - 1 ) / _brickSize, 1 );
+        }
+        _partition = BrickPartition( x, y, z, numBricks[0], numBricks[1], numBricks[2] );
+        _bricks.resize( size_t( _partition.numBricks()));
+        _brickMeshes.resize( _bricks.size());
+        reset();
+    }
+
+    bool const settingsChanged = isoValue != _isoValue || generateManifold != _generateManifold;
+    _isoValue = isoValue;
+    _generateManifold = generateManifold;
+
+    _pool.parallelFor( 0, _partition.numBricks(), [ & ]( const int32_t brick )
+    {
+        _processBrick( brick, volumeGrid, settingsChanged );
+    });
+
+    stitchBrickMeshes( _brickMeshes, vertices, quads );
+}
+
+/**
+ * @brief TimeSeriesDualMC::reset
+ */
+void TimeSeriesDualMC::reset()
+{
+    for( auto & brick : _bricks )
+    {
+        brick.hash = 0;
+        brick.valid = false;
+        brick.state = BRICK_EMPTY;
+    }
+}
+
+/**
+ * @brief TimeSeriesDualMC::meshedBricks
+ * @return
+ */
+int32_t TimeSeriesDualMC::meshedBricks() const
+{
+    return _countBricks( BRICK_MESHED );
+}
+
+/**
+ * @brief TimeSeriesDualMC::reusedBricks
+ * @return
+ */
+int32_t TimeSeriesDualMC::reusedBricks() const
+{
+    return _countBricks( BRICK_REUSED );
+}
+
+/**
+ * @brief TimeSeriesDualMC::emptyBricks
+ * @return
+ */
+int32_t TimeSeriesDualMC::emptyBricks() const
+{
+    return _countBricks( BRICK_EMPTY );
+}
+
+/**
+ * @brief TimeSeriesDualMC::_processBrick
+ * @param brick
+ * @param volumeGrid
+ * @param settingsChanged
+ */
+void TimeSeriesDualMC::_processBrick( const int32_t brick, const uint8_t * volumeGrid,
+                                      const bool settingsChanged )
+{
+    int32_t offset[3], extent[3];
+    _partition.dataRange( brick, offset, extent );
+
+    // Summarize the voxels of the brick including its ghost layer row by row
+    size_t const rowPitch = size_t( _partition.dimension( 0 ));
+    size_t const slicePitch = rowPitch * size_t( _partition.dimension( 1 ));
+    size_t const rowLength = size_t( std::max( extent[0], 0 ));
+    uint64_t hash = 0;
+    uint8_t minimum = 255;
+    uint8_t maximum = 0;
+    for( int32_t z = 0; z < extent[2]; ++z )
+    {
+        for( int32_t y = 0; y < extent[1]; ++y )
+        {
+            const uint8_t * const row = volumeGrid + size_t( offset[0] ) +
+                    rowPitch * size_t( offset[1] + y ) + slicePitch * size_t( offset[2] + z );
+            extendRowRange( row, rowLength, minimum, maximum );
+
+            size_t i = 0;
+            for( ; i + 8 <= rowLength; i += 8 )
+            {
+                uint64_t word;
+                std::memcpy( &word, row + i, 8 );
+                hash = mixWord( hash, word );
+            }
+            uint64_t tail = 0;
+            std::memcpy( &tail, row + i, rowLength - i );
+            hash = mixWord( hash, tail );
+        }
+    }
+
+    Brick & summary = _bricks[ brick ];
+    BrickMesh & mesh = _brickMeshes[ brick ];
+    if( maximum < _isoValue || minimum >= _isoValue )
+    {
+        // No edge crosses the iso surface
+        mesh.clear();
+        summary.state = BRICK_EMPTY;
+    }
+    else if( summary.valid && !settingsChanged && summary.hash == hash )
+    {
+        summary.state = BRICK_REUSED;
+    }
+    else
+    {
+        Worker & worker = _acquireWorker();
+        _partition.copyBrickData( volumeGrid, brick, worker.brickData );
+        worker.builder.build( worker.brickData.data(), _partition, brick,
+                              _isoValue, _generateManifold, mesh );
+        _releaseWorker( worker );
+        summary.state = BRICK_MESHED;
+    }
+    summary.hash = hash;
+    summary.valid = true;
+}
+
+/**
+ * @brief TimeSeriesDualMC::_acquireWorker
+ * @return
+ */
+TimeSeriesDualMC::Worker & TimeSeriesDualMC::_acquireWorker()
+{
+    std::lock_guard< std::mutex > lock( _workerMutex );
+    Worker * const worker = _idleWorkers.back();
+    _idleWorkers.pop_back();
+    return *worker;
+}
+
+/**
+ * @brief TimeSeriesDualMC::_releaseWorker
+ * @param worker
+ */
+void TimeSeriesDualMC::_releaseWorker( Worker & worker )
+{
+    std::lock_guard< std::mutex > lock( _workerMutex );
+    _idleWorkers.push_back( &worker );
+}
+
+/**
+ * @brief TimeSeriesDualMC::_countBricks
+ * @param state
+ * @return
+ */
+int32_t TimeSeriesDualMC::_countBricks( const BRICK_STATE state ) const
+{
+    return int32_t( std::count_if( _bricks.begin(), _bricks.end(),
+                                   [ state ]( const Brick & brick ) { return brick.state == state; } ));
+}
+
+}
@@ -0,0 +1,176 @@
+#ifndef TIMESERIESDUALMC_H
+#define TIMESERIESDUALMC_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <mutex>
+#include <vector>
+
+#include "brickmesh.h"
+#include "brickpartition.h"
+#include "dualmc.h"
+#include "parallel.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief The TimeSeriesDualMC class
+ * Dual marching cubes builder for a series of volumes of the same size, for
+ * example the timesteps of a simulation. The volume is partitioned into
+ * bricks, which are meshed in parallel on a persistent thread pool. The
+ * builders, brick buffers and brick meshes are kept from frame to frame.
+ * For each brick the minimum, maximum and a 64-bit hash of its voxels
+ * including the ghost layer are computed. Bricks without voxels on both
+ * sides of the iso value are empty, and bricks whose hash did not change
+ * since the previous frame keep their mesh. Only the remaining bricks are
+ * meshed again. The brick meshes are stitched into the same mesh as the
+ * full build, up to the order of vertices and quads.
+ */
+class TimeSeriesDualMC
+{
+public:
+
+    /**
+     * @brief TimeSeriesDualMC
+     * @param brickSize
+     * Edge length of the bricks in cells.
+     * @param numThreads
+     * Number of threads, zero uses all hardware threads.
+     */
+    explicit TimeSeriesDualMC( const int32_t brickSize = 32, const unsigned int numThreads = 0 );
+
+    /**
+     * @brief extractFrame
+     * Extract the iso surface of the next frame. Changing the volume
+     * dimensions starts a new series.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param isoValue
+     * @param generateManifold
+     * @param vertices
+     * @param quads
+     */
+    void extractFrame( const uint8_t * volumeGrid,
+                       const int32_t x, const int32_t y, const int32_t z,
+                       const uint8_t isoValue,
+                       const bool generateManifold,
+                       std::vector< Vertex > & vertices,
+                       std::vector< Quad > & quads );
+
+    /**
+     * @brief reset
+     * Forget the previous frame, so all bricks are meshed again.
+     */
+    void reset();
+
+    /// Number of bricks meshed in the last frame
+    int32_t meshedBricks() const;
+
+    /// Number of bricks, whose mesh was reused in the last frame
+    int32_t reusedBricks() const;
+
+    /// Number of bricks skipped as empty in the last frame
+    int32_t emptyBricks() const;
+
+private:
+
+    /// State of a brick in the last frame
+    enum BRICK_STATE
+    {
+        BRICK_MESHED,
+        BRICK_REUSED,
+        BRICK_EMPTY
+    };
+
+    /// Summary of the voxels of a brick
+    struct Brick
+    {
+        uint64_t hash;
+        bool valid;
+        BRICK_STATE state;
+    };
+
+    /// Builder and voxel buffer used by one thread at a time
+    struct Worker
+    {
+        DualMC builder;
+        std::vector< uint8_t > brickData;
+    };
+
+    /**
+     * @brief _processBrick
+     * Summarize the voxels of a brick and mesh it if necessary.
+     * @param brick
+     * @param volumeGrid
+     * @param settingsChanged
+     * Whether the iso value or manifold setting differs from the last frame.
+     */
+    void _processBrick( const int32_t brick, const uint8_t * volumeGrid,
+                        const bool settingsChanged );
+
+    /**
+     * @brief _acquireWorker, _releaseWorker
+     * Take an idle worker and give it back.
+     */
+    Worker & _acquireWorker();
+    void _releaseWorker( Worker & worker );
+
+    /**
+     * @brief _countBricks
+     * @param state
+     * @return Number of bricks in the given state.
+     */
+    int32_t _countBricks( const BRICK_STATE state ) const;
+
+private:
+
+    /**
+     * @brief _brickSize
+     * Edge length of the bricks in cells.
+     */
+    int32_t _brickSize;
+
+    /**
+     * @brief _pool
+     * Threads processing the bricks.
+     */
+    ThreadPool _pool;
+
+    /**
+     * @brief _partition
+     * Bricks of the current series.
+     */
+    BrickPartition _partition;
+
+    /**
+     * @brief _isoValue, _generateManifold
+     * Settings of the last frame.
+     */
+    uint8_t _isoValue;
+    bool _generateManifold;
+
+    /**
+     * @brief _bricks, _brickMeshes
+     * Summary and mesh of each brick.
+     */
+    std::vector< Brick > _bricks;
+    std::vector< BrickMesh > _brickMeshes;
+
+    /**
+     * @brief _workers, _idleWorkers
+     * One worker per thread and the workers not in use.
+     */
+    std::vector< Worker > _workers;
+    std::vector< Worker * > _idleWorkers;
+    std::mutex _workerMutex;
+};
+
+}
+
+#endif // TIMESERIESDUALMC_H
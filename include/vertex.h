@@ -25,14 +25,11 @@ struct Vertex
         /// EMPTY
     }
 
-    /// Initializing constructor
-    Vertex( Vertex const & v )
-        : x( v.x ),
-          y( v.y ),
-          z( v.z )
-    {
-        /// EMPTY
-    }
+    /// Copy constructor
+    Vertex( Vertex const & v ) = default;
+
+    /// Copy assignment
+    Vertex & operator=( Vertex const & v ) = default;
 
     // Components
     float x,y,z;
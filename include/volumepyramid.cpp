@@ -0,0 +1,177 @@
+#include "volumepyramid.h"
+
+// STL includes
+#include <algorithm>
+
+#include "parallel.h"
+
+namespace dualmc
+{
+
+/**
+ * @brief VolumePyramid::VolumePyramid
+ */
+VolumePyramid::VolumePyramid()
+{
+    /// EMPTY
+}
+
+/**
+ * @brief VolumePyramid::build
+ * @param volumeGrid
+ * @param x
+ * @param y
+ * @param z
+ * @param numLevels
+ * @param numThreads
+ */
+void VolumePyramid::build( const uint8_t * volumeGrid,
+                           const int32_t x, const int32_t y, const int32_t z,
+                           const int numLevels,
+                           const unsigned int numThreads )
+{
+    int const levels = std::max( numLevels, 1 );
+    _data.assign( size_t( levels ), nullptr );
+    _levels.assign( size_t( levels ), std::vector< uint8_t >());
+    _dimensions.assign( size_t( levels ), std::vector< int32_t >( 3, 0 ));
+
+    _data[0] = volumeGrid;
+    _dimensions[0][0] = x;
+    _dimensions[0][1] = y;
+    _dimensions[0][2] = z;
+
+    for( int level = 1; level < levels; ++level )
+    {
+        // The last voxel of a level covers the last voxel of the finer level
+        // if possible
+        size_t size = 1;
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            int32_t const finer = _dimensions[ level - 1 ][ axis ];
+            _dimensions[ level ][ axis ] = finer > 0 ? ( finer - 1 ) / 2 + 1 : 0;
+            size *= size_t( _dimensions[ level ][ axis ]);
+        }
+        _levels[ level ].resize( size );
+        _data[ level ] = _levels[ level ].data();
+        _downsample( level, numThreads );
+    }
+}
+
+/**
+ * @brief VolumePyramid::numLevels
+ * @return
+ */
+int VolumePyramid::numLevels() const
+{
+    return int( _data.size());
+}
+
+/**
+ * @brief VolumePyramid::dimension
+ * @param level
+ * @param axis
+ * @return
+ */
+int32_t VolumePyramid::dimension( const int level, const int axis ) const
+{
+    return _dimensions[ level ][ axis ];
+}
+
+/**
+ * @brief VolumePyramid::data
+ * @param level
+ * @return
+ */
+const uint8_t * VolumePyramid::data( const int level ) const
+{
+    return _data[ level ];
+}
+
+/**
+ * @brief VolumePyramid::memorySize
+ * @return
+ */
+size_t VolumePyramid::memorySize() const
+{
+    size_t size = 0;
+    for( auto const & level : _levels )
+    {
+        size += level.size();
+    }
+    return size;
+}
+
+/**
+ * @brief VolumePyramid::downsample
+ * @param level
+ * @param numThreads
+ */
+void VolumePyramid::_downsample( const int level, const unsigned int numThreads )
+{
+    const uint8_t * const finer = _data[ level - 1 ];
+    int32_t const fineX = _dimensions[ level - 1 ][0];
+    int32_t const fineY = _dimensions[ level - 1 ][1];
+    int32_t const fineZ = _dimensions[ level - 1 ][2];
+    int32_t const coarseX = _dimensions[ level ][0];
+    int32_t const coarseY = _dimensions[ level ][1];
+    size_t const fineSlice = size_t( fineX ) * size_t( fineY );
+    uint8_t * const coarser = _levels[ level ].data();
+
+    // Taps of the tent kernel around fine voxel 2 * c
+    auto taps = []( const int32_t c, const int32_t dimension, int32_t index[3] )
+    {
+        index[0] = std::max( 2 * c - 1, 0 );
+        index[1] = 2 * c;
+        index[2] = std::min( 2 * c + 1, dimension - 1 );
+    };
+    static const uint32_t weights[] = { 1, 2, 1 };
+
+    parallelFor( 0, _dimensions[ level ][2], [ & ]( const int32_t cz )
+    {
+        // Filter along z, then y, then x. Sums stay below 2^16.
+        std::vector< uint16_t > filteredZ( fineSlice );
+        std::vector< uint16_t > filteredY( size_t( fineX ) * size_t( coarseY ));
+
+        int32_t tz[3];
+        taps( cz, fineZ, tz );
+        for( size_t i = 0; i < fineSlice; ++i )
+        {
+            uint32_t sum = 0;
+            for( int t = 0; t < 3; ++t )
+            {
+                sum += weights[t] * finer[ i + fineSlice * size_t( tz[t] )];
+            }
+            filteredZ[i] = uint16_t( sum );
+        }
+
+        for( int32_t cy = 0; cy < coarseY; ++cy )
+        {
+            int32_t ty[3];
+            taps( cy, fineY, ty );
+            for( int32_t x = 0; x < fineX; ++x )
+            {
+                uint32_t sum = 0;
+                for( int t = 0; t < 3; ++t )
+                {
+                    sum += weights[t] * filteredZ[ size_t( x ) + size_t( fineX ) * size_t( ty[t] )];
+                }
+                filteredY[ size_t( x ) + size_t( fineX ) * size_t( cy )] = uint16_t( sum );
+            }
+        }
+
+        uint8_t * const slice = coarser + size_t( coarseX ) * size_t( coarseY ) * size_t( cz );
+        for( int32_t cy = 0; cy < coarseY; ++cy )
+        {
+            const uint16_t * const row = &filteredY[ size_t( fineX ) * size_t( cy )];
+            for( int32_t cx = 0; cx < coarseX; ++cx )
+            {
+                int32_t tx[3];
+                taps( cx, fineX, tx );
+                uint32_t const sum = row[ tx[0] ] + 2 * row[ tx[1] ] + row[ tx[2] ];
+                slice[ cx + size_t( coarseX ) * size_t( cy )] = uint8_t(( sum + 32 ) / 64 );
+            }
+        }
+    }, numThreads );
+}
+
+}
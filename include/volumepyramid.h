@@ -0,0 +1,86 @@
+#ifndef VOLUMEPYRAMID_H
+#define VOLUMEPYRAMID_H
+
+// C includes
+#include <cstddef>
+#include <cstdint>
+
+// STL includes
+#include <vector>
+
+namespace dualmc
+{
+
+/**
+ * @brief The VolumePyramid class
+ * Resolution pyramid of a volume for level of detail extraction. Voxel
+ * ( x, y, z ) of level l lies at voxel ( x, y, z ) * 2^l of the finest level.
+ * Each coarser level is low-pass filtered with a separable [1 2 1] / 4 tent
+ * kernel centered at its voxels, so the samples stay aligned with the finest
+ * grid. Borders are clamped.
+ * The finest level references the input volume, which has to stay valid.
+ */
+class VolumePyramid
+{
+public:
+
+    /// Empty pyramid
+    VolumePyramid();
+
+    /**
+     * @brief build
+     * Build the coarser levels of the pyramid for a linear x-fastest volume.
+     * @param volumeGrid
+     * @param x
+     * @param y
+     * @param z
+     * @param numLevels
+     * Number of levels including the finest one.
+     * @param numThreads
+     * Number of threads filtering the slices, zero uses all hardware threads.
+     */
+    void build( const uint8_t * volumeGrid,
+                const int32_t x, const int32_t y, const int32_t z,
+                const int numLevels,
+                const unsigned int numThreads = 0 );
+
+    /// Number of levels including the finest one
+    int numLevels() const;
+
+    /// Number of voxels of a level along an axis
+    int32_t dimension( const int level, const int axis ) const;
+
+    /// Linear x-fastest voxel data of a level
+    const uint8_t * data( const int level ) const;
+
+    /// The voxel value at ( x, y, z ) of a level
+    uint8_t operator()( const int level,
+                        const int32_t x, const int32_t y, const int32_t z ) const
+    {
+        return _data[ level ][ size_t( x ) + size_t( _dimensions[ level ][0] ) *
+                ( size_t( y ) + size_t( _dimensions[ level ][1] ) * size_t( z ))];
+    }
+
+    /// Size of the coarser levels in bytes
+    size_t memorySize() const;
+
+private:
+
+    /**
+     * @brief _downsample
+     * Filter level - 1 into level.
+     * @param level
+     * @param numThreads
+     */
+    void _downsample( const int level, const unsigned int numThreads );
+
+    // Voxel data and dimensions of all levels, the storage of the finest level
+    // is unused
+    std::vector< const uint8_t * > _data;
+    std::vector< std::vector< uint8_t > > _levels;
+    std::vector< std::vector< int32_t > > _dimensions;
+};
+
+}
+
+#endif // VOLUMEPYRAMID_H